@@ -3,14 +3,18 @@
 //
 // This is the default event action of the NEXT simulations. Only events with
 // deposited energy larger than 0 are saved in the nexus output file.
+// It also monitors the throughput and memory usage of the run, printing
+// a periodic progress line and a summary saved in the output file.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
 
 #include "DefaultEventAction.h"
+#include "DefaultTrackingAction.h"
 #include "Trajectory.h"
 #include "PersistencyManager.h"
 #include "IonizationHit.h"
+#include "SensorHit.h"
 #include "FactoryBase.h"
 
 #include <G4Event.hh>
@@ -20,15 +24,37 @@
 #include <G4HCofThisEvent.hh>
 #include <G4SDManager.hh>
 #include <G4HCtable.hh>
+#include <G4RunManager.hh>
+#include <G4Run.hh>
+#include <G4SystemOfUnits.hh>
 #include <globals.hh>
 
+#include <sys/resource.h>
+#include <algorithm>
+#include <iomanip>
+
+
+namespace {
+
+  /// Maximum number of values kept for the percentiles
+  const size_t max_sample = 10000;
+
+
+  G4double Seconds(std::chrono::steady_clock::duration d)
+  {
+    return std::chrono::duration<G4double>(d).count();
+  }
+
+}
+
 
 namespace nexus {
 
 REGISTER_CLASS(DefaultEventAction, G4UserEventAction)
 
   DefaultEventAction::DefaultEventAction():
-    G4UserEventAction(), nevt_(0), nupdate_(10), energy_min_(0.), energy_max_(DBL_MAX)
+    G4UserEventAction(), nevt_(0), nupdate_(10), energy_min_(0.), energy_max_(DBL_MAX),
+    progress_interval_(60.*second), evt_cpu_start_(0)
   {
     msg_ = new G4GenericMessenger(this, "/Actions/DefaultEventAction/");
 
@@ -46,6 +72,13 @@ REGISTER_CLASS(DefaultEventAction, G4UserEventAction)
     max_energy_cmd.SetUnitCategory("Energy");
     max_energy_cmd.SetRange("max_energy>0.");
 
+    G4GenericMessenger::Command& progress_cmd =
+      msg_->DeclareProperty("progress_interval", progress_interval_,
+                            "Maximum wall time between two progress printouts.");
+    progress_cmd.SetParameterName("progress_interval", true);
+    progress_cmd.SetUnitCategory("Time");
+    progress_cmd.SetRange("progress_interval>0.");
+
     PersistencyManager* pm = dynamic_cast<PersistencyManager*>
       (G4VPersistencyManager::GetPersistencyManager());
 
@@ -60,13 +93,114 @@ REGISTER_CLASS(DefaultEventAction, G4UserEventAction)
 
 
 
-  void DefaultEventAction::BeginOfEventAction(const G4Event* /*event*/)
+  DefaultEventAction::EventStatistic::EventStatistic()
+  {
+    Clear();
+  }
+
+
+
+  void DefaultEventAction::EventStatistic::Clear()
+  {
+    n = 0;
+    sum = 0.;
+    max = 0.;
+    stride = 1;
+    sample.clear();
+  }
+
+
+
+  void DefaultEventAction::EventStatistic::Add(G4double value)
+  {
+    if (n == 0 || value > max) max = value;
+    sum += value;
+
+    if (n % stride == 0) {
+      sample.push_back(value);
+      if (sample.size() >= max_sample) {
+        for (size_t i=0; 2*i<sample.size(); ++i) sample[i] = sample[2*i];
+        sample.resize((sample.size() + 1) / 2);
+        stride *= 2;
+      }
+    }
+    n++;
+  }
+
+
+
+  G4double DefaultEventAction::EventStatistic::Mean() const
   {
+    return (n > 0) ? sum / n : 0.;
+  }
+
+
+
+  G4double DefaultEventAction::EventStatistic::Percentile(G4double fraction) const
+  {
+    if (sample.empty()) return 0.;
+    if (fraction >= 1.) return max;
+    std::vector<float> v = sample;
+    size_t i = std::min(v.size() - 1, (size_t) (fraction * v.size()));
+    std::nth_element(v.begin(), v.begin() + i, v.end());
+    return v[i];
+  }
+
+
+
+  void DefaultEventAction::BeginOfEventAction(const G4Event* event)
+  {
+    evt_start_ = std::chrono::steady_clock::now();
+    evt_cpu_start_ = std::clock();
+
+    // The statistics are collected run by run
+    if (event->GetEventID() == 0) {
+      run_start_  = evt_start_;
+      last_print_ = evt_start_;
+      wall_times_.Clear();
+      cpu_times_.Clear();
+      ntracks_.Clear();
+      nphotons_.Clear();
+      ndetected_.Clear();
+    }
+
     // Print out event number info
     if ((nevt_ % nupdate_) == 0) {
-      G4cout << " >> Event no. " << nevt_  << G4endl;
+      PrintProgress(event->GetEventID());
       if (nevt_  == (10 * nupdate_)) nupdate_ *= 10;
     }
+    else if (Seconds(evt_start_ - last_print_) * second > progress_interval_) {
+      PrintProgress(event->GetEventID());
+    }
+
+    DefaultTrackingAction* tracking = const_cast<DefaultTrackingAction*>
+      (dynamic_cast<const DefaultTrackingAction*>
+       (G4RunManager::GetRunManager()->GetUserTrackingAction()));
+    if (tracking) tracking->ResetCounters();
+  }
+
+
+
+  void DefaultEventAction::PrintProgress(G4int event_id)
+  {
+    G4cout << " >> Event no. " << nevt_;
+
+    last_print_ = std::chrono::steady_clock::now();
+    G4double elapsed = Seconds(last_print_ - run_start_);
+
+    if (event_id > 0 && elapsed > 0.) {
+      G4double rate = event_id / elapsed;
+      G4cout << std::setprecision(3) << " (" << rate << " evt/s";
+
+      const G4Run* run = G4RunManager::GetRunManager()->GetCurrentRun();
+      if (run) {
+        G4int left = run->GetNumberOfEventToBeProcessed() - event_id;
+        G4cout << ", ETA " << (G4long) (left / rate) << " s";
+      }
+      G4cout << ")" << std::setprecision(6);
+    }
+
+    G4cout << G4endl;
   }
 
 
@@ -75,6 +209,18 @@ REGISTER_CLASS(DefaultEventAction, G4UserEventAction)
   {
     nevt_++;
 
+    wall_times_.Add(Seconds(std::chrono::steady_clock::now() - evt_start_));
+    cpu_times_.Add(G4double(std::clock() - evt_cpu_start_) / CLOCKS_PER_SEC);
+
+    const DefaultTrackingAction* tracking =
+      dynamic_cast<const DefaultTrackingAction*>
+      (G4RunManager::GetRunManager()->GetUserTrackingAction());
+    if (tracking) {
+      ntracks_.Add(tracking->GetNumberOfTracks());
+      nphotons_.Add(tracking->GetNumberOfOpticalPhotons());
+    }
+    ndetected_.Add(CountDetectedPhotons(event));
+
     // Determine whether total energy deposit in ionization sensitive
     // detectors is above threshold
     if (energy_min_ >= 0.) {
@@ -121,4 +267,81 @@ REGISTER_CLASS(DefaultEventAction, G4UserEventAction)
   }
 
 
+
+  G4long DefaultEventAction::CountDetectedPhotons(const G4Event* event) const
+  {
+    G4HCofThisEvent* hce = event->GetHCofThisEvent();
+    if (!hce) return 0;
+
+    G4long detected = 0;
+
+    for (G4int i=0; i<hce->GetNumberOfCollections(); ++i) {
+      SensorHitsCollection* hits =
+        dynamic_cast<SensorHitsCollection*>(hce->GetHC(i));
+      if (!hits) continue;
+
+      for (size_t j=0; j<hits->entries(); ++j) {
+        const SensorHit* hit = dynamic_cast<const SensorHit*>(hits->GetHit(j));
+        if (!hit) continue;
+        for (auto& bin: hit->GetHistogram()) detected += bin.second;
+      }
+    }
+
+    return detected;
+  }
+
+
+
+  G4double DefaultEventAction::PeakMemory() const
+  {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0.;
+#ifdef __APPLE__
+    return usage.ru_maxrss / (1024. * 1024.); // bytes
+#else
+    return usage.ru_maxrss / 1024.;           // kilobytes
+#endif
+  }
+
+
+
+  std::vector<std::pair<G4String, G4double>> DefaultEventAction::GetRunStatistics() const
+  {
+    std::vector<std::pair<G4String, G4double>> stats;
+
+    G4double wall_time = wall_times_.sum;
+    G4double cpu_time  = cpu_times_.sum;
+    G4double elapsed   = Seconds(std::chrono::steady_clock::now() - run_start_);
+
+    stats.emplace_back("events",       wall_times_.n);
+    stats.emplace_back("run_time_s",   (wall_times_.n == 0) ? 0. : elapsed);
+    stats.emplace_back("wall_time_s",  wall_time);
+    stats.emplace_back("cpu_time_s",   cpu_time);
+    stats.emplace_back("events_per_second",
+                       (wall_time > 0.) ? wall_times_.n / wall_time : 0.);
+    stats.emplace_back("photons_per_second",
+                       (wall_time > 0.) ? nphotons_.sum / wall_time : 0.);
+
+    stats.emplace_back("event_wall_time_p50_s", wall_times_.Percentile(0.50));
+    stats.emplace_back("event_wall_time_p90_s", wall_times_.Percentile(0.90));
+    stats.emplace_back("event_wall_time_p99_s", wall_times_.Percentile(0.99));
+    stats.emplace_back("event_wall_time_max_s", wall_times_.Percentile(1.00));
+    stats.emplace_back("event_cpu_time_p50_s",  cpu_times_.Percentile(0.50));
+    stats.emplace_back("event_cpu_time_p90_s",  cpu_times_.Percentile(0.90));
+    stats.emplace_back("event_cpu_time_p99_s",  cpu_times_.Percentile(0.99));
+    stats.emplace_back("event_cpu_time_max_s",  cpu_times_.Percentile(1.00));
+
+    stats.emplace_back("tracks_per_event_mean",  ntracks_.Mean());
+    stats.emplace_back("tracks_per_event_max",   ntracks_.Percentile(1.00));
+    stats.emplace_back("photons_per_event_mean", nphotons_.Mean());
+    stats.emplace_back("photons_per_event_max",  nphotons_.Percentile(1.00));
+    stats.emplace_back("detected_photons_per_event_mean", ndetected_.Mean());
+    stats.emplace_back("detected_photons_per_event_max",  ndetected_.Percentile(1.00));
+
+    stats.emplace_back("peak_rss_mb", PeakMemory());
+
+    return stats;
+  }
+
+
 } // end namespace nexus
@@ -3,6 +3,8 @@
 //
 // This is the default event action of the NEXT simulations. Only events with
 // deposited energy larger than 0 are saved in the nexus output file.
+// It also monitors the throughput and memory usage of the run, printing
+// a periodic progress line and a summary saved in the output file.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -13,6 +15,11 @@
 #include <G4UserEventAction.hh>
 #include <globals.hh>
 
+#include <chrono>
+#include <ctime>
+#include <vector>
+#include <utility>
+
 class G4Event;
 class G4GenericMessenger;
 
@@ -33,11 +40,56 @@ namespace nexus {
     /// Hook at the end of the event loop
     void EndOfEventAction(const G4Event*);
 
+    /// Summary of the throughput and memory usage of the current run
+    /// as (name, value) pairs
+    std::vector<std::pair<G4String, G4double>> GetRunStatistics() const;
+
+  private:
+    /// Running sum and maximum of a quantity measured in every event,
+    /// and a bounded sample of its values for the percentiles. The sample
+    /// holds one out of every 'stride' events; when it is full, every
+    /// other value is dropped and the stride doubled.
+    struct EventStatistic
+    {
+      EventStatistic();
+      void Clear();
+      void Add(G4double);
+      G4double Mean() const;
+      /// Value below which the given fraction of the events lie
+      G4double Percentile(G4double fraction) const;
+
+      G4long n;
+      G4double sum, max;
+      G4long stride;
+      std::vector<float> sample;
+    };
+
+  private:
+    /// Print the event number, the event rate and the estimated time left
+    void PrintProgress(G4int event_id);
+    /// Number of optical photons detected in the sensors in this event
+    G4long CountDetectedPhotons(const G4Event*) const;
+    /// Peak resident memory of the process, in MB
+    G4double PeakMemory() const;
+
   private:
     G4GenericMessenger* msg_;
     G4int nevt_, nupdate_;
     G4double energy_min_;
     G4double energy_max_;
+
+    G4double progress_interval_; ///< Max. wall time between progress lines
+
+    std::chrono::steady_clock::time_point run_start_;   ///< Start of the run
+    std::chrono::steady_clock::time_point evt_start_;   ///< Start of the event
+    std::chrono::steady_clock::time_point last_print_;  ///< Last progress line
+    std::clock_t evt_cpu_start_; ///< CPU clock at the start of the event
+
+    EventStatistic wall_times_; ///< Wall time per event (s)
+    EventStatistic cpu_times_;  ///< CPU time per event (s)
+    EventStatistic ntracks_;    ///< Number of tracks per event
+    EventStatistic nphotons_;   ///< Optical photons created per event
+    EventStatistic ndetected_;  ///< Optical photons detected per event
   };
 
 } // namespace nexus
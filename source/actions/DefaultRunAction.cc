@@ -3,14 +3,26 @@
 //
 // This is the default run action of the NEXT simulations.
 // A message at the beginning and at the end of the simulation is printed.
+// If the profiling stepping action is in use, its report is printed too,
+// as are the statistics of the optical photon budget, of the region
+// track killer and of the importance biasing.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
 
 #include "DefaultRunAction.h"
 #include "FactoryBase.h"
+#include "ProfilingSteppingAction.h"
+#include "OpticalPhotonBudget.h"
+#include "RegionTrackKiller.h"
+#include "ImportanceBiasing.h"
 
 #include <G4Run.hh>
+#include <G4RunManager.hh>
+#include <G4ProcessTable.hh>
+#include <G4OpticalPhoton.hh>
+#include <G4Electron.hh>
+#include <G4Gamma.hh>
 
 using namespace nexus;
 
@@ -31,10 +43,71 @@ DefaultRunAction::~DefaultRunAction()
 void DefaultRunAction::BeginOfRunAction(const G4Run* run)
 {
   G4cout << "### Run " << run->GetRunID() << " start." << G4endl;
+
+  ProfilingSteppingAction* profiler = GetProfiler();
+  if (profiler) profiler->Reset();
+
+  OpticalPhotonBudget* budget = GetPhotonBudget();
+  if (budget) budget->ResetStatistics();
+
+  RegionTrackKiller* killer = GetRegionKiller();
+  if (killer) killer->ResetStatistics();
+
+  ImportanceBiasing* biasing = GetImportanceBiasing();
+  if (biasing) biasing->ResetStatistics();
 }
 
 
 void DefaultRunAction::EndOfRunAction(const G4Run* run)
 {
   G4cout << "### Run " << run->GetRunID() << " end." << G4endl;
+
+  ProfilingSteppingAction* profiler = GetProfiler();
+  if (profiler) profiler->PrintReport();
+
+  OpticalPhotonBudget* budget = GetPhotonBudget();
+  if (budget) budget->PrintStatistics();
+
+  RegionTrackKiller* killer = GetRegionKiller();
+  if (killer) killer->PrintStatistics();
+
+  ImportanceBiasing* biasing = GetImportanceBiasing();
+  if (biasing) biasing->PrintStatistics();
+}
+
+
+
+ProfilingSteppingAction* DefaultRunAction::GetProfiler() const
+{
+  const ProfilingSteppingAction* profiler =
+    dynamic_cast<const ProfilingSteppingAction*>
+    (G4RunManager::GetRunManager()->GetUserSteppingAction());
+  return const_cast<ProfilingSteppingAction*>(profiler);
+}
+
+
+
+OpticalPhotonBudget* DefaultRunAction::GetPhotonBudget() const
+{
+  return dynamic_cast<OpticalPhotonBudget*>
+    (G4ProcessTable::GetProcessTable()->
+     FindProcess("OpticalPhotonBudget", G4OpticalPhoton::Definition()));
+}
+
+
+
+RegionTrackKiller* DefaultRunAction::GetRegionKiller() const
+{
+  return dynamic_cast<RegionTrackKiller*>
+    (G4ProcessTable::GetProcessTable()->
+     FindProcess("RegionTrackKiller", G4Electron::Definition()));
+}
+
+
+
+ImportanceBiasing* DefaultRunAction::GetImportanceBiasing() const
+{
+  return dynamic_cast<ImportanceBiasing*>
+    (G4ProcessTable::GetProcessTable()->
+     FindProcess("ImportanceBiasing", G4Gamma::Definition()));
 }
@@ -3,6 +3,9 @@
 //
 // This is the default run action of the NEXT simulations.
 // A message at the beginning and at the end of the simulation is printed.
+// If the profiling stepping action is in use, its report is printed too,
+// as are the statistics of the optical photon budget, of the region
+// track killer and of the importance biasing.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -15,6 +18,11 @@
 
 namespace nexus {
 
+  class ProfilingSteppingAction;
+  class OpticalPhotonBudget;
+  class RegionTrackKiller;
+  class ImportanceBiasing;
+
   class DefaultRunAction: public G4UserRunAction
   {
   public:
@@ -25,6 +33,16 @@ namespace nexus {
 
     virtual void BeginOfRunAction(const G4Run*);
     virtual void EndOfRunAction(const G4Run*);
+
+  private:
+    /// Return the profiling stepping action, if it is the one in use
+    ProfilingSteppingAction* GetProfiler() const;
+    /// Return the optical photon budget process, if it is in use
+    OpticalPhotonBudget* GetPhotonBudget() const;
+    /// Return the region track killer process, if it is in use
+    RegionTrackKiller* GetRegionKiller() const;
+    /// Return the importance biasing process, if it is in use
+    ImportanceBiasing* GetImportanceBiasing() const;
   };
 
 }
@@ -5,6 +5,11 @@
 // It stores in memory the trajectories of all particles, except optical photons
 // and ionization electrons, with the relevant tracking information that will be
 // saved to the output file.
+// Optionally, the trajectories are pruned: only those of the primaries, the
+// tracks that deposit energy in the active volumes, the tracks above an
+// energy threshold or created in selected volumes, and all their ancestors
+// are stored. The trajectories of tracks without secondaries that are not
+// kept are deleted as soon as the track ends.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -21,21 +26,47 @@
 #include <G4Trajectory.hh>
 #include <G4ParticleDefinition.hh>
 #include <G4OpticalPhoton.hh>
+#include <G4GenericMessenger.hh>
+#include <G4RunManager.hh>
+#include <G4Run.hh>
+#include <G4Event.hh>
 
 using namespace nexus;
 
 REGISTER_CLASS(DefaultTrackingAction, G4UserTrackingAction)
 
-DefaultTrackingAction::DefaultTrackingAction() : G4UserTrackingAction()
+DefaultTrackingAction::DefaultTrackingAction() : G4UserTrackingAction(),
+  msg_(0), ntracks_(0), nphotons_(0), prune_(false), energy_min_(0.),
+  run_id_(-1), event_id_(-1)
 {
+  msg_ = new G4GenericMessenger(this, "/Actions/DefaultTrackingAction/");
+  msg_->DeclareProperty("prune_trajectories", prune_,
+                        "Store only the trajectories of the relevant tracks and their ancestors.");
+
+  G4GenericMessenger::Command& energy_cmd =
+    msg_->DeclareProperty("keep_min_energy", energy_min_,
+                          "Kinetic energy above which trajectories are kept when pruning (0 to disable).");
+  energy_cmd.SetUnitCategory("Energy");
+  energy_cmd.SetParameterName("keep_min_energy", false);
+  energy_cmd.SetRange("keep_min_energy>=0.");
+
+  msg_->DeclareMethod("keep_volume", &DefaultTrackingAction::AddKeptVolume,
+                      "Keep the trajectories of tracks created in this volume when pruning.");
 }
 
 DefaultTrackingAction::~DefaultTrackingAction()
 {
+  delete msg_;
 }
 
 void DefaultTrackingAction::PreUserTrackingAction(const G4Track *track)
 {
+  // Count new tracks only, not those resumed after being suspended
+  if (track->GetCurrentStepNumber() == 0) {
+    ntracks_++;
+    if (track->GetDefinition() == G4OpticalPhoton::Definition()) nphotons_++;
+  }
+
   // Do nothing if the track is an optical photon or an ionization electron
   if (track->GetDefinition() == G4OpticalPhoton::Definition() ||
       track->GetDefinition() == IonizationElectron::Definition())
@@ -74,8 +105,97 @@ void DefaultTrackingAction::PostUserTrackingAction(const G4Track *track)
   trj->SetTrackLength(track->GetTrackLength());
   trj->SetFinalVolume(track->GetVolume()->GetName());
   trj->SetFinalMomentum(track->GetMomentum());
+  trj->SetWeight(track->GetWeight());
 
   // Record last process of the track
   G4String proc_name = track->GetStep()->GetPostStepPoint()->GetProcessDefinedStep()->GetProcessName();
   trj->SetFinalProcess(proc_name);
+
+  if (prune_) PruneTrajectory(track, fpTrackingManager->GimmeTrajectory());
+}
+
+void DefaultTrackingAction::PruneTrajectory(const G4Track* track, G4VTrajectory* current)
+{
+  CheckNewEvent();
+
+  G4int track_id = track->GetTrackID();
+  parents_[track_id] = track->GetParentID();
+
+  // Tracks suspended to be resumed later are kept, since
+  // their trajectory is made of several pieces
+  if (track->GetTrackStatus() == fSuspend) {
+    Keep(track_id);
+    return;
+  }
+
+  Trajectory* trj = (Trajectory*) TrajectoryMap::Get(track_id);
+
+  G4bool keep = track->GetParentID() == 0 ||
+                trj->GetEnergyDeposit() > 0. ||
+                (energy_min_ > 0. && track->GetVertexKineticEnergy() > energy_min_) ||
+                volumes_.count(trj->GetInitialVolume()) > 0;
+
+  if (keep) {
+    Keep(track_id);
+    return;
+  }
+
+  // The trajectory may still be needed as the ancestor of a secondary
+  // kept later on, unless all the secondaries are optical photons
+  // or ionization electrons, which have no trajectory
+  const G4TrackVector* secondaries = fpTrackingManager->GimmeSecondaries();
+  if (secondaries) {
+    for (const G4Track* secondary: *secondaries) {
+      if (secondary->GetDefinition() != G4OpticalPhoton::Definition() &&
+          secondary->GetDefinition() != IonizationElectron::Definition())
+        return;
+    }
+  }
+
+  // Otherwise it is released right now: the tracking manager
+  // deletes the trajectory instead of passing it to the event
+  if (trj == current) {
+    TrajectoryMap::Remove(track_id);
+    fpTrackingManager->SetStoreTrajectory(false);
+  }
+}
+
+void DefaultTrackingAction::Keep(G4int track_id)
+{
+  // Stop at the first ancestor already kept
+  while (track_id > 0 && kept_.insert(track_id).second) {
+    auto it = parents_.find(track_id);
+    track_id = (it != parents_.end()) ? it->second : 0;
+  }
+}
+
+G4int DefaultTrackingAction::GetKeptAncestor(G4int track_id) const
+{
+  if (!prune_) return track_id;
+
+  while (track_id > 0 && !kept_.count(track_id)) {
+    auto it = parents_.find(track_id);
+    track_id = (it != parents_.end()) ? it->second : 0;
+  }
+  return track_id;
+}
+
+void DefaultTrackingAction::CheckNewEvent()
+{
+  // Track IDs start again in every event
+  const G4RunManager* rm = G4RunManager::GetRunManager();
+  G4int run_id   = rm->GetCurrentRun()   ? rm->GetCurrentRun()->GetRunID()     : -1;
+  G4int event_id = rm->GetCurrentEvent() ? rm->GetCurrentEvent()->GetEventID() : -1;
+
+  if (run_id != run_id_ || event_id != event_id_) {
+    run_id_   = run_id;
+    event_id_ = event_id;
+    parents_.clear();
+    kept_.clear();
+  }
+}
+
+void DefaultTrackingAction::AddKeptVolume(G4String volume)
+{
+  volumes_.insert(volume);
 }
@@ -5,6 +5,11 @@
 // It stores in memory the trajectories of all particles, except optical photons
 // and ionization electrons, with the relevant tracking information that will be
 // saved to the output file.
+// Optionally, the trajectories are pruned: only those of the primaries, the
+// tracks that deposit energy in the active volumes, the tracks above an
+// energy threshold or created in selected volumes, and all their ancestors
+// are stored. The trajectories of tracks without secondaries that are not
+// kept are deleted as soon as the track ends.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -13,8 +18,15 @@
 #define DEFAULT_TRACKING_ACTION_H
 
 #include <G4UserTrackingAction.hh>
+#include <globals.hh>
+
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
 
 class G4Track;
+class G4VTrajectory;
+class G4GenericMessenger;
 
 
 namespace nexus {
@@ -31,8 +43,64 @@ namespace nexus {
 
     virtual void PreUserTrackingAction(const G4Track*);
     virtual void PostUserTrackingAction(const G4Track*);
+
+    /// Number of tracks processed since the last reset
+    G4long GetNumberOfTracks() const;
+    /// Number of optical photons processed since the last reset
+    G4long GetNumberOfOpticalPhotons() const;
+    /// Reset the track counters (typically, at the beginning of an event)
+    void ResetCounters();
+
+    /// True if the trajectories of the event are pruned
+    G4bool GetPruneTrajectories() const;
+    /// True if the trajectory of a track of the current event is stored
+    G4bool IsKept(G4int track_id) const;
+    /// Closest ancestor of a track (or the track itself) whose
+    /// trajectory is stored, 0 if there is none
+    G4int GetKeptAncestor(G4int track_id) const;
+
+  private:
+    /// Decide whether to keep the trajectory of a finished track
+    void PruneTrajectory(const G4Track*, G4VTrajectory*);
+    /// Keep the trajectory of a track and of all its ancestors
+    void Keep(G4int track_id);
+    /// Forget the tracks of the previous event
+    void CheckNewEvent();
+    /// Add a volume to the list of volumes whose tracks are kept
+    void AddKeptVolume(G4String);
+
+  private:
+    G4GenericMessenger* msg_;
+
+    G4long ntracks_;   ///< Number of tracks
+    G4long nphotons_;  ///< Number of optical photons
+
+    G4bool prune_;            ///< Prune the trajectories
+    G4double energy_min_;     ///< Kinetic energy above which tracks are kept (none if 0)
+    std::set<G4String> volumes_; ///< Volumes where the tracks created are kept
+
+    G4int run_id_, event_id_; ///< Event of the tracks below
+    std::unordered_map<G4int, G4int> parents_; ///< Parent of each track with a trajectory
+    std::unordered_set<G4int> kept_;           ///< Tracks whose trajectory is stored
   };
 
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline G4long DefaultTrackingAction::GetNumberOfTracks() const
+  { return ntracks_; }
+
+  inline G4long DefaultTrackingAction::GetNumberOfOpticalPhotons() const
+  { return nphotons_; }
+
+  inline void DefaultTrackingAction::ResetCounters()
+  { ntracks_ = 0; nphotons_ = 0; }
+
+  inline G4bool DefaultTrackingAction::GetPruneTrajectories() const
+  { return prune_; }
+
+  inline G4bool DefaultTrackingAction::IsKept(G4int track_id) const
+  { return !prune_ || kept_.count(track_id) > 0; }
+
 }
 
 #endif
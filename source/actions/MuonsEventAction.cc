@@ -53,6 +53,7 @@ REGISTER_CLASS(MuonsEventAction, G4UserEventAction)
     fG4AnalysisMan_->CreateNtuple("Tree nexus","Flat tree of muon zenith and azimuth");
     fG4AnalysisMan_->CreateNtupleDColumn("tree_zenith");
     fG4AnalysisMan_->CreateNtupleDColumn("tree_azimuth");
+    fG4AnalysisMan_->CreateNtupleDColumn("tree_weight");
     fG4AnalysisMan_->FinishNtuple();
 
   }
@@ -127,12 +128,14 @@ REGISTER_CLASS(MuonsEventAction, G4UserEventAction)
 
     G4double my_zenith = my_getinfo2->GetZenith();
     G4double my_azimuth = my_getinfo2->GetAzimuth();
+    G4double my_weight = my_getinfo2->GetWeight();
 
     fG4AnalysisMan_->FillH1(1, my_zenith);
     fG4AnalysisMan_->FillH1(2, my_azimuth);
 
     fG4AnalysisMan_->FillNtupleDColumn(0, my_zenith);
     fG4AnalysisMan_->FillNtupleDColumn(1, my_azimuth);
+    fG4AnalysisMan_->FillNtupleDColumn(2, my_weight);
     fG4AnalysisMan_->AddNtupleRow();
 
   }
@@ -0,0 +1,194 @@
+// ----------------------------------------------------------------------------
+// nexus | ProfilingSteppingAction.cc
+//
+// This class accumulates the number of steps, the number of tracks and
+// a sampled estimate of the CPU time spent in stepping for every
+// combination of particle type, logical volume and process. Steps are
+// timed within a track only, so the first step of a track is never timed.
+// A sorted report is printed at the end of the run, and the counters
+// are also saved in the output file.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "ProfilingSteppingAction.h"
+#include "FactoryBase.h"
+
+#include <G4Step.hh>
+#include <G4Track.hh>
+#include <G4VProcess.hh>
+#include <G4LogicalVolume.hh>
+#include <G4VPhysicalVolume.hh>
+#include <G4ParticleDefinition.hh>
+#include <G4GenericMessenger.hh>
+
+#include <algorithm>
+#include <iomanip>
+#include <ctime>
+
+using namespace nexus;
+
+REGISTER_CLASS(ProfilingSteppingAction, G4UserSteppingAction)
+
+
+
+ProfilingSteppingAction::ProfilingSteppingAction():
+  G4UserSteppingAction(), msg_(0), sampling_period_(100), report_entries_(20),
+  last_counters_(nullptr), step_count_(0), timing_(false), time_start_(0.)
+{
+  msg_ = new G4GenericMessenger(this, "/Actions/ProfilingSteppingAction/",
+                                "Control commands of the profiling stepping action.");
+
+  G4GenericMessenger::Command& period_cmd =
+    msg_->DeclareProperty("sampling_period", sampling_period_,
+                          "One out of this number of steps is timed.");
+  period_cmd.SetParameterName("sampling_period", false);
+  period_cmd.SetRange("sampling_period>0");
+
+  G4GenericMessenger::Command& entries_cmd =
+    msg_->DeclareProperty("report_entries", report_entries_,
+                          "Number of entries printed in the end-of-run report.");
+  entries_cmd.SetParameterName("report_entries", false);
+  entries_cmd.SetRange("report_entries>=0");
+}
+
+
+
+ProfilingSteppingAction::~ProfilingSteppingAction()
+{
+  delete msg_;
+}
+
+
+
+void ProfilingSteppingAction::UserSteppingAction(const G4Step* step)
+{
+  const G4Track* track = step->GetTrack();
+  const G4VProcess* process =
+    step->GetPostStepPoint()->GetProcessDefinedStep();
+
+  Key key = {track->GetDefinition(),
+             step->GetPreStepPoint()->GetPhysicalVolume()->GetLogicalVolume(),
+             process};
+
+  // Consecutive steps very often share the key, so the hash
+  // lookup is skipped in that case
+  Counters* counters = last_counters_;
+  if (!counters || !(key == last_key_)) counters = &counters_[key];
+
+  counters->steps++;
+  if (track->GetCurrentStepNumber() == 1) counters->tracks++;
+
+  // The time elapsed since the previous step is the cost of this one.
+  // Only one out of sampling_period_ steps is timed, and its cost is
+  // scaled accordingly. Intervals are timed only within a track: one
+  // open at the first step of a track would also include the stacking,
+  // the hit processing and the output of whatever came in between,
+  // so the sample is moved to the next step of the track instead.
+  if (timing_) {
+    if (track->GetCurrentStepNumber() == 1) {
+      time_start_ = ThreadCPUTime();
+    }
+    else {
+      counters->cpu_time += (ThreadCPUTime() - time_start_) * sampling_period_;
+      timing_ = false;
+    }
+  }
+
+  if (!timing_ && ++step_count_ >= sampling_period_) {
+    step_count_ = 0;
+    timing_ = true;
+    time_start_ = ThreadCPUTime();
+  }
+
+  last_key_ = key;
+  last_counters_ = counters;
+}
+
+
+
+G4double ProfilingSteppingAction::ThreadCPUTime() const
+{
+  timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ts.tv_sec + 1.e-9 * ts.tv_nsec;
+}
+
+
+
+void ProfilingSteppingAction::Reset()
+{
+  counters_.clear();
+  last_counters_ = nullptr;
+  step_count_ = 0;
+  timing_ = false;
+}
+
+
+
+std::vector<ProfileEntry> ProfilingSteppingAction::GetProfile() const
+{
+  std::vector<ProfileEntry> profile;
+  profile.reserve(counters_.size());
+
+  for (auto& kv: counters_) {
+    ProfileEntry entry;
+    entry.particle = kv.first.particle->GetParticleName();
+    entry.volume   = kv.first.volume->GetName();
+    entry.process  = kv.first.process ? kv.first.process->GetProcessName() : "none";
+    entry.steps    = kv.second.steps;
+    entry.tracks   = kv.second.tracks;
+    entry.cpu_time = kv.second.cpu_time;
+    profile.push_back(entry);
+  }
+
+  std::sort(profile.begin(), profile.end(),
+            [](const ProfileEntry& a, const ProfileEntry& b) {
+              if (a.cpu_time != b.cpu_time) return a.cpu_time > b.cpu_time;
+              return a.steps > b.steps;
+            });
+
+  return profile;
+}
+
+
+
+void ProfilingSteppingAction::PrintReport() const
+{
+  std::vector<ProfileEntry> profile = GetProfile();
+
+  G4double total_time = 0.;
+  G4long total_steps = 0;
+  for (auto& entry: profile) {
+    total_time  += entry.cpu_time;
+    total_steps += entry.steps;
+  }
+
+  G4cout << "### Stepping profile (" << total_steps << " steps, "
+         << total_time << " s sampled CPU time, 1/" << sampling_period_
+         << " steps timed)" << G4endl;
+  G4cout << std::left
+         << std::setw(16) << "particle"
+         << std::setw(28) << "volume"
+         << std::setw(24) << "process"
+         << std::right
+         << std::setw(14) << "steps"
+         << std::setw(12) << "tracks"
+         << std::setw(12) << "time [s]"
+         << std::setw(8)  << "%" << G4endl;
+
+  G4int n = std::min((G4int) profile.size(), report_entries_);
+  for (G4int i=0; i<n; ++i) {
+    const ProfileEntry& entry = profile[i];
+    G4double fraction = (total_time > 0.) ? 100. * entry.cpu_time / total_time : 0.;
+    G4cout << std::left
+           << std::setw(16) << entry.particle
+           << std::setw(28) << entry.volume
+           << std::setw(24) << entry.process
+           << std::right
+           << std::setw(14) << entry.steps
+           << std::setw(12) << entry.tracks
+           << std::setw(12) << std::setprecision(4) << entry.cpu_time
+           << std::setw(8)  << std::setprecision(3) << fraction << G4endl;
+  }
+}
@@ -0,0 +1,117 @@
+// ----------------------------------------------------------------------------
+// nexus | ProfilingSteppingAction.h
+//
+// This class accumulates the number of steps, the number of tracks and
+// a sampled estimate of the CPU time spent in stepping for every
+// combination of particle type, logical volume and process. Steps are
+// timed within a track only, so the first step of a track is never timed.
+// A sorted report is printed at the end of the run, and the counters
+// are also saved in the output file.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef PROFILING_STEPPING_ACTION_H
+#define PROFILING_STEPPING_ACTION_H
+
+#include <G4UserSteppingAction.hh>
+#include <globals.hh>
+
+#include <unordered_map>
+#include <functional>
+#include <vector>
+
+class G4Step;
+class G4ParticleDefinition;
+class G4LogicalVolume;
+class G4VProcess;
+class G4GenericMessenger;
+
+
+namespace nexus {
+
+  /// Profiling counters for a (particle, volume, process) combination
+  struct ProfileEntry
+  {
+    G4String particle;
+    G4String volume;
+    G4String process;
+    G4long   steps;
+    G4long   tracks;
+    G4double cpu_time; ///< sampled CPU time, in seconds
+  };
+
+
+  class ProfilingSteppingAction: public G4UserSteppingAction
+  {
+  public:
+    /// Constructor
+    ProfilingSteppingAction();
+    /// Destructor
+    ~ProfilingSteppingAction();
+
+    virtual void UserSteppingAction(const G4Step*);
+
+    /// Return the accumulated counters sorted by decreasing CPU time
+    std::vector<ProfileEntry> GetProfile() const;
+
+    /// Print the most expensive entries of the profile
+    void PrintReport() const;
+
+    /// Reset all counters (invoked at the beginning of every run)
+    void Reset();
+
+  private:
+    struct Key
+    {
+      const G4ParticleDefinition* particle;
+      const G4LogicalVolume* volume;
+      const G4VProcess* process;
+
+      G4bool operator==(const Key& other) const
+      {
+        return particle == other.particle && volume == other.volume &&
+          process == other.process;
+      }
+    };
+
+    struct KeyHash
+    {
+      size_t operator()(const Key& k) const
+      {
+        size_t h = std::hash<const void*>()(k.particle);
+        h = h * 31 + std::hash<const void*>()(k.volume);
+        h = h * 31 + std::hash<const void*>()(k.process);
+        return h;
+      }
+    };
+
+    struct Counters
+    {
+      G4long steps;
+      G4long tracks;
+      G4double cpu_time;
+    };
+
+    /// CPU time consumed so far by this thread, in seconds
+    G4double ThreadCPUTime() const;
+
+  private:
+    G4GenericMessenger* msg_;
+
+    G4int sampling_period_; ///< One out of this many steps is timed
+    G4int report_entries_;  ///< Number of entries printed in the report
+
+    std::unordered_map<Key, Counters, KeyHash> counters_;
+
+    Key last_key_;             ///< Key of the previous step
+    Counters* last_counters_;  ///< Counters of the previous step
+
+    G4long step_count_;    ///< Steps seen since the last timed step
+    G4bool timing_;        ///< A timed interval is open
+    G4double time_start_;  ///< Start of the timed interval
+  };
+
+} // namespace nexus
+
+#endif
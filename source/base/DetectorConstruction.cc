@@ -8,6 +8,7 @@
 
 #include "DetectorConstruction.h"
 #include "GeometryBase.h"
+#include "OpticalPropertiesCache.h"
 
 #include <G4Box.hh>
 #include <G4Material.hh>
@@ -16,6 +17,8 @@
 #include <G4VisAttributes.hh>
 #include <G4PVPlacement.hh>
 
+#include <chrono>
+
 
 using namespace nexus;
 
@@ -44,8 +47,16 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
   // At this point the user should have loaded the configuration
   // parameters of the geometry or it will get built with the
   // default values.
+  auto start = std::chrono::steady_clock::now();
+
   geometry_->Construct();
 
+  G4cout << "### Geometry constructed in "
+         << std::chrono::duration<G4double>
+            (std::chrono::steady_clock::now() - start).count()
+         << " s" << G4endl;
+  OpticalPropertiesCache::Instance().PrintReport();
+
   // We define now the world volume as an empty box big enough
   // to fit the user's geometry inside.
 
@@ -3,7 +3,9 @@
 //
 // This class is the run manager of the nexus simulation. It takes care of
 // setting up the simulation (geometry, physics lists, generators, actions),
-// so that it is ready to be run.
+// so that it is ready to be run. Optionally, the physics tables are kept
+// in a cache directory so that jobs with the same configuration skip
+// their computation.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -15,6 +17,8 @@
 #include "DetectorConstruction.h"
 #include "PrimaryGeneration.h"
 #include "FactoryBase.h"
+#include "IOUtils.h"
+#include "SensorSD.h"
 
 #include <G4GenericPhysicsList.hh>
 #include <G4UImanager.hh>
@@ -26,6 +30,20 @@
 #include <G4UserTrackingAction.hh>
 #include <G4UserSteppingAction.hh>
 #include <G4UserStackingAction.hh>
+#include <G4VUserPhysicsList.hh>
+#include <G4Version.hh>
+#include <G4PhysicalVolumeStore.hh>
+#include <G4LogicalVolume.hh>
+#include <G4VSolid.hh>
+#include <G4Material.hh>
+#include <G4MaterialPropertiesTable.hh>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <unistd.h>
 
 using namespace nexus;
 using std::make_unique;
@@ -36,7 +54,11 @@ NexusApp::NexusApp(G4String init_macro): G4RunManager(), gen_name_(""),
                                          geo_name_(""), pm_name_(""),
                                          runact_name_(""), evtact_name_(""),
                                          stepact_name_(""), trkact_name_(""),
-                                         stkact_name_("")
+                                         stkact_name_(""),
+                                         init_macro_(init_macro),
+                                         table_cache_(""), table_dir_(""),
+                                         tables_retrieved_(false),
+                                         tables_ready_(false), init_time_(0.)
 {
   // Create and configure a generic messenger for the app
   msg_ = make_unique<G4GenericMessenger>(this, "/nexus/", "Nexus control commands.");
@@ -55,6 +77,11 @@ NexusApp::NexusApp(G4String init_macro): G4RunManager(), gen_name_(""),
   msg_->DeclareMethod("random_seed", &NexusApp::SetRandomSeed,
                       "Set a seed for the random number generator.");
 
+  // Define the command to set a directory where the physics tables
+  // are stored and retrieved from in later jobs with the same configuration
+  msg_->DeclareProperty("physics_table_cache", table_cache_,
+                        "Directory where the physics tables are cached.");
+
 // Define the command to set the desired generator
   msg_->DeclareProperty("RegisterGenerator", gen_name_, "");
 
@@ -184,8 +211,34 @@ void NexusApp::Initialize()
     ExecuteMacroFile(macros_[i].data());
   }
 
+  auto start = std::chrono::steady_clock::now();
+
+  // The geometry is built first, so that its materials
+  // are part of the configuration identifying the tables
+  if (table_cache_ != "") InitializeGeometry();
+
+  // Retrieve the physics tables if they were already computed
+  // for the same configuration
+  G4String hash = (table_cache_ != "") ? ConfigurationHash() : "";
+  if (table_cache_ != "" && hash == "") {
+    G4Exception("[NexusApp]", "Initialize()", JustWarning,
+                "Unable to read all the nested macros: the physics table cache is not used.");
+  }
+  else if (table_cache_ != "") {
+    table_dir_ = table_cache_ + "/" + hash;
+    tables_retrieved_ = std::filesystem::is_directory(table_dir_.data());
+    if (tables_retrieved_) {
+      G4VUserPhysicsList* physics =
+        const_cast<G4VUserPhysicsList*>(GetUserPhysicsList());
+      physics->SetPhysicsTableRetrieved(table_dir_);
+    }
+  }
+
   G4RunManager::Initialize();
 
+  init_time_ = std::chrono::duration<G4double>
+    (std::chrono::steady_clock::now() - start).count();
+
   for (unsigned int j=0; j<delayed_.size(); j++) {
     ExecuteMacroFile(delayed_[j].data());
   }
@@ -199,6 +252,234 @@ void NexusApp::Initialize()
 
 
 
+void NexusApp::RunInitialization()
+{
+  auto start = std::chrono::steady_clock::now();
+
+  // The physics tables are built here at the start of the first run
+  G4RunManager::RunInitialization();
+
+  // The sensors are looked up by the fast simulation models; the
+  // geometry cannot be walked safely once tracking has started
+  SensorSD::BuildSensorMap();
+
+  if (tables_ready_) return;
+  tables_ready_ = true;
+
+  G4double time = init_time_ + std::chrono::duration<G4double>
+    (std::chrono::steady_clock::now() - start).count();
+
+  if (table_dir_ == "") return;
+
+  if (tables_retrieved_) {
+    G4double build_time = 0.;
+    std::ifstream timing(table_dir_ + "/build_time");
+    timing >> build_time;
+    G4cout << "### Physics tables retrieved from " << table_dir_ << ": initialization took "
+           << time << " s (" << build_time << " s building them)" << G4endl;
+  }
+  else {
+    StorePhysicsTables(time);
+    G4cout << "### Physics tables built and stored in " << table_dir_
+           << ": initialization took " << time << " s" << G4endl;
+  }
+}
+
+
+
+void NexusApp::StorePhysicsTables(G4double build_time)
+{
+  // The tables are written to a temporary directory first and renamed
+  // at the end, so that concurrent jobs never read an incomplete cache
+  std::filesystem::path dir(table_dir_.data());
+  std::filesystem::path tmp_dir(dir.string() + ".tmp" + std::to_string(getpid()));
+
+  std::error_code error;
+  std::filesystem::create_directories(tmp_dir, error);
+  if (error) {
+    G4Exception("[NexusApp]", "StorePhysicsTables()", JustWarning,
+                ("Cannot create the physics table cache " + tmp_dir.string()).c_str());
+    return;
+  }
+
+  G4VUserPhysicsList* physics =
+    const_cast<G4VUserPhysicsList*>(GetUserPhysicsList());
+  physics->StorePhysicsTable(tmp_dir.string());
+
+  std::ofstream timing(tmp_dir / "build_time");
+  timing << build_time << std::endl;
+  timing.close();
+
+  std::filesystem::rename(tmp_dir, dir, error);
+  if (error) {
+    // Another job filled the cache in the meantime
+    std::filesystem::remove_all(tmp_dir, error);
+  }
+}
+
+
+
+G4bool NexusApp::ConfigurationCommands(std::vector<std::string>& commands) const
+{
+  std::vector<G4String> files = {init_macro_};
+  files.insert(files.end(), macros_.begin(), macros_.end());
+  files.insert(files.end(), delayed_.begin(), delayed_.end());
+
+  G4bool complete = true;
+  for (auto& file: files)
+    complete = ReadMacroCommands(file, commands, 0) && complete;
+
+  return complete;
+}
+
+
+
+G4bool NexusApp::ReadMacroCommands(const G4String& file,
+                                   std::vector<std::string>& commands,
+                                   G4int depth) const
+{
+  // Guard against macros that execute themselves
+  if (depth > 100) return false;
+
+  std::ifstream macro(file);
+  if (!macro.is_open()) return false;
+
+  const std::string execute = "/control/execute";
+
+  G4bool complete = true;
+  std::string line;
+  while (std::getline(macro, line)) {
+    size_t first = line.find_first_not_of(" \t");
+    if (first == std::string::npos || line[first] == '#') continue;
+    line = line.substr(first);
+    commands.push_back(line);
+
+    // Nested macros are expanded in place
+    if (line.compare(0, execute.size(), execute) == 0) {
+      std::istringstream args(line.substr(execute.size()));
+      G4String nested;
+      if (!(args >> nested)) { complete = false; continue; }
+      nested = G4UImanager::GetUIpointer()->FindMacroPath(nested);
+      complete = ReadMacroCommands(nested, commands, depth + 1) && complete;
+    }
+  }
+
+  return complete;
+}
+
+
+
+G4String NexusApp::ConfigurationHash() const
+{
+  // Commands that change from job to job but do not
+  // affect the physics tables are left out of the hash
+  const std::vector<G4String> ignored =
+    {"/nexus/random_seed", "/nexus/persistency/", "/nexus/RegisterMacro",
+     "/nexus/RegisterDelayedMacro", "/nexus/physics_table_cache"};
+
+  // Without all the nested macros the configuration is unknown
+  std::vector<std::string> commands;
+  if (!ConfigurationCommands(commands)) return "";
+
+  std::string config = G4Version;
+
+  for (auto& line: commands) {
+    G4bool skip = false;
+    for (auto& cmd: ignored)
+      if (line.compare(0, cmd.size(), cmd) == 0) skip = true;
+    if (!skip) config += line + "\n";
+  }
+
+  // The materials actually defined, so that changes of their
+  // composition or optical properties in the code, and not only
+  // of the commands, give a different hash
+  std::ostringstream materials;
+  materials << std::setprecision(10);
+  for (const G4Material* mat: *G4Material::GetMaterialTable()) {
+    materials << mat->GetName() << " " << mat->GetDensity() << " "
+              << mat->GetState() << " " << mat->GetTemperature() << " "
+              << mat->GetPressure();
+    for (size_t i=0; i<mat->GetNumberOfElements(); ++i)
+      materials << " " << mat->GetElement(i)->GetName()
+                << " " << mat->GetFractionVector()[i];
+    materials << "\n";
+
+    const G4MaterialPropertiesTable* mpt = mat->GetMaterialPropertiesTable();
+    if (!mpt) continue;
+
+    const std::vector<G4String>& names = mpt->GetMaterialPropertyNames();
+    for (size_t i=0; i<names.size(); ++i) {
+      const G4MaterialPropertyVector* vec = mpt->GetProperty(G4int(i));
+      if (!vec) continue;
+      materials << " " << names[i];
+      for (size_t j=0; j<vec->GetVectorLength(); ++j)
+        materials << " " << vec->Energy(j) << " " << (*vec)[j];
+      materials << "\n";
+    }
+
+    const std::vector<G4String>& const_names = mpt->GetMaterialConstPropertyNames();
+    for (size_t i=0; i<const_names.size(); ++i) {
+      if (mpt->ConstPropertyExists(G4int(i)))
+        materials << " " << const_names[i] << " " << mpt->GetConstProperty(G4int(i)) << "\n";
+    }
+  }
+  config += materials.str();
+
+  return HashString(config);
+}
+
+
+
+G4String NexusApp::GeometryHash() const
+{
+  // Only the choice of geometry and its own commands
+  const std::vector<G4String> selected =
+    {"/nexus/RegisterGeometry", "/Geometry/"};
+
+  std::vector<std::string> commands;
+  ConfigurationCommands(commands);
+
+  std::string config = G4Version;
+
+  for (auto& line: commands) {
+    for (auto& cmd: selected)
+      if (line.compare(0, cmd.size(), cmd) == 0) config += line + "\n";
+  }
+
+  // The volumes actually built, so that changes of the geometry
+  // code, and not only of its commands, give a different hash
+  std::ostringstream volumes;
+  volumes << std::setprecision(10);
+  for (const G4VPhysicalVolume* pv: *G4PhysicalVolumeStore::GetInstance()) {
+    const G4LogicalVolume* lv = pv->GetLogicalVolume();
+    volumes << pv->GetName() << " " << lv->GetName();
+
+    // The placement, shape and material of replicas and parameterised
+    // volumes change as they are navigated: only their number is meaningful
+    if (pv->IsReplicated()) {
+      volumes << " " << pv->GetMultiplicity() << "\n";
+      continue;
+    }
+
+    const G4VSolid* solid = lv->GetSolid();
+    G4ThreeVector min, max;
+    solid->BoundingLimits(min, max);
+    volumes << " " << solid->GetEntityType() << " " << min << " " << max << " "
+            << (lv->GetMaterial() ? lv->GetMaterial()->GetName() : "")
+            << " " << pv->GetCopyNo() << " " << pv->GetTranslation();
+    if (const G4RotationMatrix* rot = pv->GetRotation())
+      volumes << " " << rot->xx() << " " << rot->xy() << " " << rot->xz()
+              << " " << rot->yx() << " " << rot->yy() << " " << rot->yz()
+              << " " << rot->zx() << " " << rot->zy() << " " << rot->zz();
+    volumes << "\n";
+  }
+  config += volumes.str();
+
+  return HashString(config);
+}
+
+
+
 void NexusApp::ExecuteMacroFile(const char* filename)
 {
   G4UImanager* UI = G4UImanager::GetUIpointer();
@@ -3,7 +3,9 @@
 //
 // This class is the run manager of the nexus simulation. It takes care of
 // setting up the simulation (geometry, physics lists, generators, actions),
-// so that it is ready to be run.
+// so that it is ready to be run. Optionally, the physics tables are kept
+// in a cache directory so that jobs with the same configuration skip
+// their computation.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -30,9 +32,19 @@ namespace nexus {
 
     virtual void Initialize();
 
+    /// Builds (or retrieves) the physics tables at the start of the
+    /// first run, storing them in the cache if requested
+    virtual void RunInitialization();
+
     /// Returns the number of events to be processed in the current run
     G4int GetNumberOfEventsToBeProcessed() const;
 
+    /// Hash of the geometry commands of the configuration macros, the
+    /// Geant4 version and the volumes built (placement, shape, extent
+    /// and material), which identifies the caches that depend only on
+    /// the geometry
+    G4String GeometryHash() const;
+
   private:
     void RegisterMacro(G4String);
 
@@ -44,6 +56,23 @@ namespace nexus {
     /// If a negative value is chosen, the system time is set as seed.
     void SetRandomSeed(G4int);
 
+    /// Non-empty, non-comment lines of all the configuration macros,
+    /// with the macros run through /control/execute expanded in place.
+    /// Returns false if any of them could not be read.
+    G4bool ConfigurationCommands(std::vector<std::string>&) const;
+    /// Append the commands of a macro file, expanding nested macros
+    G4bool ReadMacroCommands(const G4String& file,
+                             std::vector<std::string>& commands, G4int depth) const;
+
+    /// Hash of the configuration macros, the Geant4 version and the
+    /// materials defined (composition and properties), which identifies
+    /// the physics tables in the cache (empty if some macro could not
+    /// be read). The geometry must have been built.
+    G4String ConfigurationHash() const;
+
+    /// Save the physics tables in the cache directory
+    void StorePhysicsTables(G4double build_time);
+
   private:
     std::unique_ptr<G4GenericMessenger> msg_;
     G4String gen_name_; ///< Name of the chosen primary generator
@@ -55,9 +84,16 @@ namespace nexus {
     G4String trkact_name_; ///< Name of the chosen tracking action
     G4String stkact_name_; ///< Name of the chosen stacking action
 
+    G4String init_macro_; ///< Name of the initialization macro
     std::vector<G4String> macros_;
     std::vector<G4String> delayed_;
 
+    G4String table_cache_; ///< Directory of the physics table cache
+    G4String table_dir_;   ///< Cache subdirectory of this configuration
+    G4bool tables_retrieved_; ///< Physics tables read from the cache
+    G4bool tables_ready_;     ///< Physics tables already built or retrieved
+    G4double init_time_;      ///< Time spent in the initialization (s)
+
     std::unique_ptr<PersistencyManagerBase> pm_;
 
   };
@@ -26,7 +26,7 @@ G4Allocator<Trajectory> TrjAllocator;
 Trajectory::Trajectory(const G4Track* track):
   G4VTrajectory(), pdef_(0), trackId_(-1), parentId_(-1),
   initial_time_(0.), final_time_(0), length_(0.), edep_(0.),
-  record_trjpoints_(true), trjpoints_(0)
+  weight_(1.), record_trjpoints_(true), trjpoints_(0)
 {
   pdef_     = track->GetDefinition();
   trackId_  = track->GetTrackID();
@@ -41,6 +41,7 @@ Trajectory::Trajectory(const G4Track* track):
   initial_position_ = track->GetVertexPosition();
   initial_time_ = track->GetGlobalTime();
   initial_volume_ = track->GetVolume()->GetName();
+  weight_ = track->GetWeight();
 
   trjpoints_ = new TrajectoryPointContainer();
   TrajectoryPoint* first_trj_point = 
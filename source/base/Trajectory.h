@@ -93,6 +93,10 @@ namespace nexus {
     G4String GetFinalProcess() const;
     void SetFinalProcess(G4String);
 
+    // Weight of the track at its end (importance biasing)
+    G4double GetWeight() const;
+    void SetWeight(G4double);
+
 
     // Trajectory points
 
@@ -139,6 +143,8 @@ namespace nexus {
     G4String initial_volume_;
     G4String final_volume_;
 
+    G4double weight_;
+
     G4bool record_trjpoints_;
 
     TrajectoryPointContainer* trjpoints_;
@@ -231,4 +237,8 @@ inline G4String nexus::Trajectory::GetFinalVolume() const
 inline void nexus::Trajectory::SetFinalVolume(G4String fv)
 { final_volume_ = fv; }
 
+inline G4double nexus::Trajectory::GetWeight() const { return weight_; }
+
+inline void nexus::Trajectory::SetWeight(G4double w) { weight_ = w; }
+
 #endif
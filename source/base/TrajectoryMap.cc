@@ -50,4 +50,11 @@ namespace nexus {
     map_[trj->GetTrackID()] = trj;
   }
 
+
+
+  void TrajectoryMap::Remove(int trackId)
+  {
+    map_.erase(trackId);
+  }
+
 } // namespace nexus
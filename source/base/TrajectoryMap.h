@@ -23,6 +23,8 @@ namespace nexus {
     static G4VTrajectory* Get(int trackId);
     /// Add a trajectory to the map
     static void Add(G4VTrajectory*);
+    /// Remove the trajectory of a track (before deleting it)
+    static void Remove(int trackId);
     /// Clear the map
     static void Clear();
 
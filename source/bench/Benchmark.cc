@@ -0,0 +1,35 @@
+// ----------------------------------------------------------------------------
+// nexus | Benchmark.cc
+//
+// Minimal microbenchmark harness used by nexus-bench. Benchmarks register
+// themselves with the NEXUS_BENCHMARK macro and time a user-defined loop.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "Benchmark.h"
+
+using namespace nexus;
+
+
+
+G4bool BenchmarkRegistry::Add(const G4String& name, G4long iterations,
+                              BenchmarkFunction function)
+{
+  BenchmarkEntry entry;
+  entry.name = name;
+  entry.iterations = iterations;
+  entry.function = function;
+  Get().push_back(entry);
+  return true;
+}
+
+
+
+std::vector<BenchmarkEntry>& BenchmarkRegistry::Get()
+{
+  // Function-local static to avoid depending on the initialization
+  // order of the translation units that register benchmarks
+  static std::vector<BenchmarkEntry> benchmarks;
+  return benchmarks;
+}
@@ -0,0 +1,128 @@
+// ----------------------------------------------------------------------------
+// nexus | Benchmark.h
+//
+// Minimal microbenchmark harness used by nexus-bench. Benchmarks register
+// themselves with the NEXUS_BENCHMARK macro and time a user-defined loop.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <globals.hh>
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <vector>
+
+
+namespace nexus {
+
+  class BenchmarkState
+  {
+  public:
+    /// Constructor providing the number of iterations of the timed loop
+    BenchmarkState(G4long iterations);
+    /// Destructor
+    ~BenchmarkState() {}
+
+    /// Number of iterations the benchmark must run in its timed loop
+    G4long Iterations() const;
+
+    /// Start the clock (setup work done before this call is not timed)
+    void StartTimer();
+    /// Stop the clock
+    void StopTimer();
+
+    /// Number of items (photons, rows, hits...) processed per iteration.
+    /// Used to report a throughput besides the time per iteration.
+    void SetItemsPerIteration(G4double);
+    G4double GetItemsPerIteration() const;
+
+    /// Elapsed time (in ns) between StartTimer and StopTimer calls
+    G4double GetElapsedTime() const;
+
+    /// Additional quantity measured by the benchmark (e.g. memory),
+    /// reported together with the times
+    void SetCounter(const G4String& name, G4double value);
+    const std::map<G4String, G4double>& GetCounters() const;
+
+  private:
+    G4long iterations_;
+    G4double items_per_iteration_;
+    std::map<G4String, G4double> counters_;
+    G4double elapsed_;
+    std::chrono::steady_clock::time_point start_;
+  };
+
+
+  typedef std::function<void(BenchmarkState&)> BenchmarkFunction;
+
+  struct BenchmarkEntry
+  {
+    G4String name;
+    G4long iterations;
+    BenchmarkFunction function;
+  };
+
+
+  class BenchmarkRegistry
+  {
+  public:
+    /// Add a benchmark to the list. Returns true so that it can
+    /// be used to initialize a static variable.
+    static G4bool Add(const G4String& name, G4long iterations,
+                      BenchmarkFunction function);
+    /// Return the list of registered benchmarks
+    static std::vector<BenchmarkEntry>& Get();
+
+  private:
+    BenchmarkRegistry();
+  };
+
+
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline BenchmarkState::BenchmarkState(G4long iterations):
+    iterations_(iterations), items_per_iteration_(1.), elapsed_(0.) {}
+
+  inline G4long BenchmarkState::Iterations() const { return iterations_; }
+
+  inline void BenchmarkState::StartTimer()
+  { start_ = std::chrono::steady_clock::now(); }
+
+  inline void BenchmarkState::StopTimer()
+  {
+    std::chrono::duration<G4double, std::nano> dt =
+      std::chrono::steady_clock::now() - start_;
+    elapsed_ += dt.count();
+  }
+
+  inline void BenchmarkState::SetItemsPerIteration(G4double n)
+  { items_per_iteration_ = n; }
+
+  inline G4double BenchmarkState::GetItemsPerIteration() const
+  { return items_per_iteration_; }
+
+  inline G4double BenchmarkState::GetElapsedTime() const { return elapsed_; }
+
+  inline void BenchmarkState::SetCounter(const G4String& name, G4double value)
+  { counters_[name] = value; }
+
+  inline const std::map<G4String, G4double>& BenchmarkState::GetCounters() const
+  { return counters_; }
+
+} // namespace nexus
+
+
+/// Register a benchmark function with the given name and number
+/// of iterations of its timed loop
+#define NEXUS_BENCHMARK(NAME, ITERATIONS)                                  \
+  static void NAME(nexus::BenchmarkState&);                                \
+  [[maybe_unused]] static G4bool NAME##_registered =                       \
+    nexus::BenchmarkRegistry::Add(#NAME, ITERATIONS, NAME);                \
+  static void NAME(nexus::BenchmarkState& state)
+
+#endif
@@ -0,0 +1,70 @@
+// ----------------------------------------------------------------------------
+// nexus | ELLookupTableBench.cc
+//
+// Benchmark of the lookup of the EL light table.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "Benchmark.h"
+
+#include "ELLookupTable.h"
+
+#include <G4SystemOfUnits.hh>
+#include <G4PhysicalConstants.hh>
+#include <Randomize.hh>
+
+#include <fstream>
+#include <cstdio>
+
+using namespace nexus;
+
+
+namespace {
+
+  const G4String table_file = "nexus-bench-eltable.dat";
+
+  // The lookup assumes a circular grid of 5 mm pitch and 92.5 mm radius,
+  // which has at most 38x38 points
+  const G4int num_points  = 38*38;
+  const G4int num_sensors = 64;
+  const G4double radius   = 92.5 * mm;
+
+  void WriteSyntheticTable()
+  {
+    std::ofstream file(table_file);
+    file << "* Synthetic EL light table for nexus-bench\n";
+    file << "point_id sensor_id p0 p1 p2 p3 p4\n";
+    for (G4int p=0; p<num_points; ++p)
+      for (G4int s=0; s<num_sensors; s+=16)
+        file << p << " " << s + p%16
+             << " 0.01 0.02 0.03 0.02 0.01\n";
+  }
+
+}
+
+
+NEXUS_BENCHMARK(ELLookupTable_GetSensorsMap, 100000)
+{
+  WriteSyntheticTable();
+  ELLookupTable table(table_file);
+  std::remove(table_file.c_str());
+
+  // Random points uniformly distributed in the circle covered by the table
+  std::vector<G4ThreeVector> points(state.Iterations());
+  for (auto& p: points) {
+    G4double r   = radius * std::sqrt(G4UniformRand());
+    G4double phi = twopi * G4UniformRand();
+    p = G4ThreeVector(r*std::cos(phi), r*std::sin(phi), 0.);
+  }
+
+  size_t entries = 0;
+
+  state.StartTimer();
+  for (G4long i=0; i<state.Iterations(); ++i)
+    entries += table.GetSensorsMap(points[i]).size();
+  state.StopTimer();
+
+  if (entries == 0)
+    G4cerr << "[ELLookupTableBench] Empty sensor maps returned." << G4endl;
+}
@@ -0,0 +1,296 @@
+// ----------------------------------------------------------------------------
+// nexus | GeometryBench.cc
+//
+// Benchmarks of the navigation in the tracking plane masks: a teflon disk
+// with one hole per SiPM, built either as a boolean subtraction of all the
+// holes or with the holes as gas daughter volumes. The NEXT-Flex tracking
+// plane is also built with its SiPMs (and mask holes) placed one by one or
+// with a parameterised volume, to compare build time, memory and navigation.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "Benchmark.h"
+
+#include "NextFlexTrackingPlane.h"
+
+#include <G4Box.hh>
+#include <G4Tubs.hh>
+#include <G4MultiUnion.hh>
+#include <G4SubtractionSolid.hh>
+#include <G4LogicalVolume.hh>
+#include <G4PVPlacement.hh>
+#include <G4NistManager.hh>
+#include <G4Navigator.hh>
+#include <G4GeometryManager.hh>
+#include <G4UImanager.hh>
+#include <G4SystemOfUnits.hh>
+#include <G4PhysicalConstants.hh>
+#include <Randomize.hh>
+
+#include <fstream>
+#include <unistd.h>
+
+using namespace nexus;
+
+
+namespace {
+
+  // Dimensions of the NEXT-Flex tracking plane mask
+  const G4double mask_diam  = 980. * mm;
+  const G4double mask_thick =   5. * mm;
+  const G4double hole_diam  =   7. * mm;
+  const G4double pitch      =  15.6 * mm;
+
+  /// Builds a world with the mask and returns the world volume
+  G4VPhysicalVolume* BuildMask(const G4String& name, G4bool daughter_holes)
+  {
+    G4Material* gas    = G4NistManager::Instance()->FindOrBuildMaterial("G4_Xe");
+    G4Material* teflon = G4NistManager::Instance()->FindOrBuildMaterial("G4_TEFLON");
+
+    G4Box* world_solid = new G4Box(name, 1.*m, 1.*m, 1.*m);
+    G4LogicalVolume* world_logic = new G4LogicalVolume(world_solid, gas, name);
+    G4VPhysicalVolume* world_phys =
+      new G4PVPlacement(0, G4ThreeVector(), world_logic, name, 0, false, 0);
+
+    std::vector<G4ThreeVector> positions;
+    G4int n = (G4int) (mask_diam / pitch);
+    for (G4int i=0; i<n; ++i) {
+      for (G4int j=0; j<n; ++j) {
+        G4ThreeVector pos((i - n/2) * pitch, (j - n/2) * pitch, 0.);
+        if (pos.perp() < mask_diam/2. - hole_diam) positions.push_back(pos);
+      }
+    }
+
+    G4Tubs* disk_solid =
+      new G4Tubs(name + "_MASK", 0., mask_diam/2., mask_thick/2., 0., twopi);
+    G4VSolid* mask_solid = disk_solid;
+
+    if (!daughter_holes) {
+      G4Tubs* hole_solid =
+        new G4Tubs(name + "_HOLE", 0., hole_diam/2., mask_thick/2. + 0.5*mm, 0., twopi);
+      G4MultiUnion* holes_solid = new G4MultiUnion(name + "_HOLES");
+      for (auto& pos: positions)
+        holes_solid->AddNode(*hole_solid, G4Transform3D(G4RotationMatrix(), pos));
+      holes_solid->Voxelize();
+      mask_solid = new G4SubtractionSolid(name + "_MASK", disk_solid, holes_solid);
+    }
+
+    G4LogicalVolume* mask_logic =
+      new G4LogicalVolume(mask_solid, teflon, name + "_MASK");
+    new G4PVPlacement(0, G4ThreeVector(), mask_logic, name + "_MASK",
+                      world_logic, false, 0);
+
+    if (daughter_holes) {
+      G4Tubs* hole_solid =
+        new G4Tubs(name + "_HOLE", 0., hole_diam/2., mask_thick/2., 0., twopi);
+      G4LogicalVolume* hole_logic =
+        new G4LogicalVolume(hole_solid, gas, name + "_HOLE");
+      for (size_t i=0; i<positions.size(); ++i)
+        new G4PVPlacement(0, positions[i], hole_logic, name + "_HOLE",
+                          mask_logic, false, i);
+    }
+
+    return world_phys;
+  }
+
+
+  /// Build the smart voxels of a world, as done at the start of a run,
+  /// so that the navigation does not loop over all the daughters
+  void Voxelize(G4VPhysicalVolume* world)
+  {
+    G4GeometryManager* manager = G4GeometryManager::GetInstance();
+    manager->OpenGeometry(world);
+    manager->CloseGeometry(true, false, world);
+  }
+
+
+  /// Time the steps of photons travelling from above the mask
+  /// towards it, as optical photons do near the tracking plane
+  void NavigateMask(BenchmarkState& state, G4VPhysicalVolume* world)
+  {
+    Voxelize(world);
+    G4Navigator navigator;
+    navigator.SetWorldVolume(world);
+
+    std::vector<G4ThreeVector> points(state.Iterations());
+    std::vector<G4ThreeVector> directions(state.Iterations());
+    for (G4long i=0; i<state.Iterations(); ++i) {
+      G4double r   = (mask_diam/2. - 10.*mm) * std::sqrt(G4UniformRand());
+      G4double phi = twopi * G4UniformRand();
+      points[i] = G4ThreeVector(r*std::cos(phi), r*std::sin(phi), mask_thick);
+      G4double cost = -G4UniformRand();
+      G4double sint = std::sqrt(1. - cost*cost);
+      G4double psi  = twopi * G4UniformRand();
+      directions[i] = G4ThreeVector(sint*std::cos(psi), sint*std::sin(psi), cost);
+    }
+
+    G4double steps = 0.;
+
+    state.StartTimer();
+    for (G4long i=0; i<state.Iterations(); ++i) {
+      G4ThreeVector point = points[i];
+      G4double safety;
+      // Follow the photon through the mask until it leaves it
+      for (G4int s=0; s<4; ++s) {
+        navigator.LocateGlobalPointAndSetup(point, &directions[i], s > 0, false);
+        G4double step = navigator.ComputeStep(point, directions[i], kInfinity, safety);
+        if (step == kInfinity) break;
+        point += step * directions[i];
+        steps += 1.;
+        navigator.SetGeometricallyLimitedStep();
+        if (std::abs(point.z()) > mask_thick) break;
+      }
+    }
+    state.StopTimer();
+
+    state.SetItemsPerIteration(steps / state.Iterations());
+  }
+
+
+  /// Resident memory of the process in MB (0 if unknown)
+  G4double ResidentMemory()
+  {
+    std::ifstream statm("/proc/self/statm");
+    G4double size = 0., resident = 0.;
+    if (!(statm >> size >> resident)) return 0.;
+    return resident * sysconf(_SC_PAGESIZE) / (1024. * 1024.);
+  }
+
+
+  /// Builds a world with the NEXT-Flex tracking plane, with the mask
+  /// holes as daughter volumes, and returns the world volume. If a
+  /// state is given, the construction of the plane is timed and the
+  /// memory it takes is added to the counters.
+  G4VPhysicalVolume* BuildTrackingPlane(const G4String& name, G4bool parameterised,
+                                        BenchmarkState* state=nullptr)
+  {
+    G4Material* gas = G4NistManager::Instance()->FindOrBuildMaterial("G4_Xe");
+
+    G4Box* world_solid = new G4Box(name, 1.*m, 1.*m, 1.*m);
+    G4LogicalVolume* world_logic = new G4LogicalVolume(world_solid, gas, name);
+    G4VPhysicalVolume* world_phys =
+      new G4PVPlacement(0, G4ThreeVector(), world_logic, name, 0, false, 0);
+
+    // The plane is configured through its own commands, which are
+    // removed when it is deleted so that it can be built again
+    NextFlexTrackingPlane* plane = new NextFlexTrackingPlane();
+    G4UImanager* ui = G4UImanager::GetUIpointer();
+    ui->ApplyCommand("/Geometry/NextFlex/tp_teflon_daughter_holes true");
+    ui->ApplyCommand(G4String("/Geometry/NextFlex/tp_sipm_parameterised ") +
+                     (parameterised ? "true" : "false"));
+
+    plane->SetMotherLogicalVolume(world_logic);
+    plane->SetNeighGasPhysicalVolume(world_phys);
+    plane->SetDiameter(mask_diam);
+    plane->SetOriginZ(0.);
+
+    G4double memory = ResidentMemory();
+    if (state) state->StartTimer();
+    plane->Construct();
+    if (state) {
+      state->StopTimer();
+      state->SetCounter("memory_mb", ResidentMemory() - memory);
+    }
+
+    delete plane;
+
+    return world_phys;
+  }
+
+
+  /// Time the steps of photons travelling from the EL gap towards
+  /// the tracking plane, until they reach its copper plate
+  void NavigateTrackingPlane(BenchmarkState& state, G4VPhysicalVolume* world)
+  {
+    Voxelize(world);
+    G4Navigator navigator;
+    navigator.SetWorldVolume(world);
+
+    std::vector<G4ThreeVector> points(state.Iterations());
+    std::vector<G4ThreeVector> directions(state.Iterations());
+    for (G4long i=0; i<state.Iterations(); ++i) {
+      G4double r   = (mask_diam/2. - 10.*mm) * std::sqrt(G4UniformRand());
+      G4double phi = twopi * G4UniformRand();
+      points[i] = G4ThreeVector(r*std::cos(phi), r*std::sin(phi), 0.);
+      G4double cost = -G4UniformRand();
+      G4double sint = std::sqrt(1. - cost*cost);
+      G4double psi  = twopi * G4UniformRand();
+      directions[i] = G4ThreeVector(sint*std::cos(psi), sint*std::sin(psi), cost);
+    }
+
+    G4double steps = 0.;
+
+    state.StartTimer();
+    for (G4long i=0; i<state.Iterations(); ++i) {
+      G4ThreeVector point = points[i];
+      G4double safety;
+      for (G4int s=0; s<8; ++s) {
+        G4VPhysicalVolume* volume =
+          navigator.LocateGlobalPointAndSetup(point, &directions[i], s > 0, false);
+        if (!volume || volume->GetName() == "TP_COPPER") break;
+        G4double step = navigator.ComputeStep(point, directions[i], kInfinity, safety);
+        if (step == kInfinity) break;
+        point += step * directions[i];
+        steps += 1.;
+        navigator.SetGeometricallyLimitedStep();
+      }
+    }
+    state.StopTimer();
+
+    state.SetItemsPerIteration(steps / state.Iterations());
+  }
+
+
+  /// Time the construction of the tracking plane. Every
+  /// repetition builds a new one in its own world.
+  void TimeTrackingPlaneBuild(BenchmarkState& state, G4bool parameterised)
+  {
+    static G4int builds = 0;
+    for (G4long i=0; i<state.Iterations(); ++i) {
+      G4String name = "BENCH_TP_BUILD_" + std::to_string(builds++);
+      BuildTrackingPlane(name, parameterised, &state);
+    }
+  }
+
+}
+
+
+NEXUS_BENCHMARK(Navigation_MaskBooleanHoles, 10000)
+{
+  static G4VPhysicalVolume* world = BuildMask("BENCH_BOOLEAN", false);
+  NavigateMask(state, world);
+}
+
+
+NEXUS_BENCHMARK(Navigation_MaskDaughterHoles, 10000)
+{
+  static G4VPhysicalVolume* world = BuildMask("BENCH_DAUGHTER", true);
+  NavigateMask(state, world);
+}
+
+
+NEXUS_BENCHMARK(Geometry_TrackingPlaneBuildPlacements, 1)
+{
+  TimeTrackingPlaneBuild(state, false);
+}
+
+
+NEXUS_BENCHMARK(Geometry_TrackingPlaneBuildParameterised, 1)
+{
+  TimeTrackingPlaneBuild(state, true);
+}
+
+
+NEXUS_BENCHMARK(Navigation_TrackingPlanePlacements, 10000)
+{
+  static G4VPhysicalVolume* world = BuildTrackingPlane("BENCH_TP_PLACEMENTS", false);
+  NavigateTrackingPlane(state, world);
+}
+
+
+NEXUS_BENCHMARK(Navigation_TrackingPlaneParameterised, 10000)
+{
+  static G4VPhysicalVolume* world = BuildTrackingPlane("BENCH_TP_PARAMETERISED", true);
+  NavigateTrackingPlane(state, world);
+}
@@ -0,0 +1,81 @@
+// ----------------------------------------------------------------------------
+// nexus | HDF5WriterBench.cc
+//
+// Benchmarks of the row throughput of the HDF5 output writer.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "Benchmark.h"
+
+#include "HDF5Writer.h"
+
+#include <cstdio>
+
+using namespace nexus;
+
+
+namespace {
+
+  const G4String scratch_file = "nexus-bench-hdf5.h5";
+  const G4int rows_per_iteration = 1000;
+
+}
+
+
+NEXUS_BENCHMARK(HDF5Writer_HitRows, 100)
+{
+  HDF5Writer writer;
+  writer.Open(scratch_file, false);
+
+  state.SetItemsPerIteration(rows_per_iteration);
+
+  state.StartTimer();
+  for (G4long evt=0; evt<state.Iterations(); ++evt)
+    for (G4int i=0; i<rows_per_iteration; ++i)
+      writer.WriteHitInfo(evt, 1, i, 1.*i, 2.*i, 3.*i, 0.5*i, 0.01, "ACTIVE");
+  state.StopTimer();
+
+  writer.Close();
+  std::remove(scratch_file.c_str());
+}
+
+
+NEXUS_BENCHMARK(HDF5Writer_SensorDataRows, 100)
+{
+  HDF5Writer writer;
+  writer.Open(scratch_file, false);
+
+  state.SetItemsPerIteration(rows_per_iteration);
+
+  state.StartTimer();
+  for (G4long evt=0; evt<state.Iterations(); ++evt)
+    for (G4int i=0; i<rows_per_iteration; ++i)
+      writer.WriteSensorDataInfo(evt, 1000 + i%64, i, 1);
+  state.StopTimer();
+
+  writer.Close();
+  std::remove(scratch_file.c_str());
+}
+
+
+NEXUS_BENCHMARK(HDF5Writer_ParticleRows, 100)
+{
+  HDF5Writer writer;
+  writer.Open(scratch_file, false);
+
+  state.SetItemsPerIteration(rows_per_iteration);
+
+  state.StartTimer();
+  for (G4long evt=0; evt<state.Iterations(); ++evt)
+    for (G4int i=0; i<rows_per_iteration; ++i)
+      writer.WriteParticleInfo(evt, i+1, "e-", 0, i,
+                               0., 0., 0., 0., 1., 1., 1., 1.,
+                               "ACTIVE", "ACTIVE",
+                               0., 0., 1., 0., 0., 0.,
+                               1., 1., "eIoni", "eIoni");
+  state.StopTimer();
+
+  writer.Close();
+  std::remove(scratch_file.c_str());
+}
@@ -0,0 +1,36 @@
+// ----------------------------------------------------------------------------
+// nexus | MaterialsBench.cc
+//
+// Benchmarks of the construction of optical property tables.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "Benchmark.h"
+
+#include "OpticalMaterialProperties.h"
+
+#include <G4MaterialPropertiesTable.hh>
+#include <G4SystemOfUnits.hh>
+
+using namespace nexus;
+
+
+NEXUS_BENCHMARK(OpticalProperties_GXe, 1000)
+{
+  // Geometries request the table of the gas many times with
+  // the same parameters, which are served from the cache
+  state.StartTimer();
+  for (G4long i=0; i<state.Iterations(); ++i)
+    delete opticalprops::GXe(15.*bar, 303.*kelvin);
+  state.StopTimer();
+}
+
+
+NEXUS_BENCHMARK(OpticalProperties_TPB, 1000)
+{
+  state.StartTimer();
+  for (G4long i=0; i<state.Iterations(); ++i)
+    delete opticalprops::TPB();
+  state.StopTimer();
+}
@@ -0,0 +1,182 @@
+// ----------------------------------------------------------------------------
+// nexus | PhysicsBench.cc
+//
+// Benchmarks of the nexus physics processes that generate large numbers
+// of secondaries: electroluminescence and ionization clustering.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "Benchmark.h"
+
+#include "Electroluminescence.h"
+#include "IonizationClustering.h"
+#include "IonizationElectron.h"
+#include "UniformElectricDriftField.h"
+#include "MaterialsList.h"
+#include "OpticalMaterialProperties.h"
+#include "XenonProperties.h"
+
+#include <G4Box.hh>
+#include <G4LogicalVolume.hh>
+#include <G4PVPlacement.hh>
+#include <G4Region.hh>
+#include <G4Navigator.hh>
+#include <G4TouchableHistory.hh>
+#include <G4Electron.hh>
+#include <G4Step.hh>
+#include <G4Track.hh>
+#include <G4DynamicParticle.hh>
+#include <G4VParticleChange.hh>
+#include <G4SystemOfUnits.hh>
+
+using namespace nexus;
+
+
+namespace {
+
+  const G4double pressure = 15. * bar;
+  const G4double gap_length = 10. * mm;
+
+  /// Builds a xenon gas box with a uniform EL field attached to its region
+  /// and returns a touchable located inside it. The processes find the
+  /// field and the material through the touchable, as they do in a run.
+  G4TouchableHandle BuildGasGap()
+  {
+    G4Material* gxe = materials::GXe(pressure, 303. * kelvin);
+    gxe->SetMaterialPropertiesTable(opticalprops::GXe(pressure, 303. * kelvin));
+
+    G4Box* world_solid = new G4Box("BENCH_GAS_WORLD", 1.*m, 1.*m, 1.*m);
+    G4LogicalVolume* world_logic =
+      new G4LogicalVolume(world_solid, gxe, "BENCH_GAS_WORLD");
+    G4VPhysicalVolume* world_phys =
+      new G4PVPlacement(0, G4ThreeVector(), world_logic, "BENCH_GAS_WORLD",
+                        0, false, 0);
+
+    G4Box* gap_solid =
+      new G4Box("BENCH_EL_GAP", 50.*cm, 50.*cm, gap_length/2.);
+    G4LogicalVolume* gap_logic =
+      new G4LogicalVolume(gap_solid, gxe, "BENCH_EL_GAP");
+    new G4PVPlacement(0, G4ThreeVector(), gap_logic, "BENCH_EL_GAP",
+                      world_logic, false, 0);
+
+    UniformElectricDriftField* field = new UniformElectricDriftField();
+    field->SetCathodePosition( gap_length/2.);
+    field->SetAnodePosition  (-gap_length/2.);
+    field->SetDriftVelocity(2.5 * mm/microsecond);
+    field->SetTransverseDiffusion(0.);
+    field->SetLongitudinalDiffusion(0.);
+    field->SetLightYield(XenonELLightYield(34.5*kilovolt/cm, pressure));
+    G4Region* region = new G4Region("BENCH_EL_REGION");
+    region->SetUserInformation(field);
+    region->AddRootLogicalVolume(gap_logic);
+
+    G4Navigator navigator;
+    navigator.SetWorldVolume(world_phys);
+    navigator.LocateGlobalPointAndSetup(G4ThreeVector(), 0, false, true);
+    return G4TouchableHandle(navigator.CreateTouchableHistory());
+  }
+
+
+  G4TouchableHandle GasGap()
+  {
+    static G4TouchableHandle touchable = BuildGasGap();
+    return touchable;
+  }
+
+
+  /// Fake a step of the given track from z_start to z_end inside the gap
+  void SetStep(G4Step& step, G4Track* track, G4TouchableHandle touchable,
+               G4double z_start, G4double z_end)
+  {
+    track->SetTouchableHandle(touchable);
+    step.SetTrack(track);
+
+    G4StepPoint* pre  = step.GetPreStepPoint();
+    G4StepPoint* post = step.GetPostStepPoint();
+    pre->SetTouchableHandle(touchable);
+    post->SetTouchableHandle(touchable);
+    pre->SetPosition(G4ThreeVector(0., 0., z_start));
+    post->SetPosition(G4ThreeVector(0., 0., z_end));
+    pre->SetGlobalTime(0.);
+    post->SetGlobalTime(std::abs(z_end - z_start) / (2.5 * mm/microsecond));
+    step.SetStepLength(std::abs(z_end - z_start));
+  }
+
+
+  /// Delete the secondaries created by a process so that they
+  /// do not accumulate between iterations
+  void ClearSecondaries(G4VParticleChange* change)
+  {
+    for (G4int i=0; i<change->GetNumberOfSecondaries(); ++i)
+      delete change->GetSecondary(i);
+    change->Clear();
+  }
+
+}
+
+
+NEXUS_BENCHMARK(Electroluminescence_PostStepDoIt, 100)
+{
+  G4TouchableHandle touchable = GasGap();
+
+  // The process builds its tables from the material table
+  // and owns a messenger, so it must be created only once
+  static Electroluminescence* el = [] {
+    Electroluminescence* process = new Electroluminescence();
+    process->BuildPhysicsTable(*IonizationElectron::Definition());
+    return process;
+  }();
+
+  G4Track* track =
+    new G4Track(new G4DynamicParticle(IonizationElectron::Definition(),
+                                      G4ThreeVector(0., 0., -1.), 1.*eV),
+                0., G4ThreeVector(0., 0., gap_length/2.));
+  G4Step step;
+  SetStep(step, track, touchable, gap_length/2., -gap_length/2.);
+
+  G4double photons = 0.;
+
+  state.StartTimer();
+  for (G4long i=0; i<state.Iterations(); ++i) {
+    G4VParticleChange* change = el->PostStepDoIt(*track, step);
+    photons += change->GetNumberOfSecondaries();
+    ClearSecondaries(change);
+  }
+  state.StopTimer();
+
+  state.SetItemsPerIteration(photons / state.Iterations());
+
+  delete track;
+}
+
+
+NEXUS_BENCHMARK(IonizationClustering_PostStepDoIt, 1000)
+{
+  G4TouchableHandle touchable = GasGap();
+
+  static IonizationClustering* clustering = new IonizationClustering();
+
+  // A 1 mm step of an electron depositing 10 keV
+  G4Track* track =
+    new G4Track(new G4DynamicParticle(G4Electron::Definition(),
+                                      G4ThreeVector(0., 0., 1.), 1.*MeV),
+                0., G4ThreeVector());
+  G4Step step;
+  SetStep(step, track, touchable, 0., 1.*mm);
+  step.SetTotalEnergyDeposit(10.*keV);
+
+  G4double charges = 0.;
+
+  state.StartTimer();
+  for (G4long i=0; i<state.Iterations(); ++i) {
+    G4VParticleChange* change = clustering->PostStepDoIt(*track, step);
+    charges += change->GetNumberOfSecondaries();
+    ClearSecondaries(change);
+  }
+  state.StopTimer();
+
+  state.SetItemsPerIteration(charges / state.Iterations());
+
+  delete track;
+}
@@ -0,0 +1,85 @@
+// ----------------------------------------------------------------------------
+// nexus | PointSamplerBench.cc
+//
+// Benchmarks of the random point samplers used by the geometries
+// to generate vertices.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "Benchmark.h"
+
+#include "CylinderPointSampler2020.h"
+#include "HexagonPointSampler.h"
+#include "BoxPointSampler.h"
+#include "SpherePointSampler.h"
+
+#include <G4ThreeVector.hh>
+#include <G4SystemOfUnits.hh>
+#include <G4PhysicalConstants.hh>
+
+using namespace nexus;
+
+
+namespace {
+
+  // Accumulate the generated points so that the compiler
+  // cannot optimize the sampling away
+  G4ThreeVector sink;
+
+}
+
+
+NEXUS_BENCHMARK(CylinderPointSampler2020_Volume, 1000000)
+{
+  CylinderPointSampler2020 sampler(0., 500.*mm, 600.*mm, 0., twopi);
+
+  state.StartTimer();
+  for (G4long i=0; i<state.Iterations(); ++i)
+    sink += sampler.GenerateVertex("VOLUME");
+  state.StopTimer();
+}
+
+
+NEXUS_BENCHMARK(CylinderPointSampler2020_InnerSurface, 1000000)
+{
+  CylinderPointSampler2020 sampler(480.*mm, 500.*mm, 600.*mm, 0., twopi);
+
+  state.StartTimer();
+  for (G4long i=0; i<state.Iterations(); ++i)
+    sink += sampler.GenerateVertex("INNER_SURFACE");
+  state.StopTimer();
+}
+
+
+NEXUS_BENCHMARK(HexagonPointSampler_Inside, 1000000)
+{
+  HexagonPointSampler sampler(500.*mm, 600.*mm, 5.*mm);
+
+  state.StartTimer();
+  for (G4long i=0; i<state.Iterations(); ++i)
+    sink += sampler.GenerateVertex(INSIDE);
+  state.StopTimer();
+}
+
+
+NEXUS_BENCHMARK(BoxPointSampler_WholeVol, 1000000)
+{
+  BoxPointSampler sampler(400.*mm, 500.*mm, 600.*mm, 10.*mm);
+
+  state.StartTimer();
+  for (G4long i=0; i<state.Iterations(); ++i)
+    sink += sampler.GenerateVertex("WHOLE_VOL");
+  state.StopTimer();
+}
+
+
+NEXUS_BENCHMARK(SpherePointSampler_Volume, 1000000)
+{
+  SpherePointSampler sampler(0., 500.*mm);
+
+  state.StartTimer();
+  for (G4long i=0; i<state.Iterations(); ++i)
+    sink += sampler.GenerateVertex("VOLUME");
+  state.StopTimer();
+}
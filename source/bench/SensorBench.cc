@@ -0,0 +1,167 @@
+// ----------------------------------------------------------------------------
+// nexus | SensorBench.cc
+//
+// Benchmarks of the photosensor sensitive detector and hits with
+// synthetic streams of optical photons.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "Benchmark.h"
+
+#include "SensorSD.h"
+#include "SensorHit.h"
+
+#include <G4Box.hh>
+#include <G4LogicalVolume.hh>
+#include <G4PVPlacement.hh>
+#include <G4NistManager.hh>
+#include <G4Navigator.hh>
+#include <G4TouchableHistory.hh>
+#include <G4SDManager.hh>
+#include <G4HCofThisEvent.hh>
+#include <G4OpticalPhoton.hh>
+#include <G4Step.hh>
+#include <G4Track.hh>
+#include <G4DynamicParticle.hh>
+#include <G4SystemOfUnits.hh>
+#include <Randomize.hh>
+
+using namespace nexus;
+
+
+namespace {
+
+  const G4int    nrows = 8;          // sensors per board row
+  const G4double pitch = 10. * mm;   // distance between sensors
+  const G4int    photons_per_event = 10000;
+
+  /// Builds a board of nrows x nrows sensors with a SensorSD attached
+  /// and returns a touchable for each one of them, so that steps
+  /// can be faked as if they ended on a sensor.
+  std::vector<G4TouchableHandle> BuildSensorBoard(SensorSD* sd)
+  {
+    G4Material* vacuum =
+      G4NistManager::Instance()->FindOrBuildMaterial("G4_Galactic");
+
+    G4Box* world_solid = new G4Box("BENCH_WORLD", 1.*m, 1.*m, 1.*m);
+    G4LogicalVolume* world_logic =
+      new G4LogicalVolume(world_solid, vacuum, "BENCH_WORLD");
+    G4VPhysicalVolume* world_phys =
+      new G4PVPlacement(0, G4ThreeVector(), world_logic, "BENCH_WORLD",
+                        0, false, 0);
+
+    G4double board_size = nrows * pitch;
+    G4Box* board_solid =
+      new G4Box("BENCH_BOARD", board_size/2., board_size/2., 1.*mm);
+    G4LogicalVolume* board_logic =
+      new G4LogicalVolume(board_solid, vacuum, "BENCH_BOARD");
+    new G4PVPlacement(0, G4ThreeVector(), board_logic, "BENCH_BOARD",
+                      world_logic, false, 7);
+
+    G4Box* sensor_solid =
+      new G4Box("BENCH_SENSOR", pitch/4., pitch/4., 0.5*mm);
+    G4LogicalVolume* sensor_logic =
+      new G4LogicalVolume(sensor_solid, vacuum, "BENCH_SENSOR");
+    sensor_logic->SetSensitiveDetector(sd);
+
+    std::vector<G4ThreeVector> positions;
+    for (G4int i=0; i<nrows; ++i) {
+      for (G4int j=0; j<nrows; ++j) {
+        G4ThreeVector pos(-board_size/2. + (i+.5)*pitch,
+                          -board_size/2. + (j+.5)*pitch, 0.);
+        new G4PVPlacement(0, pos, sensor_logic, "BENCH_SENSOR",
+                          board_logic, false, i*nrows + j);
+        positions.push_back(pos);
+      }
+    }
+
+    G4Navigator navigator;
+    navigator.SetWorldVolume(world_phys);
+
+    std::vector<G4TouchableHandle> touchables;
+    for (auto& pos: positions) {
+      navigator.LocateGlobalPointAndSetup(pos, 0, false, true);
+      touchables.push_back(G4TouchableHandle(navigator.CreateTouchableHistory()));
+    }
+
+    return touchables;
+  }
+
+}
+
+
+NEXUS_BENCHMARK(SensorSD_ProcessHits, 100)
+{
+  // The detector and its geometry can be registered only once
+  // per process, so they are shared by all repetitions
+  static SensorSD* sd = nullptr;
+  static std::vector<G4TouchableHandle> touchables;
+
+  if (!sd) {
+    sd = new SensorSD("/BENCH/SENSOR");
+    sd->SetDetectorVolumeDepth(0);
+    sd->SetMotherVolumeDepth(1);
+    sd->SetDetectorNamingOrder(1000);
+    sd->SetTimeBinning(1.*microsecond);
+    G4SDManager::GetSDMpointer()->AddNewDetector(sd);
+    touchables = BuildSensorBoard(sd);
+  }
+
+  // Synthetic photon stream: random sensor and an exponential
+  // arrival time, generated before the timed loop
+  std::vector<G4int> sensor_idx(photons_per_event);
+  std::vector<G4double> arrival_time(photons_per_event);
+  for (G4int i=0; i<photons_per_event; ++i) {
+    sensor_idx[i] = G4int(G4UniformRand() * touchables.size());
+    arrival_time[i] = G4RandExponential::shoot(20.*microsecond);
+  }
+
+  G4Step step;
+  G4Track* track =
+    new G4Track(new G4DynamicParticle(G4OpticalPhoton::Definition(),
+                                      G4ThreeVector(0., 0., 1.), 7.*eV),
+                0., G4ThreeVector());
+  step.SetTrack(track);
+  G4StepPoint* post_point = step.GetPostStepPoint();
+
+  state.SetItemsPerIteration(photons_per_event);
+
+  state.StartTimer();
+  for (G4long evt=0; evt<state.Iterations(); ++evt) {
+    G4HCofThisEvent* hce =
+      new G4HCofThisEvent(G4SDManager::GetSDMpointer()->GetCollectionCapacity());
+    sd->Initialize(hce);
+
+    for (G4int i=0; i<photons_per_event; ++i) {
+      post_point->SetTouchableHandle(touchables[sensor_idx[i]]);
+      post_point->SetGlobalTime(arrival_time[i]);
+      sd->Hit(&step);
+    }
+
+    sd->EndOfEvent(hce);
+    delete hce;
+  }
+  state.StopTimer();
+
+  delete track;
+}
+
+
+NEXUS_BENCHMARK(SensorHit_Fill, 1000)
+{
+  std::vector<G4double> arrival_time(photons_per_event);
+  for (G4int i=0; i<photons_per_event; ++i)
+    arrival_time[i] = G4RandExponential::shoot(20.*microsecond);
+
+  state.SetItemsPerIteration(photons_per_event);
+
+  state.StartTimer();
+  for (G4long evt=0; evt<state.Iterations(); ++evt) {
+    SensorHit* hit = new SensorHit(0, G4ThreeVector(), 1.*microsecond);
+    for (G4int i=0; i<photons_per_event; ++i)
+      hit->Fill(arrival_time[i]);
+    delete hit;
+  }
+  state.StopTimer();
+}
@@ -11,8 +11,8 @@
 
 using namespace nexus;
 
-AddUserInfoToPV::AddUserInfoToPV(G4double zenith, G4double azimuth):
-  zenith_(zenith),azimuth_(azimuth)
+AddUserInfoToPV::AddUserInfoToPV(G4double zenith, G4double azimuth, G4double weight):
+  zenith_(zenith),azimuth_(azimuth),weight_(weight)
 {
 }
 
@@ -19,24 +19,28 @@ namespace nexus {
   {
   public:
     //constructor
-    AddUserInfoToPV(G4double theta,G4double phi);
+    AddUserInfoToPV(G4double theta,G4double phi,G4double weight=1.);
     //destructor
     ~AddUserInfoToPV();
 
     void Print() const;
     G4double GetZenith();
     G4double GetAzimuth();
+    G4double GetWeight();
 
   private:
 
     G4double zenith_;
     G4double azimuth_;
+    G4double weight_;
   };
 
   inline G4double AddUserInfoToPV::GetZenith()
   { return zenith_; }
   inline G4double AddUserInfoToPV::GetAzimuth()
   { return azimuth_; }
+  inline G4double AddUserInfoToPV::GetWeight()
+  { return weight_; }
 
 } // end namespace nexus
 
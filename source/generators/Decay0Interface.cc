@@ -16,6 +16,7 @@
 #include "DetectorConstruction.h"
 #include "GeometryBase.h"
 #include "FactoryBase.h"
+#include "GenbbFileReader.h"
 
 #include <G4GenericMessenger.hh>
 #include <G4RunManager.hh>
@@ -23,25 +24,48 @@
 #include <G4ParticleDefinition.hh>
 #include "decay0.h"
 #include <iostream>
+#include <sstream>
 using namespace nexus;
 
 REGISTER_CLASS(Decay0Interface, G4VPrimaryGenerator)
 
 
 Decay0Interface::Decay0Interface():
-  G4VPrimaryGenerator(), msg_(0), opened_(false), geom_(0)
+  G4VPrimaryGenerator(), msg_(0), reader_(0), first_event_(0), seeked_(false),
+  opened_(false), geom_(0)
 {
 
   msg_ = new G4GenericMessenger(this, "/Generator/Decay0Interface/",
     "Control commands of the Decay0 interface.");
 
   msg_->DeclareMethod("inputFile", &Decay0Interface::OpenInputFile, "");
+  G4GenericMessenger::Command& first_cmd =
+    msg_->DeclareProperty("firstEvent", first_event_,
+                          "Index of the first event read from the input file (e.g. the start_id of the job).");
+  first_cmd.SetRange("firstEvent>=0");
   msg_->DeclareProperty("region", region_, "");
 
   msg_->DeclareMethod("EnergyThreshold", &Decay0Interface::SetEnergyThreshold, ""); // for electrons only.
   msg_->DeclareMethod("Xe136DecayMode", &Decay0Interface::SetXe136DecayMode, "");
   msg_->DeclareMethod("Ba136FinalState", &Decay0Interface::SetBa136FinalState, "");
 
+  // Window on the summed energy of the electrons, sampled directly
+  // by the translated DECAY0 (instead of discarding the events outside)
+  G4GenericMessenger::Command& sum_min_cmd =
+    msg_->DeclareProperty("EnergySumMin", energySumMin_,
+                          "Minimum summed energy of the electrons.");
+  sum_min_cmd.SetUnitCategory("Energy");
+  sum_min_cmd.SetRange("EnergySumMin>=0.");
+
+  G4GenericMessenger::Command& sum_max_cmd =
+    msg_->DeclareProperty("EnergySumMax", energySumMax_,
+                          "Maximum summed energy of the electrons.");
+  sum_max_cmd.SetUnitCategory("Energy");
+  sum_max_cmd.SetRange("EnergySumMax>0.");
+
+  msg_->DeclareProperty("SpectrumCache", spectrumCache_,
+                        "Directory where the integrated spectra are cached (none if empty).");
+
   DetectorConstruction* detConst = (DetectorConstruction*)
   G4RunManager::GetRunManager()->GetUserDetectorConstruction();
   geom_ = detConst->GetGeometry();
@@ -49,13 +73,15 @@ Decay0Interface::Decay0Interface():
   decay0_ = 0;
   myEventCounter_ = 0;
   energyThreshold_ = 0.;
+  energySumMin_ = 0.;
+  energySumMax_ = 4.3*MeV;
 }
 
 
 
 Decay0Interface::~Decay0Interface()
 {
-  if (file_.is_open()) file_.close();
+  delete reader_;
   if (fOutDebug_.is_open()) fOutDebug_.close();
   if (decay0_ != 0) delete decay0_;
 }
@@ -70,11 +96,12 @@ void Decay0Interface::OpenInputFile(G4String filename)
      return;
    }
 
-  file_.open(filename.data());
+  delete reader_;
+  reader_ = new GenbbFileReader(filename);
 
-  if (file_.good()) {
+  if (reader_->IsOpen()) {
     opened_ = true;
-    ProcessHeader();
+    seeked_ = false;
   }
   else {
     G4Exception("[Decay0Interface]", "SetInputFile()", JustWarning,
@@ -93,7 +120,11 @@ void Decay0Interface::GeneratePrimaryVertex(G4Event* event)
   if (!opened_) {
      if (decay0_ == 0) {
        const std::string XeName("Xe136");
-       decay0_ = new decay0(XeName, Ba136FinalState_, Xe136DecayMode_);
+       if (energySumMin_ >= energySumMax_)
+         G4Exception("[Decay0Interface]", "GeneratePrimaryVertex()", FatalException,
+                     "The minimum summed energy must be lower than the maximum.");
+       decay0_ = new decay0(XeName, Ba136FinalState_, Xe136DecayMode_,
+                            energySumMin_/MeV, energySumMax_/MeV, spectrumCache_);
       // Temporary debugging file, just generate particle and dump them on a file
 //      std::ostringstream fOutStrStr; fOutStrStr << "./Decay0Out_" << Ba136FinalState_ << "_" << Xe136DecayMode_ << "_V1.txt";
 //      std::string fOutStr(fOutStrStr.str());
@@ -138,46 +169,39 @@ void Decay0Interface::GeneratePrimaryVertex(G4Event* event)
      return;
    }
 
-  //G4cout << "GeneratePrimaryVertex()" << G4endl;
-
-  // reading event-related information
-  G4int entries;     // number of particles in the event
-  G4long evt_no;     // event number
-  G4double evt_time; // initial time in seconds
-
-  file_ >> evt_no >> evt_time >> entries;
+  // Jump to the first event of this job the first time
+  if (!seeked_) {
+    reader_->Seek(first_event_);
+    seeked_ = true;
+  }
 
+  GenbbEvent genbb_event;
 
-  // abort if end-of-file was reached in last operation
-  if (file_.eof()) {
+  // abort if the end of the file was reached
+  if (!reader_->ReadEvent(genbb_event)) {
     G4cout  << "[Decay0Interface] End-of-File reached. "
             << "Aborting the run..." << G4endl;
     G4RunManager::GetRunManager()->AbortRun();
     return;
   }
 
-  //G4cout << "entries: " << entries << G4endl;
-
   // generate a position in the detector
   // (all primary particles will be generated there)
   particle_position = geom_->GenerateVertex(region_);
 
 
-  // reading info for each particle in the event
-  for (G4int i=0; i<entries; i++) {
-    //G4cout << i << G4endl;
-
-    G4int g3code;           // GEANT3 particle code
-    G4double px, py, pz;    // Momentum components in MeV
+  // create a primary particle and vertex for each particle in the event
+  for (const GenbbParticle& genbb_particle: genbb_event.particles) {
 
-    file_ >> g3code >> px >> py >> pz >> particle_time;
+    particle_time = genbb_particle.time;
 
     G4ParticleDefinition* g4code =
-      G4ParticleTable::GetParticleTable()->FindParticle(G3toPDG(g3code));
+      G4ParticleTable::GetParticleTable()->FindParticle(G3toPDG(genbb_particle.g3code));
 
     // create a primary particle
     G4PrimaryParticle* particle =
-      new G4PrimaryParticle(g4code, px*MeV, py*MeV, pz*MeV);
+      new G4PrimaryParticle(g4code, genbb_particle.px*MeV,
+                            genbb_particle.py*MeV, genbb_particle.pz*MeV);
 
     particle->SetMass(g4code->GetPDGMass());
     particle->SetCharge(g4code->GetPDGCharge());
@@ -195,14 +219,21 @@ void Decay0Interface::GeneratePrimaryVertex(G4Event* event)
 
 
 
-void Decay0Interface::ProcessHeader()
+G4double Decay0Interface::GetWindowFraction() const
 {
-  G4String line;
+  if (!decay0_) return 0.;
+  return 1. / decay0_->GetEffectiveRatioToOfEvents();
+}
 
-  while (!G4StrUtil::contains(line, "First event")) getline(file_, line);
 
-  getline(file_, line);
-  getline(file_, line);
+
+void Decay0Interface::GetRunInfo(GeneratorRunInfo& info) const
+{
+  if (GetWindowFraction() <= 0.) return;
+
+  std::ostringstream value;
+  value << GetWindowFraction();
+  info.push_back(std::make_pair("decay0_window_fraction", value.str()));
 }
 
 
@@ -13,6 +13,8 @@
 #ifndef DECAY0_INTERFACE_H
 #define DECAY0_INTERFACE_H
 
+#include "GeneratorInfo.h"
+
 #include <G4VPrimaryGenerator.hh>
 #include <fstream>
 
@@ -24,13 +26,14 @@ class decay0;
 namespace nexus {
 
   class GeometryBase;
+  class GenbbFileReader;
 
 
   /// This primary generator sets the G4Event objects according to the
   /// information read from an ascii file produced by the Decay0
   /// Monte-Carlo event generator.
 
-  class Decay0Interface : public G4VPrimaryGenerator
+  class Decay0Interface : public G4VPrimaryGenerator, public GeneratorInfo
   {
   public:
     /// Constructor
@@ -42,11 +45,17 @@ namespace nexus {
     /// and primary vertices accordingly
     void GeneratePrimaryVertex(G4Event*);
 
+    /// Fraction of the total decay rate inside the summed-energy
+    /// window of the translated DECAY0 (zero if it is not used)
+    G4double GetWindowFraction() const;
+
+    /// Fraction of the decays in the window (decay0_window_fraction),
+    /// if the translated DECAY0 is used
+    void GetRunInfo(GeneratorRunInfo&) const;
+
   private:
     /// Open the Decay0 input file selected by the user
     void OpenInputFile(G4String);
-    /// Parse information in the file header
-    void ProcessHeader();
 
     /// Return the PDG code equivalent to a given GEANT3 particle code
     G4int G3toPDG(const G4int);
@@ -54,7 +63,9 @@ namespace nexus {
   private:
     G4GenericMessenger* msg_;
 
-    std::ifstream file_; ///< ASCII file produced by Decay0
+    GenbbFileReader* reader_; ///< Reader of the ASCII file produced by Decay0
+    G4int first_event_; ///< First event read from the file
+    G4bool seeked_; ///< Reading already moved to the first event
     G4String region_; ///< region of generation of vertices in geometry
 
     G4bool opened_;
@@ -68,6 +79,9 @@ namespace nexus {
 			  // default is 0 (ground state)
 
     double energyThreshold_;
+    G4double energySumMin_; ///< Lower limit of the summed electron energy
+    G4double energySumMax_; ///< Upper limit of the summed electron energy
+    G4String spectrumCache_; ///< Directory of the cached bb spectra
 
     std::ofstream fOutDebug_; // for debugging...
     const GeometryBase* geom_;
@@ -0,0 +1,40 @@
+// ----------------------------------------------------------------------------
+// nexus | GeneratorInfo.h
+//
+// Interface of the primary generators that store information of their
+// own in the output file: key/value pairs in the run info (e.g. the
+// quantities needed to normalise the events to a rate) and the
+// identifier of the source that generated each event.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef GENERATOR_INFO_H
+#define GENERATOR_INFO_H
+
+#include <G4String.hh>
+
+#include <utility>
+#include <vector>
+
+
+namespace nexus {
+
+  typedef std::vector<std::pair<G4String, G4String>> GeneratorRunInfo;
+
+  class GeneratorInfo
+  {
+  public:
+    virtual ~GeneratorInfo() {}
+
+    /// Add the key/value pairs to be stored in the run info
+    virtual void GetRunInfo(GeneratorRunInfo&) const {}
+
+    /// Identifier of the source of the last event generated,
+    /// stored with the event (no identifier is stored if negative)
+    virtual G4int GetEventSourceID() const { return -1; }
+  };
+
+} // end namespace nexus
+
+#endif
@@ -0,0 +1,216 @@
+// ----------------------------------------------------------------------------
+// nexus | HDF5ReplayGenerator.cc
+//
+// This class is the primary generator that replays, event by event,
+// the primary vertices stored in the /MC/primaries table of a nexus
+// output file (written with /nexus/persistency/save_primaries true).
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "HDF5ReplayGenerator.h"
+
+#include "FactoryBase.h"
+
+#include <G4GenericMessenger.hh>
+#include <G4RunManager.hh>
+#include <G4ParticleTable.hh>
+#include <G4ParticleDefinition.hh>
+#include <G4IonTable.hh>
+#include <G4PrimaryVertex.hh>
+#include <G4PrimaryParticle.hh>
+#include <G4Event.hh>
+
+#include <map>
+
+using namespace nexus;
+
+REGISTER_CLASS(HDF5ReplayGenerator, G4VPrimaryGenerator)
+
+
+HDF5ReplayGenerator::HDF5ReplayGenerator():
+  G4VPrimaryGenerator(), msg_(0), file_(-1), dataset_(-1), memtype_(-1),
+  chunk_size_(32768), first_event_(0), seeked_(false), pos_(0), next_row_(0)
+{
+  msg_ = new G4GenericMessenger(this, "/Generator/HDF5Replay/",
+    "Control commands of the generator replaying the primaries of a nexus file.");
+
+  msg_->DeclareMethod("inputFile", &HDF5ReplayGenerator::OpenInputFile,
+                      "nexus file with the /MC/primaries table.");
+
+  G4GenericMessenger::Command& first_cmd =
+    msg_->DeclareProperty("firstEvent", first_event_,
+                          "Number of events of the file skipped before replaying.");
+  first_cmd.SetParameterName("firstEvent", false);
+  first_cmd.SetRange("firstEvent>=0");
+
+  G4GenericMessenger::Command& chunk_cmd =
+    msg_->DeclareProperty("chunkSize", chunk_size_,
+                          "Number of rows of the table read at once.");
+  chunk_cmd.SetParameterName("chunkSize", false);
+  chunk_cmd.SetRange("chunkSize>0");
+}
+
+
+
+HDF5ReplayGenerator::~HDF5ReplayGenerator()
+{
+  CloseInputFile();
+  delete msg_;
+}
+
+
+
+void HDF5ReplayGenerator::OpenInputFile(G4String filename)
+{
+  CloseInputFile();
+
+  file_ = H5Fopen(filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+  if (file_ < 0)
+    G4Exception("[HDF5ReplayGenerator]", "OpenInputFile()", FatalException,
+                ("Cannot open input file " + filename).c_str());
+
+  if (H5Lexists(file_, "/MC", H5P_DEFAULT) <= 0 ||
+      H5Lexists(file_, "/MC/primaries", H5P_DEFAULT) <= 0)
+    G4Exception("[HDF5ReplayGenerator]", "OpenInputFile()", FatalException,
+                ("No /MC/primaries table in " + filename +
+                 ". It is written with /nexus/persistency/save_primaries true.").c_str());
+
+  dataset_ = H5Dopen(file_, "/MC/primaries", H5P_DEFAULT);
+  memtype_ = createPrimaryType();
+
+  filename_ = filename;
+  buffer_.clear();
+  pos_      = 0;
+  next_row_ = 0;
+  seeked_   = false;
+}
+
+
+
+void HDF5ReplayGenerator::CloseInputFile()
+{
+  if (memtype_ >= 0) H5Tclose(memtype_);
+  if (dataset_ >= 0) H5Dclose(dataset_);
+  if (file_    >= 0) H5Fclose(file_);
+  memtype_ = dataset_ = file_ = -1;
+}
+
+
+
+G4bool HDF5ReplayGenerator::FillBuffer()
+{
+  if (pos_ < buffer_.size()) return true;
+
+  buffer_.resize(chunk_size_);
+  hsize_t nrows = readPrimaries(buffer_.data(), dataset_, memtype_,
+                                next_row_, chunk_size_);
+  buffer_.resize(nrows);
+  next_row_ += nrows;
+  pos_ = 0;
+
+  return nrows > 0;
+}
+
+
+
+G4bool HDF5ReplayGenerator::ReadEvent(std::vector<primary_info_t>& rows)
+{
+  rows.clear();
+  if (!FillBuffer()) return false;
+
+  // The rows of an event are contiguous in the table,
+  // although they may be split between two chunks
+  int64_t event_id = buffer_[pos_].event_id;
+  while (FillBuffer() && buffer_[pos_].event_id == event_id)
+    rows.push_back(buffer_[pos_++]);
+
+  return true;
+}
+
+
+
+G4ParticleDefinition*
+HDF5ReplayGenerator::GetDefinition(const primary_info_t& row) const
+{
+  // The name identifies the particles without a PDG code (geantinos),
+  // and the ion table creates the ions not used yet in this job
+  G4ParticleTable* table = G4ParticleTable::GetParticleTable();
+  G4ParticleDefinition* definition = nullptr;
+  if (row.particle_name[0] != '\0')
+    definition = table->FindParticle(G4String(row.particle_name));
+  if (!definition && row.pdg_code != 0)
+    definition = table->FindParticle(row.pdg_code);
+  if (!definition && row.pdg_code > 1000000000)
+    definition = G4IonTable::GetIonTable()->GetIon(row.pdg_code);
+
+  if (!definition)
+    G4Exception("[HDF5ReplayGenerator]", "GetDefinition()", FatalException,
+                ("Unknown particle " + G4String(row.particle_name) +
+                 " (PDG code " + std::to_string(row.pdg_code) + ") in " +
+                 filename_).c_str());
+
+  return definition;
+}
+
+
+
+void HDF5ReplayGenerator::GeneratePrimaryVertex(G4Event* event)
+{
+  if (file_ < 0)
+    G4Exception("[HDF5ReplayGenerator]", "GeneratePrimaryVertex()",
+                FatalException, "No input file was given.");
+
+  std::vector<primary_info_t> rows;
+
+  // Skip the events already replayed by other jobs the first time
+  if (!seeked_) {
+    for (G4int i=0; i<first_event_; ++i)
+      if (!ReadEvent(rows)) break;
+    seeked_ = true;
+  }
+
+  // abort if the end of the file was reached
+  if (!ReadEvent(rows)) {
+    G4cout  << "[HDF5ReplayGenerator] End of the primaries table reached. "
+            << "Aborting the run..." << G4endl;
+    G4RunManager::GetRunManager()->AbortRun();
+    return;
+  }
+
+  std::map<G4int, G4PrimaryVertex*>   vertices;
+  std::map<G4int, G4PrimaryParticle*> particles;
+
+  for (const primary_info_t& row: rows) {
+
+    G4PrimaryParticle* particle = new G4PrimaryParticle(GetDefinition(row));
+    if (row.mass >= 0.) particle->SetMass(row.mass);
+    particle->SetCharge(row.charge);
+    particle->SetMomentum(row.px, row.py, row.pz);
+    particle->SetPolarization(row.polarization_x, row.polarization_y,
+                              row.polarization_z);
+    particle->SetWeight(row.weight);
+    particles[row.particle_id] = particle;
+
+    // Daughters of pre-assigned decays hang from their mother
+    if (row.mother_id > 0) {
+      auto mother = particles.find(row.mother_id);
+      if (mother == particles.end())
+        G4Exception("[HDF5ReplayGenerator]", "GeneratePrimaryVertex()",
+                    FatalException, ("Mother of primary " +
+                    std::to_string(row.particle_id) + " not found in event " +
+                    std::to_string(row.event_id)).c_str());
+      mother->second->SetDaughter(particle);
+      continue;
+    }
+
+    G4PrimaryVertex*& vertex = vertices[row.vertex_id];
+    if (!vertex)
+      vertex = new G4PrimaryVertex(G4ThreeVector(row.x, row.y, row.z), row.time);
+    vertex->SetPrimary(particle);
+  }
+
+  // add the vertices to the event in their original order
+  for (auto& vertex: vertices)
+    event->AddPrimaryVertex(vertex.second);
+}
@@ -0,0 +1,78 @@
+// ----------------------------------------------------------------------------
+// nexus | HDF5ReplayGenerator.h
+//
+// This class is the primary generator that replays, event by event,
+// the primary vertices stored in the /MC/primaries table of a nexus
+// output file (written with /nexus/persistency/save_primaries true).
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef HDF5_REPLAY_GENERATOR_H
+#define HDF5_REPLAY_GENERATOR_H
+
+#include "hdf5_functions.h"
+
+#include <G4VPrimaryGenerator.hh>
+
+#include <vector>
+
+class G4GenericMessenger;
+class G4Event;
+class G4ParticleDefinition;
+
+
+namespace nexus {
+
+  /// Primary generator that reads the primary particles saved in a
+  /// previous nexus output file, so that the same events can be
+  /// simulated again with a different detector configuration.
+  /// The table is read in chunks of rows, not one event at a time.
+
+  class HDF5ReplayGenerator : public G4VPrimaryGenerator
+  {
+  public:
+    /// Constructor
+    HDF5ReplayGenerator();
+    /// Destructor
+    ~HDF5ReplayGenerator();
+
+    /// Read the next event from the file and create its
+    /// primary vertices and particles
+    void GeneratePrimaryVertex(G4Event*);
+
+  private:
+    /// Open the nexus file selected by the user
+    void OpenInputFile(G4String);
+    /// Close the input file, if open
+    void CloseInputFile();
+
+    /// Make sure there is at least one row left in the buffer.
+    /// Returns false at the end of the table.
+    G4bool FillBuffer();
+    /// Read all the rows of the next event in the table
+    G4bool ReadEvent(std::vector<primary_info_t>&);
+
+    /// Particle definition of a row of the table
+    G4ParticleDefinition* GetDefinition(const primary_info_t&) const;
+
+  private:
+    G4GenericMessenger* msg_;
+
+    G4String filename_; ///< Name of the input file
+    hid_t file_;        ///< Input file
+    hid_t dataset_;     ///< Table of primaries
+    hid_t memtype_;     ///< Row type of the table
+
+    G4int chunk_size_;  ///< Number of rows read at once
+    G4int first_event_; ///< Number of events skipped at the start of the file
+    G4bool seeked_;     ///< First events already skipped
+
+    std::vector<primary_info_t> buffer_; ///< Rows read from the table
+    size_t pos_;        ///< Next row of the buffer
+    hsize_t next_row_;  ///< Row of the table after the buffer
+  };
+
+} // end namespace nexus
+
+#endif
@@ -13,6 +13,9 @@
 #include "GeometryBase.h"
 #include "DetectorConstruction.h"
 #include "FactoryBase.h"
+#include "VertexPool.h"
+#include "NexusApp.h"
+#include "IOUtils.h"
 
 #include <G4GenericMessenger.hh>
 #include <G4RunManager.hh>
@@ -28,7 +31,7 @@ IonGenerator::IonGenerator():
   G4VPrimaryGenerator(),
   atomic_number_(0), mass_number_(0), energy_level_(0.),
   decay_at_time_zero_(true),
-  region_(""),
+  region_(""), pool_size_(0), pool_cache_(""), pool_jobs_(1), pool_(nullptr),
   msg_(nullptr), geom_(nullptr)
 {
   msg_ = new G4GenericMessenger(this, "/Generator/IonGenerator/",
@@ -56,6 +59,22 @@ IonGenerator::IonGenerator():
   msg_->DeclareProperty("region", region_,
                         "Region of the geometry where vertices will be generated.");
 
+  G4GenericMessenger::Command& pool_cmd =
+    msg_->DeclareProperty("vertex_pool", pool_size_,
+                          "Number of vertices pre-sampled in the region (0 to sample them in each event).");
+  pool_cmd.SetParameterName("vertex_pool", false);
+  pool_cmd.SetRange("vertex_pool >= 0");
+
+  msg_->DeclareProperty("vertex_pool_cache", pool_cache_,
+                        "Directory where the vertex pools are cached (none if empty). "
+                        "All the jobs reading a cached pool draw the same vertices.");
+
+  G4GenericMessenger::Command& jobs_cmd =
+    msg_->DeclareProperty("vertex_pool_jobs", pool_jobs_,
+                          "Number of jobs sharing the cached vertex pools, to check that they are large enough.");
+  jobs_cmd.SetParameterName("vertex_pool_jobs", false);
+  jobs_cmd.SetRange("vertex_pool_jobs > 0");
+
   // Load the detector geometry, which will be used for the generation of vertices
   const DetectorConstruction* detconst = dynamic_cast<const DetectorConstruction*>
     (G4RunManager::GetRunManager()->GetUserDetectorConstruction());
@@ -66,10 +85,33 @@ IonGenerator::IonGenerator():
 
 IonGenerator::~IonGenerator()
 {
+  delete pool_;
   delete msg_;
 }
 
 
+void IonGenerator::CreateVertexPool()
+{
+  const NexusApp* app = dynamic_cast<const NexusApp*>(G4RunManager::GetRunManager());
+
+  pool_ = new VertexPool([this]() { return geom_->GenerateVertex(region_); },
+                         pool_size_);
+
+  // The pool depends only on the geometry, the region and its size
+  G4String filename = "";
+  G4String key = region_ + " " + std::to_string(pool_size_);
+  if (app) key += " " + app->GeometryHash();
+  if (pool_cache_ != "")
+    filename = pool_cache_ + "/" + region_ + "_" + HashString(key) + ".vtx";
+
+  pool_->Fill(filename, key);
+
+  // Only the jobs reading the cache share the vertices
+  if (app) pool_->CheckSize(app->GetNumberOfEventsToBeProcessed(),
+                            filename != "" ? pool_jobs_ : 1);
+}
+
+
 G4ParticleDefinition* IonGenerator::IonDefinition()
 {
   G4ParticleDefinition* pdef =
@@ -100,8 +142,10 @@ void IonGenerator::GeneratePrimaryVertex(G4Event* event)
   // Create the new primary particle (i.e. the ion)
   G4PrimaryParticle* ion = new G4PrimaryParticle(pdef);
 
-  // Generate an initial position for the ion using the geometry
-  G4ThreeVector position = geom_->GenerateVertex(region_);
+  // Generate an initial position for the ion using the geometry,
+  // or take it from the pool of pre-sampled vertices
+  if (pool_size_ > 0 && !pool_) CreateVertexPool();
+  G4ThreeVector position = pool_ ? pool_->Draw() : geom_->GenerateVertex(region_);
   // Ion generated at the start-of-event time
   G4double time = 0.;
   // Create a new vertex
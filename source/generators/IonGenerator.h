@@ -21,6 +21,7 @@ class G4ParticleDefinition;
 namespace nexus{
 
   class GeometryBase;
+  class VertexPool;
 
   class IonGenerator: public G4VPrimaryGenerator
   {
@@ -37,11 +38,18 @@ namespace nexus{
   private:
     G4ParticleDefinition* IonDefinition();
 
+    /// Sample the pool of vertices, or read it from the cache
+    void CreateVertexPool();
+
  private:
     G4int atomic_number_, mass_number_;
     G4double energy_level_;
     G4bool decay_at_time_zero_;
     G4String region_;
+    G4int pool_size_;       ///< Number of pre-sampled vertices (none if 0)
+    G4String pool_cache_;   ///< Directory of the vertex pool cache
+    G4int pool_jobs_;       ///< Number of jobs sharing the cached pools
+    VertexPool* pool_;
     G4GenericMessenger* msg_;
     const GeometryBase* geom_;
   };
@@ -0,0 +1,267 @@
+// ----------------------------------------------------------------------------
+// nexus | LightTableGenerator.cc
+//
+// This generator produces the light tables of a detector in a single job.
+// It sweeps a regular (x, y, z) grid, generating in every point a number of
+// optical photons with energy following the scintillation spectrum of the
+// material. It is meant to be used with LightTablePersistencyManager.
+// If the detector has a declared symmetry, only the points of the grid
+// in the fundamental domain of the symmetry group are simulated.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "LightTableGenerator.h"
+
+#include "FactoryBase.h"
+#include "NexusPhysics.h"
+
+#include <G4GenericMessenger.hh>
+#include <G4TransportationManager.hh>
+#include <G4Navigator.hh>
+#include <G4VPhysicalVolume.hh>
+#include <G4LogicalVolume.hh>
+#include <G4Material.hh>
+#include <G4MaterialPropertiesTable.hh>
+#include <G4PrimaryVertex.hh>
+#include <G4PrimaryParticle.hh>
+#include <G4Event.hh>
+#include <G4RandomDirection.hh>
+#include <G4OpticalPhoton.hh>
+#include <Randomize.hh>
+
+#include "CLHEP/Units/SystemOfUnits.h"
+
+using namespace nexus;
+using namespace CLHEP;
+
+REGISTER_CLASS(LightTableGenerator, G4VPrimaryGenerator)
+
+
+LightTableGenerator::LightTableGenerator():
+  G4VPrimaryGenerator(), msg_(0), geom_navigator_(0),
+  grid_min_(0., 0., 0.), grid_max_(0., 0., 0.), pitch_(1.*mm, 1.*mm, 1.*mm),
+  radius_(0.), photons_per_point_(100000), events_per_point_(1),
+  rotation_order_(1), reflection_(false)
+{
+  msg_ = new G4GenericMessenger(this, "/Generator/LightTableGenerator/",
+    "Control commands of the light table generator.");
+
+  G4GenericMessenger::Command& min_cmd =
+    msg_->DeclarePropertyWithUnit("grid_min", "mm", grid_min_,
+                                  "Lower corner of the grid.");
+  min_cmd.SetParameterName("grid_min", false);
+
+  G4GenericMessenger::Command& max_cmd =
+    msg_->DeclarePropertyWithUnit("grid_max", "mm", grid_max_,
+                                  "Upper corner of the grid.");
+  max_cmd.SetParameterName("grid_max", false);
+
+  G4GenericMessenger::Command& pitch_cmd =
+    msg_->DeclarePropertyWithUnit("pitch", "mm", pitch_,
+                                  "Distance between grid points along each axis.");
+  pitch_cmd.SetParameterName("pitch", false);
+
+  G4GenericMessenger::Command& radius_cmd =
+    msg_->DeclareProperty("radius", radius_,
+                          "Points further than this from the z axis are skipped (0 = no cut).");
+  radius_cmd.SetParameterName("radius", false);
+  radius_cmd.SetUnitCategory("Length");
+  radius_cmd.SetRange("radius>=0.");
+
+  G4GenericMessenger::Command& photons_cmd =
+    msg_->DeclareProperty("photons_per_point", photons_per_point_,
+                          "Number of photons generated per event.");
+  photons_cmd.SetParameterName("photons_per_point", false);
+  photons_cmd.SetRange("photons_per_point>0");
+
+  G4GenericMessenger::Command& events_cmd =
+    msg_->DeclareProperty("events_per_point", events_per_point_,
+                          "Number of events simulated in each grid point.");
+  events_cmd.SetParameterName("events_per_point", false);
+  events_cmd.SetRange("events_per_point>0");
+
+  G4GenericMessenger::Command& rotation_cmd =
+    msg_->DeclareProperty("rotation_order", rotation_order_,
+                          "Order of the rotation symmetry of the detector around z.");
+  rotation_cmd.SetParameterName("rotation_order", false);
+  rotation_cmd.SetRange("rotation_order>0");
+
+  msg_->DeclareProperty("reflection", reflection_,
+                        "Whether the detector is symmetric under y -> -y.");
+
+  geom_navigator_ =
+    G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking();
+}
+
+
+
+LightTableGenerator::~LightTableGenerator()
+{
+  for (auto& kv: spectra_) delete kv.second;
+  delete msg_;
+}
+
+
+
+void LightTableGenerator::BuildGrid() const
+{
+  points_.clear();
+  domain_ids_.clear();
+  symmetry_ = LightTableSymmetry(rotation_order_, reflection_);
+
+  G4int n[3];
+  for (G4int i=0; i<3; ++i) {
+    n[i] = (pitch_[i] > 0.) ?
+      (G4int) std::floor((grid_max_[i] - grid_min_[i]) / pitch_[i] + 0.5) + 1 : 1;
+    n[i] = std::max(n[i], 1);
+  }
+
+  // Small tolerance, so that points lying on the circle are kept
+  G4double max_r = radius_ * (1. + 1.e-9);
+
+  for (G4int i=0; i<n[0]; ++i) {
+    for (G4int j=0; j<n[1]; ++j) {
+      for (G4int k=0; k<n[2]; ++k) {
+        G4ThreeVector point(grid_min_.x() + i * pitch_.x(),
+                            grid_min_.y() + j * pitch_.y(),
+                            grid_min_.z() + k * pitch_.z());
+        if (radius_ > 0. && point.perp() > max_r) continue;
+        points_.push_back(point);
+      }
+    }
+  }
+
+  // Points whose cell overlaps the fundamental domain are simulated,
+  // so that lookups near the boundaries of the domain do not fall
+  // outside the table
+  G4double margin = 0.5 * std::hypot(pitch_.x(), pitch_.y());
+
+  for (size_t i=0; i<points_.size(); ++i) {
+    if (symmetry_.InFundamentalDomain(points_[i], margin))
+      domain_ids_.push_back(i);
+  }
+}
+
+
+
+G4int LightTableGenerator::GetNumberOfPoints() const
+{
+  if (points_.empty()) BuildGrid();
+  return points_.size();
+}
+
+
+
+G4ThreeVector LightTableGenerator::GetPoint(G4int point_id) const
+{
+  if (points_.empty()) BuildGrid();
+  return points_.at(point_id);
+}
+
+
+
+G4int LightTableGenerator::GetNumberOfSimulatedPoints() const
+{
+  if (points_.empty()) BuildGrid();
+  return domain_ids_.size();
+}
+
+
+
+G4int LightTableGenerator::GetPointID(G4int event_id) const
+{
+  if (points_.empty()) BuildGrid();
+  size_t i = event_id / events_per_point_;
+  return (i < domain_ids_.size()) ? domain_ids_[i] : GetNumberOfPoints();
+}
+
+
+
+const LightTableSymmetry& LightTableGenerator::GetSymmetry() const
+{
+  if (points_.empty()) BuildGrid();
+  return symmetry_;
+}
+
+
+
+void LightTableGenerator::GeneratePrimaryVertex(G4Event* event)
+{
+  G4int point_id = GetPointID(event->GetEventID());
+
+  if (point_id >= GetNumberOfPoints()) {
+    G4Exception("[LightTableGenerator]", "GeneratePrimaryVertex()", FatalException,
+                ("Only " + std::to_string(GetNumberOfSimulatedPoints() * events_per_point_) +
+                 " events are needed to cover the grid.").c_str());
+  }
+
+  G4ThreeVector position = GetPoint(point_id);
+  G4double time = 0.;
+
+  G4VPhysicalVolume* vol =
+    geom_navigator_->LocateGlobalPointAndSetup(position, 0, false);
+  if (!vol) {
+    G4String msg = "Point " + std::to_string(point_id) + " of the table, at (" +
+      std::to_string(position.x()/mm) + ", " + std::to_string(position.y()/mm) + ", " +
+      std::to_string(position.z()/mm) + ") mm, is outside the world volume.";
+    G4Exception("[LightTableGenerator]", "GeneratePrimaryVertex()", FatalException, msg);
+  }
+  const G4PhysicsOrderedFreeVector* spectrum_integral =
+    GetSpectrumIntegral(vol->GetLogicalVolume()->GetMaterial());
+  G4double sc_max = spectrum_integral->GetMaxValue();
+
+  G4PrimaryVertex* vertex = new G4PrimaryVertex(position, time);
+
+  // Photons are thinned by the optical prescale, like the scintillation
+  G4double prescale = NexusPhysics::GetOpticalPrescale();
+  G4int nphotons = (prescale < 1.) ?
+    CLHEP::RandBinomial::shoot(photons_per_point_, prescale) : photons_per_point_;
+
+  for (G4int i=0; i<nphotons; ++i) {
+    G4ThreeVector momentum_direction = G4RandomDirection();
+    G4double pmod = spectrum_integral->GetEnergy(G4UniformRand() * sc_max);
+
+    G4PrimaryParticle* particle =
+      new G4PrimaryParticle(G4OpticalPhoton::Definition(),
+                            pmod * momentum_direction.x(),
+                            pmod * momentum_direction.y(),
+                            pmod * momentum_direction.z());
+    particle->SetPolarization(G4RandomDirection());
+    vertex->SetPrimary(particle);
+  }
+
+  event->AddPrimaryVertex(vertex);
+}
+
+
+
+const G4PhysicsOrderedFreeVector*
+LightTableGenerator::GetSpectrumIntegral(const G4Material* mat)
+{
+  auto it = spectra_.find(mat);
+  if (it != spectra_.end()) return it->second;
+
+  G4MaterialPropertiesTable* mpt = mat->GetMaterialPropertiesTable();
+  G4MaterialPropertyVector* spectrum =
+    mpt ? mpt->GetProperty("SCINTILLATIONCOMPONENT1") : nullptr;
+
+  if (!spectrum) {
+    G4Exception("[LightTableGenerator]", "GetSpectrumIntegral()", FatalException,
+                ("Scintillation spectrum not defined for material " +
+                 mat->GetName()).c_str());
+  }
+
+  // Cumulative distribution, as in ScintillationGenerator
+  G4PhysicsOrderedFreeVector* cdf = new G4PhysicsOrderedFreeVector();
+  G4double sum = 0.;
+  cdf->InsertValues(spectrum->Energy(0), sum);
+  for (size_t i=1; i<spectrum->GetVectorLength(); ++i) {
+    sum += 0.5 * (spectrum->Energy(i) - spectrum->Energy(i-1)) *
+      ((*spectrum)[i] + (*spectrum)[i-1]);
+    cdf->InsertValues(spectrum->Energy(i), sum);
+  }
+
+  spectra_[mat] = cdf;
+  return cdf;
+}
@@ -0,0 +1,101 @@
+// ----------------------------------------------------------------------------
+// nexus | LightTableGenerator.h
+//
+// This generator produces the light tables of a detector in a single job.
+// It sweeps a regular (x, y, z) grid, generating in every point a number of
+// optical photons with energy following the scintillation spectrum of the
+// material. It is meant to be used with LightTablePersistencyManager.
+// If the detector has a declared symmetry, only the points of the grid
+// in the fundamental domain of the symmetry group are simulated.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef LIGHT_TABLE_GENERATOR_H
+#define LIGHT_TABLE_GENERATOR_H
+
+#include <G4VPrimaryGenerator.hh>
+#include <G4ThreeVector.hh>
+#include <G4PhysicsOrderedFreeVector.hh>
+
+#include "LightTableSymmetry.h"
+
+#include <map>
+#include <vector>
+
+class G4GenericMessenger;
+class G4Event;
+class G4Navigator;
+class G4Material;
+
+
+namespace nexus {
+
+  class LightTableGenerator: public G4VPrimaryGenerator
+  {
+  public:
+    /// Constructor
+    LightTableGenerator();
+    /// Destructor
+    ~LightTableGenerator();
+
+    /// This method is invoked at the beginning of the event. It sets
+    /// a vertex of optical photons in the grid point of the event.
+    void GeneratePrimaryVertex(G4Event*);
+
+    /// Number of points of the grid
+    G4int GetNumberOfPoints() const;
+    /// Position of a point of the grid
+    G4ThreeVector GetPoint(G4int point_id) const;
+    /// Number of points of the grid that are actually simulated
+    G4int GetNumberOfSimulatedPoints() const;
+    /// Grid point simulated in a given event
+    G4int GetPointID(G4int event_id) const;
+    /// Symmetry group of the table
+    const LightTableSymmetry& GetSymmetry() const;
+
+    G4ThreeVector GetGridMin() const;
+    G4ThreeVector GetGridMax() const;
+    G4ThreeVector GetPitch() const;
+    G4double GetRadius() const;
+    G4int GetEventsPerPoint() const;
+
+  private:
+    /// Compute the points of the grid. Points are ordered by x,
+    /// then by y and then by z. Only the points in the fundamental
+    /// domain of the symmetry group are selected for simulation.
+    void BuildGrid() const;
+
+    /// Cumulative scintillation spectrum of a material
+    const G4PhysicsOrderedFreeVector* GetSpectrumIntegral(const G4Material*);
+
+  private:
+    G4GenericMessenger* msg_;
+    G4Navigator* geom_navigator_; ///< Geometry navigator
+
+    G4ThreeVector grid_min_;  ///< Lower corner of the grid
+    G4ThreeVector grid_max_;  ///< Upper corner of the grid
+    G4ThreeVector pitch_;     ///< Distance between points along each axis
+    G4double radius_;         ///< Points further from the z axis are skipped
+    G4int photons_per_point_; ///< Photons generated per event
+    G4int events_per_point_;  ///< Events simulated per grid point
+    G4int rotation_order_;    ///< Order of the rotation symmetry around z
+    G4bool reflection_;       ///< Symmetry under the reflection y -> -y
+
+    mutable std::vector<G4ThreeVector> points_; ///< Built on first use
+    mutable std::vector<G4int> domain_ids_;     ///< Points to be simulated
+    mutable LightTableSymmetry symmetry_;
+    std::map<const G4Material*, G4PhysicsOrderedFreeVector*> spectra_;
+  };
+
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline G4ThreeVector LightTableGenerator::GetGridMin() const { return grid_min_; }
+  inline G4ThreeVector LightTableGenerator::GetGridMax() const { return grid_max_; }
+  inline G4ThreeVector LightTableGenerator::GetPitch() const { return pitch_; }
+  inline G4double LightTableGenerator::GetRadius() const { return radius_; }
+  inline G4int LightTableGenerator::GetEventsPerPoint() const { return events_per_point_; }
+
+} // end namespace nexus
+
+#endif
@@ -0,0 +1,269 @@
+// ----------------------------------------------------------------------------
+// nexus | MultiSourceGenerator.cc
+//
+// This class is the primary generator of a mixture of sources, such as
+// the radioactive isotopes of a background model in several regions of
+// the geometry. Each source is given a weight (its activity, or any
+// relative weight); in every event one source is drawn with the alias
+// method, and the event is generated either as the decay of an ion at
+// rest in the region of the source, or by another generator. The source
+// chosen in each event is stored in the output file.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "MultiSourceGenerator.h"
+
+#include "GeometryBase.h"
+#include "DetectorConstruction.h"
+#include "HistogramSampler.h"
+#include "FactoryBase.h"
+#include "VertexPool.h"
+#include "NexusApp.h"
+#include "IOUtils.h"
+
+#include <G4GenericMessenger.hh>
+#include <G4RunManager.hh>
+#include <G4ParticleDefinition.hh>
+#include <G4IonTable.hh>
+#include <G4PrimaryVertex.hh>
+#include <G4UIcommand.hh>
+#include <G4Event.hh>
+
+#include <sstream>
+
+using namespace nexus;
+
+REGISTER_CLASS(MultiSourceGenerator, G4VPrimaryGenerator)
+
+
+MultiSourceGenerator::MultiSourceGenerator():
+  G4VPrimaryGenerator(), msg_(nullptr), geom_(nullptr),
+  decay_at_time_zero_(true), pool_size_(0), pool_cache_(""), pool_jobs_(1),
+  sampler_(new HistogramSampler()), last_source_(-1)
+{
+  msg_ = new G4GenericMessenger(this, "/Generator/MultiSource/",
+                                "Control commands of the multi-source generator.");
+
+  msg_->DeclareMethod("addIon", &MultiSourceGenerator::AddIon,
+                      "Add an ion source: <region> <Z> <A> <weight> [<energy level> <unit>].");
+
+  msg_->DeclareMethod("addGenerator", &MultiSourceGenerator::AddGenerator,
+                      "Add a registered generator as a source: <name> <weight>.");
+
+  msg_->DeclareProperty("decay_at_time_zero", decay_at_time_zero_,
+                        "Set to true to make unstable ions decay at t=0.");
+
+  G4GenericMessenger::Command& pool_cmd =
+    msg_->DeclareProperty("vertex_pool", pool_size_,
+                          "Number of vertices pre-sampled in each region (0 to sample them in each event).");
+  pool_cmd.SetParameterName("vertex_pool", false);
+  pool_cmd.SetRange("vertex_pool >= 0");
+
+  msg_->DeclareProperty("vertex_pool_cache", pool_cache_,
+                        "Directory where the vertex pools are cached (none if empty). "
+                        "All the jobs reading a cached pool draw the same vertices.");
+
+  G4GenericMessenger::Command& jobs_cmd =
+    msg_->DeclareProperty("vertex_pool_jobs", pool_jobs_,
+                          "Number of jobs sharing the cached vertex pools, to check that they are large enough.");
+  jobs_cmd.SetParameterName("vertex_pool_jobs", false);
+  jobs_cmd.SetRange("vertex_pool_jobs > 0");
+
+  // Load the detector geometry, which will be used for the generation of vertices
+  const DetectorConstruction* detconst = dynamic_cast<const DetectorConstruction*>
+    (G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+  if (detconst) geom_ = detconst->GetGeometry();
+  else G4Exception("[MultiSourceGenerator]", "MultiSourceGenerator()",
+                   FatalException, "Unable to load geometry.");
+}
+
+
+
+MultiSourceGenerator::~MultiSourceGenerator()
+{
+  delete sampler_;
+  delete msg_;
+}
+
+
+
+void MultiSourceGenerator::AddIon(G4String parameters)
+{
+  std::istringstream in(parameters);
+  Source source{"", 0, 0, 0., nullptr, "", 0., 0};
+
+  G4String unit = "MeV";
+  if (!(in >> source.region >> source.Z >> source.A >> source.weight) ||
+      source.Z <= 0 || source.A < source.Z || source.weight <= 0.)
+    G4Exception("[MultiSourceGenerator]", "AddIon()", FatalException,
+                ("Wrong ion source '" + parameters +
+                 "', expected <region> <Z> <A> <weight> [<energy level> <unit>]").c_str());
+
+  if (in >> source.energy_level) {
+    in >> unit;
+    source.energy_level *= G4UIcommand::ValueOf(unit);
+  }
+
+  sources_.push_back(source);
+  generators_.emplace_back(nullptr);
+  UpdateSampler();
+}
+
+
+
+void MultiSourceGenerator::AddGenerator(G4String parameters)
+{
+  std::istringstream in(parameters);
+  Source source{"", 0, 0, 0., nullptr, "", 0., 0};
+
+  if (!(in >> source.generator >> source.weight) || source.weight <= 0.)
+    G4Exception("[MultiSourceGenerator]", "AddGenerator()", FatalException,
+                ("Wrong generator source '" + parameters +
+                 "', expected <name> <weight>").c_str());
+
+  // A second instance would declare the same commands again
+  for (auto& other: sources_)
+    if (other.generator == source.generator)
+      G4Exception("[MultiSourceGenerator]", "AddGenerator()", FatalException,
+                  ("Generator " + source.generator + " was already added.").c_str());
+
+  if (source.generator == "MultiSourceGenerator")
+    G4Exception("[MultiSourceGenerator]", "AddGenerator()", FatalException,
+                "A multi-source generator cannot be a source of itself.");
+
+  sources_.push_back(source);
+  generators_.push_back(ObjFactory<G4VPrimaryGenerator>::Instance()
+                        .CreateObject(source.generator));
+  UpdateSampler();
+}
+
+
+
+void MultiSourceGenerator::UpdateSampler()
+{
+  // One-dimensional histogram with one bin per source
+  std::vector<G4double> weights;
+  std::vector<std::vector<G4double>> centres(1), widths(1);
+  for (size_t i=0; i<sources_.size(); ++i) {
+    weights.push_back(sources_[i].weight);
+    centres[0].push_back(i);
+    widths[0].push_back(1.);
+  }
+  sampler_->SetHistogram(weights, centres, widths);
+}
+
+
+
+G4String MultiSourceGenerator::GetSourceDescription(G4int source) const
+{
+  const Source& s = sources_[source];
+  std::ostringstream description;
+  if (s.generator != "")
+    description << s.generator;
+  else
+    description << s.region << " Z=" << s.Z << " A=" << s.A
+                << " E=" << s.energy_level/keV << " keV";
+  description << " weight=" << s.weight;
+  return description.str();
+}
+
+
+
+void MultiSourceGenerator::GetRunInfo(GeneratorRunInfo& info) const
+{
+  for (G4int i=0; i<GetNumberOfSources(); ++i) {
+    G4String key = "source_" + std::to_string(i);
+    info.push_back(std::make_pair(key, GetSourceDescription(i)));
+    info.push_back(std::make_pair(key + "_events", std::to_string(GetSourceEvents(i))));
+
+    // Keys of the generator of the source, prefixed with the source
+    const GeneratorInfo* gen = dynamic_cast<const GeneratorInfo*>(generators_[i].get());
+    if (!gen) continue;
+    GeneratorRunInfo gen_info;
+    gen->GetRunInfo(gen_info);
+    for (auto& entry: gen_info)
+      info.push_back(std::make_pair(key + "_" + entry.first, entry.second));
+  }
+}
+
+
+
+G4ParticleDefinition* MultiSourceGenerator::IonDefinition(G4int source)
+{
+  Source& s = sources_[source];
+  if (s.ion) return s.ion;
+
+  s.ion = G4IonTable::GetIonTable()->GetIon(s.Z, s.A, s.energy_level);
+
+  if (!s.ion) G4Exception("[MultiSourceGenerator]", "IonDefinition()",
+                          FatalException, "Unable to find the requested ion.");
+
+  // Same short lifetime as in IonGenerator, to keep
+  // the event time within the scale of the detector response
+  if (decay_at_time_zero_ && !(s.ion->GetPDGStable())) s.ion->SetPDGLifeTime(1.*ps);
+
+  return s.ion;
+}
+
+
+
+G4ThreeVector MultiSourceGenerator::GenerateVertex(const G4String& region)
+{
+  if (pool_size_ <= 0) return geom_->GenerateVertex(region);
+
+  std::unique_ptr<VertexPool>& pool = pools_[region];
+  if (!pool) {
+    const GeometryBase* geom = geom_;
+    pool.reset(new VertexPool([geom, region]() { return geom->GenerateVertex(region); },
+                              pool_size_));
+
+    // The pool depends only on the geometry, the region and its size
+    const NexusApp* app = dynamic_cast<const NexusApp*>(G4RunManager::GetRunManager());
+    G4String filename = "";
+    G4String key = region + " " + std::to_string(pool_size_);
+    if (app) key += " " + app->GeometryHash();
+    if (pool_cache_ != "")
+      filename = pool_cache_ + "/" + region + "_" + HashString(key) + ".vtx";
+    pool->Fill(filename, key);
+
+    // Events expected in the region, from the weights of its sources.
+    // Only the jobs reading the cache share the vertices.
+    if (app) {
+      G4double total = 0., in_region = 0.;
+      for (auto& source: sources_) {
+        total += source.weight;
+        if (source.generator == "" && source.region == region) in_region += source.weight;
+      }
+      pool->CheckSize(app->GetNumberOfEventsToBeProcessed() * in_region / total,
+                      filename != "" ? pool_jobs_ : 1);
+    }
+  }
+
+  return pool->Draw();
+}
+
+
+
+void MultiSourceGenerator::GeneratePrimaryVertex(G4Event* event)
+{
+  if (sources_.empty())
+    G4Exception("[MultiSourceGenerator]", "GeneratePrimaryVertex()",
+                FatalException, "No sources were defined.");
+
+  last_source_ = sampler_->SampleBin();
+  sources_[last_source_].events++;
+
+  if (generators_[last_source_]) {
+    generators_[last_source_]->GeneratePrimaryVertex(event);
+    return;
+  }
+
+  // Ion at rest in the region of the source, at the start-of-event time
+  G4PrimaryParticle* ion = new G4PrimaryParticle(IonDefinition(last_source_));
+  G4ThreeVector position = GenerateVertex(sources_[last_source_].region);
+  G4PrimaryVertex* vertex = new G4PrimaryVertex(position, 0.);
+
+  vertex->SetPrimary(ion);
+  event->AddPrimaryVertex(vertex);
+}
@@ -0,0 +1,125 @@
+// ----------------------------------------------------------------------------
+// nexus | MultiSourceGenerator.h
+//
+// This class is the primary generator of a mixture of sources, such as
+// the radioactive isotopes of a background model in several regions of
+// the geometry. Each source is given a weight (its activity, or any
+// relative weight); in every event one source is drawn with the alias
+// method, and the event is generated either as the decay of an ion at
+// rest in the region of the source, or by another generator. The source
+// chosen in each event is stored in the output file, as well as the
+// definition of the sources and the run info of their generators.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef MULTI_SOURCE_GENERATOR_H
+#define MULTI_SOURCE_GENERATOR_H
+
+#include "GeneratorInfo.h"
+
+#include <G4VPrimaryGenerator.hh>
+#include <G4ThreeVector.hh>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+class G4Event;
+class G4GenericMessenger;
+class G4ParticleDefinition;
+
+
+namespace nexus {
+
+  class GeometryBase;
+  class HistogramSampler;
+  class VertexPool;
+
+  class MultiSourceGenerator: public G4VPrimaryGenerator, public GeneratorInfo
+  {
+  public:
+    /// Constructor
+    MultiSourceGenerator();
+    /// Destructor
+    ~MultiSourceGenerator();
+
+    /// Draw a source and generate the primary vertices of the event with it
+    void GeneratePrimaryVertex(G4Event*);
+
+    /// Number of sources defined
+    G4int GetNumberOfSources() const;
+    /// Index of the source of the last event generated (-1 before the first one)
+    G4int GetLastSource() const;
+    /// Description of a source: region, isotope or generator, and weight
+    G4String GetSourceDescription(G4int source) const;
+    /// Number of events generated with a source
+    G4long GetSourceEvents(G4int source) const;
+
+    /// Definition and number of events of each source, followed
+    /// by the run info of its generator, if any
+    void GetRunInfo(GeneratorRunInfo&) const;
+    /// Index of the source of the last event generated
+    G4int GetEventSourceID() const;
+
+  private:
+    /// Add the decay of an ion in a region, given as
+    /// "<region> <Z> <A> <weight> [<energy level> <unit>]"
+    void AddIon(G4String);
+    /// Add one of the registered generators, given as "<name> <weight>".
+    /// Each generator can be added once, and it is configured
+    /// through its own commands after this one.
+    void AddGenerator(G4String);
+
+    /// Rebuild the alias table after adding a source
+    void UpdateSampler();
+
+    G4ParticleDefinition* IonDefinition(G4int source);
+
+    /// Vertex in the region of an ion source, taken from
+    /// the pool of the region if vertex pools are enabled
+    G4ThreeVector GenerateVertex(const G4String& region);
+
+  private:
+    struct Source {
+      G4String region;      ///< Region of the geometry (ions only)
+      G4int Z, A;           ///< Ion, if no generator is given
+      G4double energy_level;
+      G4ParticleDefinition* ion; ///< Looked up in the first event of the source
+      G4String generator;   ///< Name of the generator, if any
+      G4double weight;
+      G4long events;        ///< Number of events generated
+    };
+
+    G4GenericMessenger* msg_;
+    const GeometryBase* geom_;
+
+    G4bool decay_at_time_zero_;
+    G4int pool_size_;       ///< Number of pre-sampled vertices per region (none if 0)
+    G4String pool_cache_;   ///< Directory of the vertex pool cache
+    G4int pool_jobs_;       ///< Number of jobs sharing the cached pools
+    std::map<G4String, std::unique_ptr<VertexPool>> pools_; ///< [region]
+
+    std::vector<Source> sources_;
+    std::vector<std::unique_ptr<G4VPrimaryGenerator>> generators_; ///< [source]
+    HistogramSampler* sampler_; ///< Alias table of the source weights
+    G4int last_source_;
+  };
+
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline G4int MultiSourceGenerator::GetNumberOfSources() const
+  { return sources_.size(); }
+
+  inline G4int MultiSourceGenerator::GetLastSource() const
+  { return last_source_; }
+
+  inline G4long MultiSourceGenerator::GetSourceEvents(G4int source) const
+  { return sources_[source].events; }
+
+  inline G4int MultiSourceGenerator::GetEventSourceID() const
+  { return last_source_; }
+
+} // end namespace nexus
+
+#endif
@@ -14,6 +14,7 @@
 #include "FactoryBase.h"
 #include "RandomUtils.h"
 #include "IOUtils.h"
+#include "HistogramSampler.h"
 
 #include <G4Event.hh>
 #include <G4GenericMessenger.hh>
@@ -23,6 +24,8 @@
 #include <G4PrimaryVertex.hh>
 #include <G4Event.hh>
 #include <G4RandomDirection.hh>
+#include <G4Tubs.hh>
+#include <G4Orb.hh>
 #include <Randomize.hh>
 
 #include "CLHEP/Units/SystemOfUnits.h"
@@ -34,7 +37,9 @@ REGISTER_CLASS(MuonGenerator, G4VPrimaryGenerator)
 MuonGenerator::MuonGenerator():
   G4VPrimaryGenerator(), msg_(0), particle_definition_(0),
   use_lsc_dist_(true), axis_rotation_(150), rPhi_(NULL), user_dir_{}, energy_min_(0.),
-  energy_max_(0.), dist_name_("za"), bInitialize_(false), geom_(0), geom_solid_(0)
+  energy_max_(0.), dist_name_("za"), bInitialize_(false), geom_(0), geom_solid_(0),
+  target_("none"), target_center_(0., 0., 0.), target_radius_(0.), target_length_(0.),
+  target_dist_(0.), disk_radius_(0.), flux_sampler_(0)
 {
   msg_ = new G4GenericMessenger(this, "/Generator/MuonGenerator/",
 				"Control commands of muongenerator.");
@@ -71,6 +76,37 @@ MuonGenerator::MuonGenerator():
   rotation.SetParameterName("azimuth", false);
   rotation.SetRange("azimuth>0.");
 
+  G4GenericMessenger::Command& target_cmd =
+    msg_->DeclareProperty("target", target_,
+                          "Shape of the target the muons are aimed at "
+                          "(none = generate them in the region).");
+  target_cmd.SetCandidates("none cylinder sphere");
+
+  G4GenericMessenger::Command& target_center_cmd =
+    msg_->DeclarePropertyWithUnit("target_center", "mm", target_center_,
+                                  "Centre of the target.");
+  target_center_cmd.SetParameterName("target_center", false);
+
+  G4GenericMessenger::Command& target_radius_cmd =
+    msg_->DeclareProperty("target_radius", target_radius_, "Radius of the target.");
+  target_radius_cmd.SetUnitCategory("Length");
+  target_radius_cmd.SetParameterName("target_radius", false);
+  target_radius_cmd.SetRange("target_radius>0.");
+
+  G4GenericMessenger::Command& target_length_cmd =
+    msg_->DeclareProperty("target_length", target_length_,
+                          "Length of the target cylinder (along z).");
+  target_length_cmd.SetUnitCategory("Length");
+  target_length_cmd.SetParameterName("target_length", false);
+  target_length_cmd.SetRange("target_length>0.");
+
+  G4GenericMessenger::Command& target_dist_cmd =
+    msg_->DeclareProperty("target_distance", target_dist_,
+                          "Distance from the target centre to the generation disk.");
+  target_dist_cmd.SetUnitCategory("Length");
+  target_dist_cmd.SetParameterName("target_distance", false);
+  target_dist_cmd.SetRange("target_distance>0.");
+
   DetectorConstruction* detconst = (DetectorConstruction*) G4RunManager::GetRunManager()->GetUserDetectorConstruction();
   geom_ = detconst->GetGeometry();
 
@@ -80,6 +116,8 @@ MuonGenerator::MuonGenerator():
 MuonGenerator::~MuonGenerator()
 {
   delete msg_;
+  delete geom_solid_;
+  delete flux_sampler_;
 }
 
 void MuonGenerator::LoadMuonDistribution()
@@ -102,24 +140,27 @@ void MuonGenerator::LoadMuonDistribution()
                 FatalException, " Angular file specified with angle_dist=zae option selected, use angle_dist=za ");
   }
 
-  // Load in the data from csv file depending on 2D histogram sampling or 3D
-  if (dist_name_ == "za")
-    LoadHistData2D(ang_file_, flux_, azimuths_, zeniths_, azimuth_smear_, zenith_smear_);
+  // Load in the histogram (azimuth, zenith and, optionally, energy)
+  // from the csv file, or from its binary cache
+  flux_sampler_ = new HistogramSampler();
+  flux_sampler_->LoadCSV(ang_file_, (dist_name_ == "zae") ? 3 : 2);
 
   if (dist_name_ == "zae"){
-    LoadHistData3D(ang_file_, flux_, azimuths_, zeniths_, energies_, azimuth_smear_, zenith_smear_, energy_smear_);
-    
+
     // Check if the energy is in the desired range permitted by the binning range in the data file
-    CheckVarBounds(ang_file_, energy_min_/GeV, energy_max_/GeV, "energy"); 
+    G4double file_min, file_max;
+    flux_sampler_->GetRange(2, file_min, file_max);
+    if (energy_min_/GeV < file_min || energy_max_/GeV > file_max){
+      std::cout << "The minimum energy value allowed is: " << file_min << ", your input config min value is: " << energy_min_/GeV << std::endl;
+      std::cout << "The maximum energy value allowed is: " << file_max << ", your input config max value is: " << energy_max_/GeV << std::endl;
+      G4Exception("[MuonGenerator]", "LoadMuonDistribution()",
+                FatalException, " Specified range for sampling is outside permitted range or the min/max of the variable has not been set");
+    }
 
+    // Only the energy bins inside the range are sampled
+    flux_sampler_->SetWindow(2, energy_min_/GeV, energy_max_/GeV);
   }
 
-  // Convert flux vector to arr
-  auto arr_flux = flux_.data();
-
-  // Initialise the Random Number Generator based on the flux distribution (in bin index)
-  fRandomGeneral_ = new G4RandGeneral( arr_flux, flux_.size() );
-
 }
 
 void MuonGenerator::InitMuonZenithDist()
@@ -179,6 +220,9 @@ void MuonGenerator::GeneratePrimaryVertex(G4Event* event)
       std::cout << "[MuonGenerator]: Generating muons with user specified direction " << std::endl;
     }
 
+    if (target_ != "none")
+      SetupTarget();
+
     // Set Initialisation
     bInitialize_ = true;
 
@@ -201,7 +245,6 @@ void MuonGenerator::GeneratePrimaryVertex(G4Event* event)
   // Particle properties
   G4double mass          = particle_definition_->GetPDGMass();
   G4double energy        = kinetic_energy + mass;
-  G4ThreeVector position = geom_->GenerateVertex(region_);
 
   // Set default momentum and angular variables
   G4ThreeVector p_dir;
@@ -211,7 +254,6 @@ void MuonGenerator::GeneratePrimaryVertex(G4Event* event)
   // Momentum, zenith, azimuth (and energy) from angular distribution file
   if (use_lsc_dist_){
     GetDirection(p_dir, zenith, azimuth, energy, kinetic_energy, mass);
-    position = geom_->GenerateVertex(region_);
   }
   else {
 
@@ -239,6 +281,15 @@ void MuonGenerator::GeneratePrimaryVertex(G4Event* event)
 
   }
 
+  // The starting point is either sampled in the geometry region,
+  // independently of the direction, or aimed at the target
+  G4ThreeVector position;
+  G4double weight = 1.;
+  if (target_ == "none")
+    position = geom_->GenerateVertex(region_);
+  else
+    position = GenerateTargetedVertex(p_dir, weight);
+
   G4double pmod   = std::sqrt(energy*energy - mass*mass);
   G4double px = pmod * p_dir.x();
   G4double py = pmod * p_dir.y();
@@ -253,9 +304,10 @@ void MuonGenerator::GeneratePrimaryVertex(G4Event* event)
   // Create the new primary particle and set it some properties
   G4PrimaryParticle* particle =
     new G4PrimaryParticle(particle_definition_, px, py, pz);
+  particle->SetWeight(weight);
 
   // Add info to PrimaryVertex to be accessed from EventAction type class to make histos of variables generated here.
-  AddUserInfoToPV *info = new AddUserInfoToPV(zenith, azimuth);
+  AddUserInfoToPV *info = new AddUserInfoToPV(zenith, azimuth, weight);
 
   vertex->SetUserInformation(info);
 
@@ -265,6 +317,87 @@ void MuonGenerator::GeneratePrimaryVertex(G4Event* event)
 }
 
 
+void MuonGenerator::SetupTarget()
+{
+  if (target_radius_ <= 0. || (target_ == "cylinder" && target_length_ <= 0.))
+    G4Exception("[MuonGenerator]", "SetupTarget()", FatalException,
+                " The dimensions of the muon target must be set (target_radius, target_length).");
+
+  // The generation disk covers the projection of the target in any direction
+  if (target_ == "cylinder") {
+    geom_solid_ = new G4Tubs("MUON_TARGET", 0., target_radius_, target_length_/2.,
+                             0., twopi);
+    disk_radius_ = std::sqrt(target_radius_*target_radius_ +
+                             target_length_*target_length_/4.);
+  }
+  else {
+    geom_solid_ = new G4Orb("MUON_TARGET", target_radius_);
+    disk_radius_ = target_radius_;
+  }
+
+  if (target_dist_ < disk_radius_)
+    G4Exception("[MuonGenerator]", "SetupTarget()", FatalException,
+                " The generation disk intersects the muon target: increase target_distance.");
+
+  std::cout << "[MuonGenerator]: Aiming muons at a " << target_
+            << " target through a disk of area " << GetTargetArea()/cm2
+            << " cm2" << std::endl;
+}
+
+
+G4ThreeVector MuonGenerator::GenerateTargetedVertex(const G4ThreeVector& dir,
+                                                    G4double& weight) const
+{
+  // Disk perpendicular to the direction, upstream of the target centre
+  G4ThreeVector u = dir.orthogonal().unit();
+  G4ThreeVector v = dir.cross(u);
+  G4ThreeVector disk_center = target_center_ - target_dist_ * dir;
+
+  // Sample the disk until the muon crosses the target, i.e. uniformly
+  // on the projection of the target
+  G4ThreeVector vtx;
+  do {
+    G4double r   = disk_radius_ * std::sqrt(G4UniformRand());
+    G4double phi = twopi * G4UniformRand();
+    vtx = disk_center + r * (std::cos(phi) * u + std::sin(phi) * v);
+  } while (!CheckOverlap(vtx, dir));
+
+  // Muons are generated over the projected area of the target
+  // in their direction, but the rate is normalised to the disk
+  G4double proj_area = pi * disk_radius_ * disk_radius_;
+  if (target_ == "cylinder") {
+    G4double cos_theta = std::abs(dir.z());
+    G4double sin_theta = std::sqrt(1. - cos_theta*cos_theta);
+    proj_area = pi * target_radius_ * target_radius_ * cos_theta +
+      2. * target_radius_ * target_length_ * sin_theta;
+  }
+  weight = proj_area / GetTargetArea();
+
+  return vtx;
+}
+
+
+G4bool MuonGenerator::CheckOverlap(const G4ThreeVector& vtx,
+                                   const G4ThreeVector& dir) const
+{
+  return geom_solid_->DistanceToIn(vtx - target_center_, dir) != kInfinity;
+}
+
+
+G4double MuonGenerator::GetTargetArea() const
+{
+  return pi * disk_radius_ * disk_radius_;
+}
+
+
+void MuonGenerator::GetRunInfo(GeneratorRunInfo& info) const
+{
+  if (GetTargetArea() > 0.)
+    info.push_back(std::make_pair("muon_target_area",
+                                  std::to_string(GetTargetArea()/cm2) + " cm2"));
+}
+
+
 G4String MuonGenerator::MuonCharge() const
 {
 
@@ -291,17 +424,17 @@ void MuonGenerator::GetDirection(G4ThreeVector& dir, G4double& zenith, G4double&
 
   while(invalid_evt){
 
-    // Generate random index weighted by the bin contents
-    // Scale by flux vec size, then round to nearest integer to get an index
-    G4int RN_indx = GetRandBinIndex(fRandomGeneral_, flux_);
+    // Sample a bin weighted by its contents, with Gaussian smearing
+    // of the values to smooth from bin to bin
+    std::vector<G4double> values;
+    flux_sampler_->Sample(values, HistogramSampler::kGauss);
 
-    // Correct sampled values by Gaussian smearing
-    azimuth = Sample(azimuths_[RN_indx], true, azimuth_smear_[RN_indx]);
-    zenith  = Sample(zeniths_[RN_indx],  true, zenith_smear_[RN_indx]);
+    azimuth = values[0];
+    zenith  = values[1];
 
-    // Sample and update the energy if angle + energy option specified
+    // Update the energy if angle + energy option specified
     if (dist_name_ == "zae"){
-      energy = Sample(energies_[RN_indx]*GeV, true, energy_smear_[RN_indx]*GeV);
+      energy = values[2]*GeV;
       kinetic_energy = energy - mass;
 
     }
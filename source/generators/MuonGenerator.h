@@ -1,7 +1,17 @@
 // ----------------------------------------------------------------------------
 // nexus | MuonGenerator.h
 //
-// This class is the primary generator of muons
+// This class is the primary generator of muons.
+//
+// By default the starting point of the muons is sampled in a region of
+// the geometry, independently of their direction. Alternatively, they
+// can be aimed at a target (a cylinder along z or a sphere) around the
+// detector: the direction is sampled first, and the starting point is
+// then drawn on a disk perpendicular to it, upstream of the target, so
+// that every muon crosses the target. Each muon is given the weight
+// A_proj/A_disk, where A_proj is the projected area of the target in its
+// direction and A_disk the area of the disk, which is stored in the run
+// info. The rate is then (sum of weights / events) * A_disk * intensity.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -9,6 +19,8 @@
 #ifndef MUON_GENERATOR_H
 #define MUON_GENERATOR_H
 
+#include "GeneratorInfo.h"
+
 #include <G4VPrimaryGenerator.hh>
 #include <G4RotationMatrix.hh>
 #include <Randomize.hh>
@@ -23,9 +35,10 @@ class G4VSolid;
 namespace nexus {
 
   class GeometryBase;
+  class HistogramSampler;
 
 
-  class MuonGenerator: public G4VPrimaryGenerator
+  class MuonGenerator: public G4VPrimaryGenerator, public GeneratorInfo
   {
   public:
     /// Constructor
@@ -38,6 +51,14 @@ namespace nexus {
     /// in the event.
     void GeneratePrimaryVertex(G4Event*);
 
+    /// Area of the generation disk when muons are aimed
+    /// at a target (zero otherwise)
+    G4double GetTargetArea() const;
+
+    /// Area of the generation disk (muon_target_area),
+    /// when muons are aimed at a target
+    void GetRunInfo(GeneratorRunInfo&) const;
+
   private:
 
     // Sets the rotation angle and the spectra to
@@ -51,10 +72,19 @@ namespace nexus {
     void GetDirection(G4ThreeVector& dir, G4double& zenith, G4double& azimuth,
                       G4double& energy, G4double& kinetic_energy, G4double mass);
 
-    G4bool CheckOverlap(const G4ThreeVector& vtx, const G4ThreeVector& dir);
+    /// Checks whether a muon crosses the target
+    G4bool CheckOverlap(const G4ThreeVector& vtx, const G4ThreeVector& dir) const;
+
+    /// Builds the target solid and the generation disk
+    void SetupTarget();
+
+    /// Samples a starting point on the generation disk such that
+    /// the muon crosses the target, and returns its weight
+    G4ThreeVector GenerateTargetedVertex(const G4ThreeVector& dir,
+                                         G4double& weight) const;
 
     /// Load in the Muon Angular/Energy Distribution from CSV file
-    /// and initialise the discrete flux distribution
+    /// and initialise the flux sampler, restricted to the energy range
     void LoadMuonDistribution();
 
     // Initialise a cos(x)*cos(x) distribution to sample for zenith
@@ -87,13 +117,17 @@ namespace nexus {
 
     const GeometryBase* geom_; ///< Pointer to the detector geometry
 
-    G4VSolid * geom_solid_;
+    G4VSolid * geom_solid_; ///< Target the muons are aimed at
+
+    G4String target_; ///< Shape of the target (none, cylinder or sphere)
+    G4ThreeVector target_center_; ///< Centre of the target
+    G4double target_radius_; ///< Radius of the target
+    G4double target_length_; ///< Length of the target cylinder
+    G4double target_dist_; ///< Distance from the target centre to the generation disk
+    G4double disk_radius_; ///< Radius of the generation disk
 
-    std::vector<G4double> flux_, azimuths_, zeniths_, energies_; ///< Values of flux, azimuth and zenith from file
-    std::vector<G4double> azimuth_smear_; ///< List of Azimuth bin smear values
-    std::vector<G4double> zenith_smear_;  ///< List of Zenith bin smear values
-    std::vector<G4double> energy_smear_;  ///< List of Energy bin smear values
-    G4RandGeneral *fRandomGeneral_; ///< Pointer to the RNG flux distribution
+    HistogramSampler* flux_sampler_; ///< Flux distribution loaded from file
+    G4RandGeneral *fRandomGeneral_; ///< Pointer to the RNG zenith distribution
 
   };
 
@@ -14,6 +14,7 @@
 #include "GeometryBase.h"
 #include "OpticalMaterialProperties.h"
 #include "FactoryBase.h"
+#include "NexusPhysics.h"
 
 #include <G4GenericMessenger.hh>
 #include <G4ParticleDefinition.hh>
@@ -23,6 +24,7 @@
 #include <G4Event.hh>
 #include <G4RandomDirection.hh>
 #include <G4OpticalPhoton.hh>
+#include <Randomize.hh>
 
 #include "CLHEP/Units/SystemOfUnits.h"
 
@@ -91,7 +93,12 @@ void ScintillationGenerator::GeneratePrimaryVertex(G4Event* event)
   // Create a new vertex
   G4PrimaryVertex* vertex = new G4PrimaryVertex(position, time);
 
-  for ( G4int i = 0; i<nphotons_; i++)
+  // Photons are thinned by the optical prescale, like the scintillation
+  G4double prescale = NexusPhysics::GetOpticalPrescale();
+  G4int nphotons = (prescale < 1.) ?
+    CLHEP::RandBinomial::shoot(nphotons_, prescale) : nphotons_;
+
+  for ( G4int i = 0; i<nphotons; i++)
     {
       // Generate random direction by default
       G4ThreeVector _momentum_direction = G4RandomDirection();
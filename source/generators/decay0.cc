@@ -8,9 +8,14 @@
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
 
+#include <algorithm>
 #include <cfloat>
 #include <complex>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
 #include "decay0.h"
+#include "IOUtils.h"
 #include <G4RandomDirection.hh>
 #include <Randomize.hh>
 
@@ -49,13 +54,15 @@ modebbOld_(0)
   fillInfo();
 }
 decay0::decay0(const std::string nuclide, int finalStateNumber,
-               int decayModeNumber, double eRangeLow, double eRangeHigh):
+               int decayModeNumber, double eRangeLow, double eRangeHigh,
+               const std::string cacheDir):
 ready_(false),
 emass_(0.51099906),
 nuclideName_(nuclide),
 fsNum_(finalStateNumber),
 modebb_(decayModeNumber),
-modebbOld_(decayModeNumber)
+modebbOld_(decayModeNumber),
+cacheDir_(cacheDir)
 {
   ebb1_ = eRangeLow;
   ebb2_ = eRangeHigh; // for mode 4, 2nbbdecay.
@@ -206,18 +213,25 @@ void decay0::initSpectrum() {
   if ((modebb_ == 9) || (modebb_ == 10)) e0_ = bbNucl_.Qbb_ - Edlevel - bbNucl_.EK_ - 2.*emass_;
   if ((modebb_ == 11.) || (modebb_ == 12)) e0_ =bbNucl_.Qbb_ - Edlevel - 2.*bbNucl_.EK_;
   std::cerr << "decay0::decay0DoItbb , after edLevel correction e0 "  << e0_ << std::endl;
+  if(ebb1_ < 0.) ebb1_ = 0.;
+  if(ebb2_ > e0_) ebb2_ =e0_;
+  int iiMax = static_cast<int>(e0_*1000.); //kEv, as int if I followed correctly...
+  spthe2_.resize(iiMax);
+  // The spectrum only depends on the nuclide, decay mode, final state
+  // and energy window: read it back if it was already calculated.
+  if (readSpectrumCache()) {
+    std::cout << " decay0::initSpectrum, theoretical spectrum read from " << spectrumCacheFile() << std::endl;
+    buildE1Cdf();
+    return;
+  }
   // calculate the theoretical energy spectrum of first particle with step
   // of 1 keV and find its maximum. Original code is in GenSubb, intialization
   std::cout << " decay0::initSpectrum, Wait, please: calculation of theoretical spectrum. e0 is  " << e0_  <<  std::endl;
-  if(ebb1_ < 0.) ebb1_ = 0.;
-  if(ebb2_ > e0_) ebb2_ =e0_;
   spmax_ = -1.;
   const double relerr = 1.0e-4;
   const double errAbs = 0.;  // large error. We go for the relative error
   double rerrAchieved = 0.;
-  int iiMax = static_cast<int>(e0_*1000.); //kEv, as int if I followed correctly...
   spthe1_.resize(iiMax);
-  spthe2_.resize(iiMax);
   std::vector<double> params(10, 0.); // For integration.. oversized
   params[0] = emass_; //
   params[1] = bbNucl_.Zdbb_;
@@ -381,9 +395,98 @@ void decay0::initSpectrum() {
 	   }
 	   toallevents_ = r1/r2;
      }
+     writeSpectrumCache();
+     buildE1Cdf();
      std::cout << " .... starting the generation " << std::endl;
 }
 //
+// Binary cache of the spectrum of the first particle. Layout (native binary):
+// magic, e0, ebb1, ebb2, spmax, toallevents, number of bins, spthe1.
+//
+static const char decay0CacheMagic[8] = {'d','e','c','a','y','0','s','1'};
+
+std::string decay0::spectrumCacheFile() const {
+  if (cacheDir_.empty()) return "";
+  std::ostringstream name;
+  name << cacheDir_ << "/decay0_" << nuclideName_ << "_mode" << modebb_
+       << "_fs" << fsNum_ << "_" << static_cast<long>(ebb1_*1.e6 + 0.5)
+       << "_" << static_cast<long>(ebb2_*1.e6 + 0.5) << "eV.bin";
+  return name.str();
+}
+bool decay0::readSpectrumCache() {
+  const std::string filename = spectrumCacheFile();
+  if (filename.empty()) return false;
+  std::ifstream in(filename.c_str(), std::ios::binary);
+  if (!in.is_open()) return false;
+  char magic[8];
+  double header[5]; // e0, ebb1, ebb2, spmax, toallevents
+  uint64_t nBins = 0;
+  in.read(magic, sizeof(magic));
+  in.read(reinterpret_cast<char*>(header), sizeof(header));
+  in.read(reinterpret_cast<char*>(&nBins), sizeof(nBins));
+  if (!in.good() || std::memcmp(magic, decay0CacheMagic, sizeof(magic)) != 0) return false;
+  // A file written for other settings (e.g. after a change of Q value) is recomputed
+  if ((header[0] != e0_) || (header[1] != ebb1_) || (header[2] != ebb2_) ||
+      (nBins != static_cast<uint64_t>(e0_*1000.))) return false;
+  std::vector<double> spectrum(nBins);
+  in.read(reinterpret_cast<char*>(&spectrum[0]), nBins*sizeof(double));
+  if (!in.good()) return false;
+  spmax_ = header[3];
+  toallevents_ = header[4];
+  spthe1_.swap(spectrum);
+  return true;
+}
+void decay0::writeSpectrumCache() const {
+  const std::string filename = spectrumCacheFile();
+  if (filename.empty()) return;
+  std::ostringstream out;
+  const double header[5] = {e0_, ebb1_, ebb2_, spmax_, toallevents_};
+  const uint64_t nBins = spthe1_.size();
+  out.write(decay0CacheMagic, sizeof(decay0CacheMagic));
+  out.write(reinterpret_cast<const char*>(header), sizeof(header));
+  out.write(reinterpret_cast<const char*>(&nBins), sizeof(nBins));
+  out.write(reinterpret_cast<const char*>(&spthe1_[0]), nBins*sizeof(double));
+  // Failures are not fatal: the spectrum is recomputed by the next job
+  if (!nexus::WriteFileAtomically(filename, out.str()))
+    std::cerr << " decay0::writeSpectrumCache, cannot write " << filename << std::endl;
+}
+//
+// Cumulative distribution of the energy of the first particle, replacing the
+// acceptance/rejection loop of the original code. As there, bin k holds
+// e1 in [(k+1), (k+2)) keV, weighted by spthe1_[k], and e1 is restricted to
+// [0, ebb2] ([ebb1, ebb2] for mode 10).
+//
+void decay0::buildE1Cdf() {
+  const double eLow = (modebb_ == 10) ? ebb1_ : 0.;
+  const double eHigh = ebb2_;
+  cdfE1_.assign(spthe1_.size(), 0.);
+  double sum = 0.;
+  for (size_t k=0; k != spthe1_.size(); k++) {
+    const double lo = std::max(eLow, static_cast<double>(k+1)/1000.);
+    const double hi = std::min(eHigh, static_cast<double>(k+2)/1000.);
+    if ((hi > lo) && (spthe1_[k] > 0.)) sum += spthe1_[k]*(hi - lo);
+    cdfE1_[k] = sum;
+  }
+  if (sum <= 0.) {
+    std::cerr << " decay0::buildE1Cdf, empty spectrum in the energy window [" << ebb1_
+              << ", " << ebb2_ << "] MeV. No decay possible " << std::endl;
+    cdfE1_.clear();
+    return;
+  }
+  for (size_t k=0; k != cdfE1_.size(); k++) cdfE1_[k] /= sum;
+}
+double decay0::sampleE1() const {
+  const double eLow = (modebb_ == 10) ? ebb1_ : 0.;
+  const double u = G4UniformRand();
+  size_t k = std::lower_bound(cdfE1_.begin(), cdfE1_.end(), u) - cdfE1_.begin();
+  if (k >= cdfE1_.size()) k = cdfE1_.size() - 1;
+  // Skip empty bins, which have the same cumulative value as the previous one
+  while ((k + 1 < cdfE1_.size()) && (k == 0 ? cdfE1_[k] <= 0. : cdfE1_[k] <= cdfE1_[k-1])) k++;
+  const double lo = std::max(eLow, static_cast<double>(k+1)/1000.);
+  const double hi = std::min(ebb2_, static_cast<double>(k+2)/1000.);
+  return lo + (hi - lo)*G4UniformRand();
+}
+//
 // Subroutine GENBBsub generates the events of decay of natural
 // radioactive nuclides and various modes of double beta decay.
 // GENBB units: energy and moment - MeV and MeV/c; time - sec.
@@ -446,21 +549,12 @@ void decay0::decay0DoItbb(std::vector<decay0Part> &outPart) const {
     return;
   }
 
-// sampling the energies: first e-/e+ Acceptance/rejection method (Von Neumann), as far as I can tell.
+// sampling the energies: first e-/e+ from the cumulative distribution
+// of the tabulated spectrum (the original code used acceptance/rejection).
   double e2=0.;
   int numThrow = 0;
-//  std::cerr << " ebb1 " << ebb1_  <<  " ebb2 " << ebb2_ << std::endl;
-  while(true) {
-     if (modebb_ != 10) e1_ = ebb2_*G4UniformRand();
-     else e1_ = ebb1_ + (ebb2_ - ebb1_)*G4UniformRand();
-//     if ((e0_ - e1_) < 0.) continue; //not needed if energy range are set properly.
-     const size_t k = static_cast<size_t>(static_cast<int>(e1_*1000.) - 1);
-     if (k >= spthe1_.size()) continue;
-     if(spmax_*G4UniformRand() < spthe1_[k]) break;
-     numThrow++;
-     if (numThrow%1000 == 0) std::cerr << " Thrwing e1 ... " << numThrow
-                                       << " times ... " << std::endl;
-  }
+  if (cdfE1_.empty()) return;
+  e1_ = this->sampleE1();
 //  second e-/e+ or X-ray
    if    ((modebb_ == 1) || (modebb_ == 2) || (modebb_ == 3 ) ||
           (modebb_ == 7) || (modebb_ == 17) || (modebb_==18)) {
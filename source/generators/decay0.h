@@ -54,7 +54,8 @@ class decay0 {
 
      decay0();
      decay0(const std::string nuclide, int finalStateNumber, int decayModeNumber,
-                 double eRangeLow=0.0, double eRangeHigh=4.3); // no limits, be default. (for 2nbbdecay. )
+                 double eRangeLow=0.0, double eRangeHigh=4.3, // no limits, be default. (for 2nbbdecay. )
+                 const std::string cacheDir=""); // directory of the spectrum cache, none by default
      ~decay0();
     void decay0DoIt(std::vector<decay0Part> &outPart) const ;
     void fillInfo(); // to be used if the Nuclide, final state or decay mode is changed...Not advised..
@@ -73,6 +74,8 @@ class decay0 {
     // Internal variable once a bb emitter has been selected. Variable names are those from decay0, F77 version.
     double levelE_;
     std::vector<double> spthe1_;
+    std::vector<double> cdfE1_; // cumulative distribution of spthe1_ in the energy window
+    std::string cacheDir_; // directory of the binary spectrum cache (none if empty)
     double spmax_;
     float dataMasses_[4]; // only four, we don't simulate muons, hadrons, etc here.
     double toallevents_; // Normalization of the total decay probability:
@@ -93,6 +96,11 @@ class decay0 {
     mutable std::vector<double> spthe2_;
 
     void initSpectrum(); // Called from fillInfo, initialize array for matrix element, kinematics and so forth.
+    std::string spectrumCacheFile() const; // Cache file for the current nuclide, mode, final state and window
+    bool readSpectrumCache(); // Fill spthe1_, spmax_ and toallevents_ from the cache, if present
+    void writeSpectrumCache() const;
+    void buildE1Cdf(); // Cumulative distribution used to sample the first particle
+    double sampleE1() const;
     void decay0DoItbb(std::vector<decay0Part> &outPart) const; // Main method, generate the two electrons.
     void Ba136low(std::vector<decay0Part> &outPart) const;  // Baryum 136 de-excitation.
 //    void Xe130low(std::vector<decay0Part> &outPart) const;  // Xenon de-excitation. // we (NEXT) don't care...
@@ -155,7 +163,7 @@ class decay0 {
     inline std::string GetNuclide() const { return nuclideName_;}
     inline size_t GetFinalStateNumber() { return fsNum_;}
     inline size_t GetDecayModeNumber() { return modebb_;}
-    inline double GetEffectiveRatioToOfEvents() {return toallevents_; }
+    inline double GetEffectiveRatioToOfEvents() const {return toallevents_; }
 
 };
 #endif
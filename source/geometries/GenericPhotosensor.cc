@@ -44,6 +44,7 @@ GenericPhotosensor::GenericPhotosensor(G4String name,
   sensor_depth_       (-1),
   mother_depth_       (0),
   naming_order_       (0),
+  id_offset_          (0),
   time_binning_       (1.0 * us),
   visibility_         (false)
 {
@@ -244,6 +245,7 @@ void GenericPhotosensor::Construct()
     sensdet->SetDetectorVolumeDepth(sensor_depth_);
     sensdet->SetMotherVolumeDepth  (mother_depth_);
     sensdet->SetDetectorNamingOrder(naming_order_);
+    sensdet->SetDetectorIDOffset   (id_offset_);
     sensdet->SetTimeBinning        (time_binning_);
 
     G4SDManager::GetSDMpointer()->AddNewDetector(sensdet);
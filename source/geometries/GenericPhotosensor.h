@@ -50,6 +50,7 @@ namespace nexus {
     void SetSensorDepth          (G4int sensor_depth);
     void SetMotherDepth          (G4int mother_depth);
     void SetNamingOrder          (G4int naming_order);
+    void SetIDOffset             (G4int id_offset);
 
   private:
 
@@ -76,6 +77,7 @@ namespace nexus {
     G4int    sensor_depth_;
     G4int    mother_depth_;
     G4int    naming_order_;
+    G4int    id_offset_;
     G4double time_binning_;
 
     G4bool visibility_;
@@ -111,6 +113,9 @@ namespace nexus {
   inline void GenericPhotosensor::SetNamingOrder(G4int naming_order)
   { naming_order_ = naming_order; }
 
+  inline void GenericPhotosensor::SetIDOffset(G4int id_offset)
+  { id_offset_ = id_offset; }
+
 
 } // namespace nexus
 
@@ -44,7 +44,8 @@ namespace nexus {
     gate_sapphire_wdw_distance_  ((1458.2 - 0.1) * mm),
 
     specific_vertex_{},
-    lab_walls_(false)
+    lab_walls_(false),
+    detail_("full")
   {
 
     msg_ = new G4GenericMessenger(this, "/Geometry/Next100/",
@@ -55,6 +56,14 @@ namespace nexus {
 
     msg_->DeclareProperty("lab_walls", lab_walls_, "Placement of Hall A walls");
 
+    G4GenericMessenger::Command& detail_cmd =
+      msg_->DeclareProperty("detail", detail_,
+                            "Level of detail of the geometry: full, no-optics "
+                            "(SiPM boards without optical elements; the PMTs and "
+                            "the energy plane keep their optics) or inner-only "
+                            "(no shielding, pedestal or lab walls).");
+    detail_cmd.SetCandidates("full no-optics inner-only");
+
   // The following methods must be invoked in this particular
   // order since some of them depend on the previous ones
 
@@ -89,6 +98,10 @@ namespace nexus {
 
   void Next100::Construct()
   {
+    if (detail_ == "inner-only" && lab_walls_)
+      G4Exception("[Next100]", "Construct()", FatalException,
+                  "The lab walls cannot be built with detail inner-only!");
+
     // LAB /////////////////////////////////////////////////////////////
     // This is just a volume of air surrounding the detector so that
     // events (from calibration sources or cosmic rays) can be generated
@@ -125,18 +138,29 @@ namespace nexus {
     G4ThreeVector vessel_displacement = shielding_->GetAirDisplacement(); // explained below
     gate_zpos_in_vessel_ = vessel_->GetELzCoord();
 
-    // SHIELDING
-    shielding_->Construct();
-    shielding_->SetELzCoord(gate_zpos_in_vessel_);
-    G4LogicalVolume* shielding_logic     = shielding_->GetLogicalVolume();
-    G4LogicalVolume* shielding_air_logic = shielding_->GetAirLogicalVolume();
+    G4ThreeVector gate_pos(0., 0., -gate_zpos_in_vessel_);
 
-    // Recall that airbox is slighly displaced in Y dimension. In order to avoid
-    // mistmatch with vertex generators, we place the vessel in the center of the world volume
-    new G4PVPlacement(0, -vessel_displacement, vessel_logic,
-                      "VESSEL", shielding_air_logic, false, 0);
+    // SHIELDING
+    // With detail inner-only, the vessel is placed directly in the lab,
+    // in the same position it has inside the shielding.
+    G4LogicalVolume* shielding_logic = nullptr;
+    if (detail_ == "inner-only") {
+      new G4PVPlacement(0, gate_pos, vessel_logic, "VESSEL", lab_logic_, false, 0);
+    }
+    else {
+      shielding_->Construct();
+      shielding_->SetELzCoord(gate_zpos_in_vessel_);
+      shielding_logic = shielding_->GetLogicalVolume();
+      G4LogicalVolume* shielding_air_logic = shielding_->GetAirLogicalVolume();
+
+      // Recall that airbox is slighly displaced in Y dimension. In order to avoid
+      // mistmatch with vertex generators, we place the vessel in the center of the world volume
+      new G4PVPlacement(0, -vessel_displacement, vessel_logic,
+                        "VESSEL", shielding_air_logic, false, 0);
+    }
 
     // INNER ELEMENTS
+    inner_elements_->SetOptics(detail_ != "no-optics");
     inner_elements_->SetLogicalVolume(vessel_internal_logic);
     inner_elements_->SetPhysicalVolume(vessel_internal_phys);
     inner_elements_->SetELzCoord(gate_zpos_in_vessel_);
@@ -152,7 +176,6 @@ namespace nexus {
     ics_->SetPortZpositions(vessel_->GetPortZpositions());
     ics_->Construct();
 
-    G4ThreeVector gate_pos(0., 0., -gate_zpos_in_vessel_);
     if (lab_walls_){
       G4ThreeVector castle_pos(0., hallA_walls_->GetLSCHallACastleY(),
                                hallA_walls_->GetLSCHallACastleZ());
@@ -162,7 +185,7 @@ namespace nexus {
       new G4PVPlacement(0, gate_pos - castle_pos, hallA_logic_,
                         "Hall_A", lab_logic_, false, 0, false);
     }
-    else {
+    else if (shielding_logic) {
       new G4PVPlacement(0, gate_pos, shielding_logic, "LEAD_BOX", lab_logic_, false, 0);
     }
 
@@ -177,6 +200,8 @@ namespace nexus {
   {
     G4ThreeVector vertex(0.,0.,0.);
 
+    CheckRegionDetail(region);
+
     // Air around shielding
     if (region == "LAB") {
       vertex = lab_gen_->GenerateVertex("INSIDE");
@@ -261,4 +286,25 @@ namespace nexus {
     return vertex;
   }
 
+
+  void Next100::CheckRegionDetail(const G4String& region) const
+  {
+    if (detail_ != "inner-only") return;
+
+    if ((region == "SHIELDING_LEAD")  ||
+        (region == "SHIELDING_STEEL") ||
+        (region == "INNER_AIR") ||
+        (region == "EXTERNAL") ||
+        (region == "SHIELDING_STRUCT") ||
+        (region == "PEDESTAL") ||
+        (region == "BUBBLE_SEAL") ||
+        (region == "EDPM_SEAL") ||
+        (region == "HALLA_INNER") ||
+        (region == "HALLA_OUTER")) {
+      G4Exception("[Next100]", "GenerateVertex()", FatalException,
+                  ("Vertex generation region " + region +
+                   " is not built with detail inner-only!").c_str());
+    }
+  }
+
 } //end namespace nexus
@@ -43,6 +43,9 @@ namespace nexus {
     void BuildLab();
     void Construct();
 
+    /// Fatal error if the region is not built with the chosen level of detail
+    void CheckRegionDetail(const G4String& region) const;
+
 
   private:
     // Detector dimensions
@@ -74,6 +77,9 @@ namespace nexus {
 
     /// Whether or not to build LSC HallA.
     G4bool lab_walls_;
+
+    /// Level of detail of the geometry (full, no-optics, inner-only)
+    G4String detail_;
   };
 
 } // end namespace nexus
@@ -22,6 +22,7 @@
 #include <G4Material.hh>
 #include <Randomize.hh>
 #include <G4TransportationManager.hh>
+#include <G4Region.hh>
 
 
 namespace nexus {
@@ -147,6 +148,10 @@ namespace nexus {
     new G4PVPlacement(0, G4ThreeVector(0., 0., ics_z_pos), ics_logic,
                       "ICS", mother_logic_, false, 0, false);
 
+    // Region of the ICS, for per-region production cuts and track killing
+    G4Region* ics_region = new G4Region("ICS");
+    ics_region->AddRootLogicalVolume(ics_logic);
+
 
     // SETTING VISIBILITIES   //////////
     if (visibility_) {
@@ -30,6 +30,7 @@ namespace nexus {
     mother_logic_(nullptr),
     mother_phys_ (nullptr),
     gas_(nullptr),
+    optics_(true),
     field_cage_    (new Next100FieldCage()),
     energy_plane_  (new Next100EnergyPlane()),
     tracking_plane_(new Next100TrackingPlane()),
@@ -79,6 +80,7 @@ namespace nexus {
     tracking_plane_->SetMotherPhysicalVolume(mother_phys_);
     tracking_plane_->SetELzCoord(gate_zpos);
     tracking_plane_->SetELtoTPdistance(gate_tracking_plane_distance_);
+    tracking_plane_->SetOptics(optics_);
     tracking_plane_->Construct();
   }
 
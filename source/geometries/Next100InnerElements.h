@@ -41,6 +41,8 @@ namespace nexus {
     void SetPhysicalVolume(G4VPhysicalVolume*);
     void SetELtoTPdistance(G4double);
     void SetELtoSapphireWDWdistance(G4double);
+    /// Build the optical elements of the photosensor planes
+    void SetOptics(G4bool);
 
     /// Return the relative position respect to the rest of NEXT100 geometry
     G4ThreeVector GetPosition() const;
@@ -65,6 +67,8 @@ namespace nexus {
     G4double pressure_;
     G4double temperature_;
 
+    G4bool optics_;
+
     // Detector parts
     Next100FieldCage*     field_cage_;
     Next100EnergyPlane*   energy_plane_;
@@ -83,6 +87,10 @@ namespace nexus {
     gate_sapphire_wdw_distance_ = distance;
   }
 
+  inline void Next100InnerElements::SetOptics(G4bool optics){
+    optics_ = optics;
+  }
+
 } // end namespace nexus
 
 #endif
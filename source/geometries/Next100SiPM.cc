@@ -29,6 +29,7 @@ using namespace nexus;
 
 Next100SiPM::Next100SiPM():
   GeometryBase(),
+  dimensions_         (3.0 * mm, 4.0 * mm, 1.3 * mm),
   sensor_depth_       (-1),
   mother_depth_       (0),
   naming_order_       (0),
@@ -46,7 +47,8 @@ Next100SiPM::~Next100SiPM()
 
 G4ThreeVector Next100SiPM::GetDimensions() const
 {
-  return dimensions_;
+  // Known before construction, since the coating is part of the SiPM
+  return dimensions_ + G4ThreeVector(0., 0., coating_thickn_);
 }
 
 
@@ -56,15 +58,9 @@ void Next100SiPM::Construct()
   //dimensions are increased in case of SiPM coating
   G4String sipm_name = "SIPM_S13372";
 
-  G4double sipm_width  = 3.0 * mm;
-  G4double sipm_length = 4.0 * mm;
-  G4double sipm_thickn = 1.3 * mm;
-
-  sipm_thickn = sipm_thickn + coating_thickn_;
-
-  dimensions_.setX(sipm_width);
-  dimensions_.setY(sipm_length);
-  dimensions_.setZ(sipm_thickn);
+  G4double sipm_width  = GetDimensions().x();
+  G4double sipm_length = GetDimensions().y();
+  G4double sipm_thickn = GetDimensions().z();
 
   G4Box* sipm_solid_vol =
     new G4Box(sipm_name, sipm_width/2., sipm_length/2., sipm_thickn/2.);
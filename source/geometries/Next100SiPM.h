@@ -24,7 +24,7 @@ namespace nexus {
     /// Destructor
     ~Next100SiPM();
 
-    // Return dimensions of the SiPM
+    // Return dimensions of the SiPM, including its coating
     G4ThreeVector GetDimensions() const;
 
     // Invoke this method to build the volumes of the geometry
@@ -39,7 +39,7 @@ namespace nexus {
     void SetVisibility          (G4bool visibility);
 
   private:
-    G4ThreeVector dimensions_;
+    G4ThreeVector dimensions_; // Without the coating
 
     G4int    sensor_depth_;
     G4int    mother_depth_;
@@ -41,6 +41,7 @@ Next100SiPMBoard::Next100SiPMBoard():
   time_binning_    (1. * microsecond),
   visibility_      (true),
   sipm_visibility_ (false),
+  optics_          (true),
   mpv_             (nullptr),
   vtxgen_          (nullptr),
   sipm_            (new Next100SiPM())
@@ -121,6 +122,53 @@ void Next100SiPMBoard::Construct()
   new G4PVPlacement(nullptr, G4ThreeVector(0., 0., mask_zpos),
                     mask_logic_vol, mask_name, board_logic_vol, false, 0, false);
 
+  // MASK GAS HOLE ///////////////////////////////////////////////////
+
+  G4String mask_hole_name   = "SIPM_BOARD_MASK_HOLE";
+  G4double wls_thickness    = 1. * um;
+  G4double mask_hole_length = mask_thickness_ - wls_thickness;
+  G4double mask_hole_zpos   = - mask_thickness_/2. + mask_hole_length/2.;
+  G4double mask_hole_x = 6.0 * mm;
+  G4double mask_hole_y = 5.0 * mm;
+
+  G4Box* mask_hole_solid_vol =
+    new G4Box(mask_hole_name, mask_hole_x/2., mask_hole_y/2., mask_hole_length/2.);
+
+  G4LogicalVolume* mask_hole_logic_vol =
+    new G4LogicalVolume(mask_hole_solid_vol, mother_gas, mask_hole_name);
+
+  mask_hole_logic_vol->SetVisAttributes(G4VisAttributes::GetInvisible());
+
+  // The SiPM positions are the same with or without optics
+  sipm_->SetSiPMCoatingThickness(2. * micrometer);
+  G4double sipm_thickn = sipm_->GetDimensions().z();
+  G4double zpos = board_thickness_ + sipm_thickn/2.;
+
+  // Without optics, the board is made only of the kapton, the teflon
+  // mask and its gas holes: no WLS coatings, SiPMs or optical surfaces.
+  if (!optics_) {
+    G4int counter = 0;
+    for (auto i=0; i<8; i++) {
+      G4double xpos = -size_/2. + margin_ + i * pitch_;
+      for (auto j=0; j<8; j++) {
+        G4double ypos = -size_/2. + margin_ + j * pitch_;
+        sipm_positions_.push_back(G4ThreeVector(xpos, ypos, zpos));
+        new G4PVPlacement(nullptr, G4ThreeVector(xpos, ypos, mask_hole_zpos),
+                          mask_hole_logic_vol, mask_hole_name, mask_logic_vol,
+                          false, counter, false);
+        counter++;
+      }
+    }
+
+    vtxgen_ = new BoxPointSampler(size_, size_, board_thickness_+mask_thickness_, 0.,
+                                  G4ThreeVector(0., 0., 0));
+
+    if (visibility_) mask_logic_vol->SetVisAttributes(LightBlue());
+    else mask_logic_vol->SetVisAttributes(G4VisAttributes::GetInvisible());
+    board_logic_vol->SetVisAttributes(G4VisAttributes::GetInvisible());
+    return;
+  }
+
   G4OpticalSurface* mask_opsurf =
     new G4OpticalSurface(mask_name+"_OPSURF", unified, ground, dielectric_metal);
   mask_opsurf->SetMaterialPropertiesTable(opticalprops::PTFE());
@@ -130,7 +178,6 @@ void Next100SiPMBoard::Construct()
   // WLS COATING /////////////////////////////////////////////////////
 
   G4String mask_wls_name = "SIPM_BOARD_MASK_WLS";
-  G4double wls_thickness = 1. * um;
   G4double mask_wls_zpos = mask_thickness_/2. - wls_thickness/2.;
 
   G4Box* mask_wls_solid_vol =
@@ -156,22 +203,6 @@ void Next100SiPMBoard::Construct()
                              mpv_, mask_wls_phys_vol, mask_wls_opsurf);
 
 
-  // MASK GAS HOLE ///////////////////////////////////////////////////
-
-  G4String mask_hole_name   = "SIPM_BOARD_MASK_HOLE";
-  G4double mask_hole_length = mask_thickness_ - wls_thickness;
-  G4double mask_hole_zpos   = - mask_thickness_/2. + mask_hole_length/2.;
-  G4double mask_hole_x = 6.0 * mm;
-  G4double mask_hole_y = 5.0 * mm;
-
-  G4Box* mask_hole_solid_vol =
-    new G4Box(mask_hole_name, mask_hole_x/2., mask_hole_y/2., mask_hole_length/2.);
-
-  G4LogicalVolume* mask_hole_logic_vol =
-    new G4LogicalVolume(mask_hole_solid_vol, mother_gas, mask_hole_name);
-
-  // (Placement of this volume below.)
-
   // HOLE WALLs WLS ///////////////////////////////////////////////////
 
   G4String mask_wall_wls_name = "SIPM_BOARD_MASK_WALL_WLS";
@@ -217,15 +248,12 @@ void Next100SiPMBoard::Construct()
   // SILICON PHOTOMULTIPLIER (SIPM) //////////////////////////////////
 
   sipm_->SetVisibility(sipm_visibility_);
-  sipm_->SetSiPMCoatingThickness(2. * micrometer);
   sipm_->SetTimeBinning(time_binning_);
   sipm_->SetSensorDepth(2);
   sipm_->SetMotherDepth(4);
   sipm_->SetNamingOrder(1000);
   sipm_->Construct();
 
-  G4double sipm_thickn = sipm_->GetDimensions().z();
-
   G4double sipm_zpos = - mask_hole_length/2. + sipm_thickn/2.;
 
   new G4PVPlacement(nullptr, G4ThreeVector(0., 0., sipm_zpos),
@@ -236,7 +264,6 @@ void Next100SiPMBoard::Construct()
 
   // Placing now 8x8 replicas of the gas hole and SiPM
 
-  G4double zpos = board_thickness_ + sipm_thickn/2.;
   G4VPhysicalVolume* mask_hole_phys_vol;
 
   G4int counter = 0;
@@ -283,7 +310,6 @@ void Next100SiPMBoard::Construct()
   else{
     mask_logic_vol  ->SetVisAttributes(G4VisAttributes::GetInvisible());
   }
-  mask_hole_logic_vol    ->SetVisAttributes(G4VisAttributes::GetInvisible());
   mask_wls_logic_vol     ->SetVisAttributes(G4VisAttributes::GetInvisible());
   mask_wls_hole_logic_vol->SetVisAttributes(G4VisAttributes::GetInvisible());
   wall_wls_logic_vol     ->SetVisAttributes(G4VisAttributes::GetInvisible());
@@ -44,6 +44,9 @@ namespace nexus {
 
     const std::vector<G4ThreeVector>& GetSiPMPositions() const;
 
+    // Build the optical elements (WLS coatings, SiPMs and surfaces)
+    void SetOptics(G4bool);
+
   private:
     G4GenericMessenger* msg_;
     G4double size_, pitch_, margin_;
@@ -51,6 +54,7 @@ namespace nexus {
     G4double time_binning_;
     std::vector<G4ThreeVector> sipm_positions_;
     G4bool   visibility_, sipm_visibility_;
+    G4bool   optics_;
     G4VPhysicalVolume*  mpv_;
     BoxPointSampler*    vtxgen_;
     Next100SiPM* sipm_;
@@ -68,6 +72,9 @@ namespace nexus {
   inline const std::vector<G4ThreeVector>& Next100SiPMBoard::GetSiPMPositions() const
   { return sipm_positions_; }
 
+  inline void Next100SiPMBoard::SetOptics(G4bool optics)
+  { optics_ = optics; }
+
 } // namespace nexus
 
 #endif
@@ -35,6 +35,7 @@ Next100TrackingPlane::Next100TrackingPlane():
   distance_board_board_   (   2.*mm),
 
   visibility_(true),
+  optics_(true),
   sipm_board_geom_(new Next100SiPMBoard),
   copper_plate_gen_(nullptr),
   mpv_(nullptr),
@@ -97,6 +98,7 @@ void Next100TrackingPlane::Construct()
   // SIPM BOARDS /////////////////////////////////////////////////////
 
   sipm_board_geom_->SetMotherPhysicalVolume(mpv_);
+  sipm_board_geom_->SetOptics(optics_);
   sipm_board_geom_->Construct();
   G4LogicalVolume* sipm_board_logic = sipm_board_geom_->GetLogicalVolume();
 
@@ -35,6 +35,8 @@ namespace nexus {
     //
     void SetMotherPhysicalVolume(G4VPhysicalVolume*);
     void SetELtoTPdistance(G4double);
+    // Build the optical elements of the SiPM boards
+    void SetOptics(G4bool);
     //
     void Construct() override;
     //
@@ -54,6 +56,7 @@ namespace nexus {
     std::vector<G4ThreeVector> plug_pos_;
 
     G4bool visibility_;
+    G4bool optics_;
 
     Next100SiPMBoard* sipm_board_geom_;
 
@@ -74,6 +77,9 @@ namespace nexus {
     gate_tp_dist_ = distance;
   }
 
+  inline void Next100TrackingPlane::SetOptics(G4bool optics)
+  { optics_ = optics; }
+
 } // namespace nexus
 
 #endif
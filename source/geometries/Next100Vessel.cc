@@ -25,6 +25,7 @@
 #include <Randomize.hh>
 #include <G4TransportationManager.hh>
 #include <G4UnitsTable.hh>
+#include <G4Region.hh>
 
 #include <CLHEP/Units/SystemOfUnits.h>
 
@@ -271,6 +272,13 @@ namespace nexus {
 
     G4LogicalVolume* vessel_gas_logic = new G4LogicalVolume(vessel_gas_solid, vessel_gas_mat, "VESSEL_GAS");
     internal_logic_vol_ = vessel_gas_logic;
+
+    // Regions of the vessel and of the inner detector (everything
+    // inside the vessel), for per-region production cuts and track killing
+    G4Region* vessel_region = new G4Region("VESSEL");
+    vessel_region->AddRootLogicalVolume(vessel_logic);
+    G4Region* inner_region = new G4Region("INNER_DETECTOR");
+    inner_region->AddRootLogicalVolume(vessel_gas_logic);
     SetELzCoord(-body_length_/2. - endcap_in_z_width_ + endcap_tp_distance_ + gate_tp_distance_);
     internal_phys_vol_ =
       new G4PVPlacement(0, G4ThreeVector(0.,0.,0.), vessel_gas_logic,
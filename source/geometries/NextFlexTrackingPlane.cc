@@ -17,6 +17,7 @@
 #include "GenericPhotosensor.h"
 #include "SensorSD.h"
 #include "Visibilities.h"
+#include "PositionListParameterisation.h"
 
 #include <G4UnitsTable.hh>
 #include <G4GenericMessenger.hh>
@@ -32,6 +33,7 @@
 #include <G4VisAttributes.hh>
 #include <G4MultiUnion.hh>
 #include <G4PVPlacement.hh>
+#include <G4PVParameterised.hh>
 #include <G4OpticalSurface.hh>
 #include <G4LogicalSkinSurface.hh>
 #include <G4LogicalBorderSurface.hh>
@@ -60,7 +62,10 @@ NextFlexTrackingPlane::NextFlexTrackingPlane():
   SiPM_binning_      ( 1.  * us),   // SiPMs time binning size
   copper_thickness_  (12.  * cm),   // Thickness of the copper plate
   teflon_thickness_  ( 5.  * mm),   // Thickness of the teflon mask
-  teflon_hole_diam_  ( 7.  * mm)    // Diameter of teflon mask holes
+  teflon_hole_diam_  ( 7.  * mm),   // Diameter of teflon mask holes
+  teflon_daughter_holes_(false),
+  teflon_hole_logic_ (nullptr),
+  SiPM_parameterised_(false)
 {
   // Messenger
   msg_ = new G4GenericMessenger(this, "/Geometry/NextFlex/",
@@ -125,6 +130,14 @@ void NextFlexTrackingPlane::DefineConfigurationParameters()
   teflon_hole_diam_cmd.SetUnitCategory("Length");
   teflon_hole_diam_cmd.SetRange("tp_teflon_hole_diam>=0.");
 
+  msg_->DeclareProperty("tp_teflon_daughter_holes", teflon_daughter_holes_,
+                        "Build the teflon mask holes as daughter volumes "
+                        "(faster navigation) instead of boolean subtractions.");
+
+  msg_->DeclareProperty("tp_sipm_parameterised", SiPM_parameterised_,
+                        "Place the SiPMs (or the mask holes) with a single "
+                        "parameterised volume instead of one placement each.");
+
   // UV shifting material
   msg_->DeclareProperty("tp_wls_mat", wls_mat_name_,
                         "TP UV wavelength shifting material name");
@@ -301,23 +314,27 @@ void NextFlexTrackingPlane::BuildTeflon()
     new G4Tubs(teflon_name + "_NOHOLE", 0., diameter_/2.,
 	       teflon_thickness_/2., 0, twopi);
 
+  G4VSolid* teflon_solid = teflon_nh_solid;
+
   // Making the Teflon holes (a little bit thicker to prevent subtraction problems)
-  G4Tubs* teflon_hole_solid =
-    new G4Tubs(teflon_name + "_HOLE", 0., teflon_hole_diam_/2.,
-	       teflon_thickness_/2. + 0.5*mm, 0, twopi);
+  if (!teflon_daughter_holes_) {
+    G4Tubs* teflon_hole_solid =
+      new G4Tubs(teflon_name + "_HOLE", 0., teflon_hole_diam_/2.,
+                 teflon_thickness_/2. + 0.5*mm, 0, twopi);
 
-  G4MultiUnion* teflon_holes_solid = new G4MultiUnion(teflon_name + "_HOLES");
+    G4MultiUnion* teflon_holes_solid = new G4MultiUnion(teflon_name + "_HOLES");
 
-  G4RotationMatrix rotm = G4RotationMatrix();
+    G4RotationMatrix rotm = G4RotationMatrix();
 
-  for (G4int i=0; i<num_SiPMs_; i++) {
-    G4Transform3D hole_transform = G4Transform3D(rotm, SiPM_positions_[i]);
-    teflon_holes_solid->AddNode(*teflon_hole_solid, hole_transform);
-  }
-  teflon_holes_solid->Voxelize();
+    for (G4int i=0; i<num_SiPMs_; i++) {
+      G4Transform3D hole_transform = G4Transform3D(rotm, SiPM_positions_[i]);
+      teflon_holes_solid->AddNode(*teflon_hole_solid, hole_transform);
+    }
+    teflon_holes_solid->Voxelize();
 
-  G4SubtractionSolid* teflon_solid =
-    new G4SubtractionSolid(teflon_name, teflon_nh_solid, teflon_holes_solid);
+    teflon_solid =
+      new G4SubtractionSolid(teflon_name, teflon_nh_solid, teflon_holes_solid);
+  }
 
   G4LogicalVolume* teflon_logic =
     new G4LogicalVolume(teflon_solid, teflon_mat_, teflon_name);
@@ -339,21 +356,27 @@ void NextFlexTrackingPlane::BuildTeflon()
     new G4Tubs(teflon_wls_name + "_NOHOLE", 0., diameter_/2.,
 	       wls_thickness_/2., 0, twopi);
 
+  G4VSolid* teflon_wls_solid = teflon_wls_nh_solid;
+
   // Making the TEFLON_WLS holes (a little bit thicker to prevent subtraction problems)
-  G4Tubs* wls_hole_solid = 
-    new G4Tubs(teflon_wls_name + "_HOLE", 0., teflon_hole_diam_/2.,
-	       wls_thickness_/2. + 0.5*mm, 0, twopi);
+  if (!teflon_daughter_holes_) {
+    G4Tubs* wls_hole_solid =
+      new G4Tubs(teflon_wls_name + "_HOLE", 0., teflon_hole_diam_/2.,
+                 wls_thickness_/2. + 0.5*mm, 0, twopi);
 
-  G4MultiUnion* wls_holes_solid = new G4MultiUnion(teflon_wls_name + "_HOLES");
+    G4MultiUnion* wls_holes_solid = new G4MultiUnion(teflon_wls_name + "_HOLES");
 
-  for (G4int i=0; i<num_SiPMs_; i++){
-    G4Transform3D wls_hole_transform = G4Transform3D(rotm, SiPM_positions_[i]);
-    wls_holes_solid->AddNode(*wls_hole_solid, wls_hole_transform); 
-  }
-  wls_holes_solid->Voxelize();
+    G4RotationMatrix rotm = G4RotationMatrix();
+
+    for (G4int i=0; i<num_SiPMs_; i++){
+      G4Transform3D wls_hole_transform = G4Transform3D(rotm, SiPM_positions_[i]);
+      wls_holes_solid->AddNode(*wls_hole_solid, wls_hole_transform);
+    }
+    wls_holes_solid->Voxelize();
 
-  G4SubtractionSolid* teflon_wls_solid = 
-    new G4SubtractionSolid(teflon_wls_name, teflon_wls_nh_solid, wls_holes_solid);	  
+    teflon_wls_solid =
+      new G4SubtractionSolid(teflon_wls_name, teflon_wls_nh_solid, wls_holes_solid);
+  }
 
   G4LogicalVolume* teflon_wls_logic =
     new G4LogicalVolume(teflon_wls_solid, wls_mat_, teflon_wls_name);
@@ -372,6 +395,51 @@ void NextFlexTrackingPlane::BuildTeflon()
   new G4LogicalBorderSurface("GAS_TEFLON_WLS_OPSURF", neigh_gas_phys_,
                              teflon_wls_phys, teflon_wls_optSurf);
 
+  /// The holes as gas daughters of the teflon and its WLS coating ///
+  // The teflon skin surface applies to the walls of the holes, and
+  // the SiPMs are placed inside them (see BuildSiPMs)
+  if (teflon_daughter_holes_) {
+    G4double hole_length = teflon_thickness_ - wls_thickness_;
+
+    if (SiPM_size_z_ > hole_length)
+      G4Exception("[NextFlexTrackingPlane]", "BuildTeflon()", FatalException,
+                  "SiPMs thicker than the teflon mask holes.");
+
+    G4Tubs* teflon_hole_solid =
+      new G4Tubs(teflon_name + "_HOLE", 0., teflon_hole_diam_/2.,
+                 hole_length/2., 0, twopi);
+
+    teflon_hole_logic_ =
+      new G4LogicalVolume(teflon_hole_solid, xenon_gas_, teflon_name + "_HOLE");
+
+    G4Tubs* wls_hole_solid =
+      new G4Tubs(teflon_wls_name + "_HOLE", 0., teflon_hole_diam_/2.,
+                 wls_thickness_/2., 0, twopi);
+
+    G4LogicalVolume* wls_hole_logic =
+      new G4LogicalVolume(wls_hole_solid, xenon_gas_, teflon_wls_name + "_HOLE");
+
+    // The copy number of the holes gives the ID of their SiPM
+    std::vector<G4ThreeVector> hole_positions = SiPM_positions_;
+    for (auto& pos: hole_positions) pos.setZ(- wls_thickness_/2.);
+
+    PlaceArray(teflon_hole_logic_, teflon_logic, hole_positions);
+    std::vector<G4VPhysicalVolume*> wls_holes_phys =
+      PlaceArray(wls_hole_logic, teflon_wls_logic, SiPM_positions_);
+
+    // The walls of the holes in the coating have its optical surface,
+    // as the walls of the boolean holes do
+    for (G4VPhysicalVolume* wls_hole_phys: wls_holes_phys) {
+      new G4LogicalBorderSurface("TEFLON_WLS_HOLE_OPSURF", teflon_wls_phys,
+                                 wls_hole_phys, teflon_wls_optSurf);
+      new G4LogicalBorderSurface("HOLE_TEFLON_WLS_OPSURF", wls_hole_phys,
+                                 teflon_wls_phys, teflon_wls_optSurf);
+    }
+
+    teflon_hole_logic_->SetVisAttributes(G4VisAttributes::GetInvisible());
+    wls_hole_logic->SetVisAttributes(G4VisAttributes::GetInvisible());
+  }
+
   // Placing the TEFLON
   new G4PVPlacement(nullptr, G4ThreeVector(0., 0., teflon_posZ), teflon_logic,
                     teflon_name, mother_logic_, false, 0, verbosity_);
@@ -418,6 +486,7 @@ void NextFlexTrackingPlane::BuildSiPMs()
   SiPM_->SetSensorDepth(1);
   SiPM_->SetMotherDepth(2);
   SiPM_->SetNamingOrder(1);
+  SiPM_->SetIDOffset(first_sensor_id_);
 
   // Set visibility
   SiPM_->SetVisibility(SiPM_visibility_);
@@ -432,17 +501,50 @@ void NextFlexTrackingPlane::BuildSiPMs()
     G4cout << "* SiPM Z positions: " << teflon_iniZ_
 	   << " to " << teflon_iniZ_ + SiPM_size_z_ << G4endl;
 
-  for (G4int i=0; i<num_SiPMs_; i++){
-    G4int SiPM_id = first_sensor_id_ + i;
-
-    G4ThreeVector sipm_pos = SiPM_positions_[i];
-    sipm_pos.setZ(SiPM_pos_z);
-    new G4PVPlacement(nullptr, sipm_pos, SiPM_logic, SiPM_logic->GetName(),
-		      mother_logic_, true, SiPM_id, sipm_verbosity_);
-    if (sipm_verbosity_) 
-      G4cout << "* TP_SiPM " << SiPM_id << " position: " 
-	     << sipm_pos << G4endl;
-  }	  
+  // With daughter holes, a single SiPM is placed in the hole volume.
+  // Its ID is the copy number of the hole (the mother volume).
+  if (teflon_hole_logic_) {
+    G4double hole_length = teflon_thickness_ - wls_thickness_;
+    new G4PVPlacement(nullptr, G4ThreeVector(0., 0., -hole_length/2. + SiPM_size_z_/2.),
+                      SiPM_logic, SiPM_logic->GetName(), teflon_hole_logic_,
+                      false, 0, sipm_verbosity_);
+    return;
+  }
+
+  std::vector<G4ThreeVector> SiPM_positions = SiPM_positions_;
+  for (auto& pos: SiPM_positions) pos.setZ(SiPM_pos_z);
+
+  PlaceArray(SiPM_logic, mother_logic_, SiPM_positions);
+
+  if (sipm_verbosity_)
+    for (G4int i=0; i<num_SiPMs_; i++)
+      G4cout << "* TP_SiPM " << first_sensor_id_ + i << " position: "
+             << SiPM_positions[i] << G4endl;
+}
+
+
+
+// Place copies of a volume in the given positions. Copy numbers
+// start from 0, and the SiPM IDs are offset by the first sensor ID.
+std::vector<G4VPhysicalVolume*>
+NextFlexTrackingPlane::PlaceArray(G4LogicalVolume* logic,
+                                  G4LogicalVolume* mother,
+                                  const std::vector<G4ThreeVector>& positions)
+{
+  std::vector<G4VPhysicalVolume*> placed;
+
+  if (SiPM_parameterised_) {
+    placed.push_back(new G4PVParameterised(logic->GetName(), logic, mother, kUndefined,
+                                           positions.size(),
+                                           new PositionListParameterisation(positions),
+                                           sipm_verbosity_));
+    return placed;
+  }
+
+  for (size_t i=0; i<positions.size(); i++)
+    placed.push_back(new G4PVPlacement(nullptr, positions[i], logic, logic->GetName(),
+                                       mother, true, i, sipm_verbosity_));
+  return placed;
 }
 
 
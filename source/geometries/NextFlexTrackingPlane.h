@@ -78,6 +78,13 @@ namespace nexus {
     void BuildTeflon();
     void BuildSiPMs();
 
+    // Places copies of a volume in a list of positions, either one
+    // by one or with a parameterised volume, and returns the
+    // physical volume(s) created
+    std::vector<G4VPhysicalVolume*>
+    PlaceArray(G4LogicalVolume* logic, G4LogicalVolume* mother,
+               const std::vector<G4ThreeVector>& positions);
+
   private:
 
     // Logical volume where the class is placed
@@ -132,6 +139,14 @@ namespace nexus {
     G4double teflon_hole_diam_;
     G4double teflon_iniZ_;
 
+    // Holes of the teflon mask built as gas daughter volumes
+    // instead of being subtracted from the mask
+    G4bool teflon_daughter_holes_;
+    G4LogicalVolume* teflon_hole_logic_;
+
+    // SiPMs (or mask holes) placed with a parameterised volume
+    G4bool SiPM_parameterised_;
+
     G4double wls_thickness_;
 
     // Sensor IDs
@@ -68,7 +68,8 @@ namespace nexus {
     source_mat_(""),
     source_dist_from_anode_(15.*cm),
     pedestal_pos_(-568.*mm),
-    specific_vertex_{}
+    specific_vertex_{},
+    detail_("full")
     //   ext_source_distance_(0.*mm)
     // Buffer gas dimensions
   {
@@ -123,6 +124,12 @@ namespace nexus {
     msg_->DeclarePropertyWithUnit("specific_vertex", "mm",  specific_vertex_,
       "Set generation vertex.");
 
+    G4GenericMessenger::Command& detail_cmd =
+      msg_->DeclareProperty("detail", detail_,
+                            "Level of detail of the geometry: full or inner-only "
+                            "(no shielding, pedestal, mini castle or external elements).");
+    detail_cmd.SetCandidates("full inner-only");
+
     cal_ = new CalibrationSource();
 
     naI_ = new NaIScintillator();
@@ -165,6 +172,12 @@ namespace nexus {
 
   void NextNew::Construct()
   {
+    if (detail_ == "inner-only" &&
+        (lab_walls_ || lead_block_ || disk_source_ || ext_scint_))
+      G4Exception("[NextNew]", "Construct()", FatalException,
+                  "Lab walls, lead block, disk source and external scintillator "
+                  "cannot be built with detail inner-only!");
+
     // LAB /////////////////////////////////////////////////////////////
     // This is just a volume of air surrounding the detector so that events
     //(from calibration sources or cosmic rays) can be generated on the outside.
@@ -199,7 +212,7 @@ namespace nexus {
 
     G4LogicalVolume* surroundings_logic;
     G4String         surroundings_name;
-    if (lead_castle_) {
+    if (lead_castle_ && detail_ != "inner-only") {
       //SHIELDING
       shielding_->Construct();
       G4LogicalVolume*
@@ -258,27 +271,30 @@ namespace nexus {
     ics_->SetELzCoord(inner_elements_->GetELzCoord());
     ics_->Construct();
 
-    //ELEMENTS BEHIND THE TRACKING PLANE, OUTSIDE THE VESSEL
-    extra_->Construct();
-    G4LogicalVolume* extra_logic = extra_->GetLogicalVolume();
-
-    extra_rot_ = new G4RotationMatrix();
-    extra_rot_->rotateX(pi/2);
-    extra_pos_ = G4ThreeVector(0., 15.*cm, vessel_->GetLength()/2. + 40.*cm);
-    new G4PVPlacement(G4Transform3D(*extra_rot_, extra_pos_), extra_logic,
-		      "EXTRA_VESSEL", air_logic_, false, 0, false);
-
-    //PEDESTAL
-    pedestal_->SetLogicalVolume(air_logic_);
-    pedestal_->SetPosition(pedestal_pos_);
-    pedestal_->Construct();
-
-    //MINI LEAD CASTLE
-    mini_castle_->SetLogicalVolume(air_logic_);
-    mini_castle_->SetELzCoord(inner_elements_->GetELzCoord());
-    G4double ped_y_size = pedestal_->GetDimensions().y();
-    mini_castle_->SetPedestalSurfacePosition(pedestal_pos_ + ped_y_size/2.);
-    mini_castle_->Construct();
+    // The elements outside the vessel are skipped with detail inner-only
+    if (detail_ != "inner-only") {
+      //ELEMENTS BEHIND THE TRACKING PLANE, OUTSIDE THE VESSEL
+      extra_->Construct();
+      G4LogicalVolume* extra_logic = extra_->GetLogicalVolume();
+
+      extra_rot_ = new G4RotationMatrix();
+      extra_rot_->rotateX(pi/2);
+      extra_pos_ = G4ThreeVector(0., 15.*cm, vessel_->GetLength()/2. + 40.*cm);
+      new G4PVPlacement(G4Transform3D(*extra_rot_, extra_pos_), extra_logic,
+                        "EXTRA_VESSEL", air_logic_, false, 0, false);
+
+      //PEDESTAL
+      pedestal_->SetLogicalVolume(air_logic_);
+      pedestal_->SetPosition(pedestal_pos_);
+      pedestal_->Construct();
+
+      //MINI LEAD CASTLE
+      mini_castle_->SetLogicalVolume(air_logic_);
+      mini_castle_->SetELzCoord(inner_elements_->GetELzCoord());
+      G4double ped_y_size = pedestal_->GetDimensions().y();
+      mini_castle_->SetPedestalSurfacePosition(pedestal_pos_ + ped_y_size/2.);
+      mini_castle_->Construct();
+    }
 
 
     G4ThreeVector lat_pos = vessel_->GetLatExtSourcePosition(); // this is the position of the end of the port tube
@@ -451,6 +467,8 @@ namespace nexus {
   {
     G4ThreeVector vertex(0.,0.,0.);
 
+    CheckRegionDetail(region);
+
     //AIR AROUND SHIELDING
     if (region == "LAB") {
       vertex = lab_gen_->GenerateVertex("INSIDE");
@@ -600,4 +618,30 @@ namespace nexus {
   }
 
 
+
+  void NextNew::CheckRegionDetail(const G4String& region) const
+  {
+    if (detail_ != "inner-only") return;
+
+    if ((region == "SHIELDING_LEAD") || (region == "SHIELDING_STEEL") ||
+        (region == "INNER_AIR")  || (region == "SHIELDING_STRUCT") ||
+        (region == "EXTERNAL") ||
+        (region == "PEDESTAL_BOARD") ||
+        (region == "EXTRA_VESSEL") ||
+        (region == "HALLA_INNER") || (region == "HALLA_OUTER") ||
+        (region == "MINI_CASTLE") ||
+        (region == "RN_MINI_CASTLE") ||
+        (region == "MINI_CASTLE_STEEL") ||
+        (region == "EXTERNAL_PORT_ANODE") ||
+        (region == "EXTERNAL_PORT_AXIAL") ||
+        (region == "SOURCE_PORT_LATERAL_DISK") ||
+        (region == "SOURCE_PORT_UP_DISK") ||
+        (region == "SOURCE_DISK")) {
+      G4Exception("[NextNew]", "GenerateVertex()", FatalException,
+                  ("Vertex generation region " + region +
+                   " is not built with detail inner-only!").c_str());
+    }
+  }
+
+
 } //end namespace nexus
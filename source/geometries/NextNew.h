@@ -49,6 +49,8 @@ namespace nexus {
   private:
     void BuildExtScintillator(G4ThreeVector pos, const G4RotationMatrix& rot);
     void Construct();
+    /// Fatal error if the region is not built with the chosen level of detail
+    void CheckRegionDetail(const G4String& region) const;
 
   private:
 
@@ -116,6 +118,8 @@ namespace nexus {
     G4double pedestal_pos_;
 
     G4ThreeVector specific_vertex_;
+
+    G4String detail_; ///< Level of detail of the geometry (full, inner-only)
   };
 
 } // end namespace nexus
@@ -22,6 +22,7 @@
 #include <Randomize.hh>
 #include <G4TransportationManager.hh>
 #include <G4RotationMatrix.hh>
+#include <G4Region.hh>
 
 #include <CLHEP/Units/SystemOfUnits.h>
 
@@ -133,6 +134,10 @@ namespace nexus {
 
     new G4PVPlacement(0, G4ThreeVector(0.,0.,-body_zpos_), ics_logic, "ICS", mother_logic_, false, 0, false);
 
+    // Region of the ICS, for per-region production cuts and track killing
+    G4Region* ics_region = new G4Region("ICS");
+    ics_region->AddRootLogicalVolume(ics_logic);
+
 
     // SETTING VISIBILITIES   //////////
     if (visibility_) {
@@ -25,6 +25,7 @@
 #include <G4TransportationManager.hh>
 #include <G4RotationMatrix.hh>
 #include <G4UserLimits.hh>
+#include <G4Region.hh>
 
 #include <CLHEP/Units/SystemOfUnits.h>
 
@@ -82,6 +83,11 @@ namespace nexus {
 							  "LEAD_BOX");
     this->SetLogicalVolume(lead_box_logic);
 
+    // Region of the shielding, for per-region production cuts
+    // and track killing in external-background runs
+    G4Region* shielding_region = new G4Region("SHIELDING");
+    shielding_region->AddRootLogicalVolume(lead_box_logic);
+
     //STEEL BEAM STRUCTURE
     //auxiliar positions
     G4double lat_beam_x = shield_x_/2.+ steel_thickness_ + lead_thickness_/2.;
@@ -29,6 +29,7 @@
 #include <G4UnitsTable.hh>
 #include <G4Transform3D.hh>
 #include <G4SubtractionSolid.hh>
+#include <G4Region.hh>
 
 #include <CLHEP/Units/SystemOfUnits.h>
 
@@ -436,6 +437,13 @@ void NextNewVessel::Construct()
     G4LogicalVolume* vessel_gas_logic = new G4LogicalVolume(vessel_gas_solid, vessel_gas_mat,"VESSEL_GAS");
     internal_logic_vol_ = vessel_gas_logic;
 
+    // Regions of the vessel and of the inner detector (everything
+    // inside the vessel), for per-region production cuts and track killing
+    G4Region* vessel_region = new G4Region("VESSEL");
+    vessel_region->AddRootLogicalVolume(vessel_logic);
+    G4Region* inner_region = new G4Region("INNER_DETECTOR");
+    inner_region->AddRootLogicalVolume(vessel_gas_logic);
+
     G4VPhysicalVolume* vessel_gas_phys =
       new G4PVPlacement(0, G4ThreeVector(0.,0.,0.), vessel_gas_logic,
                         "VESSEL_GAS", vessel_logic, false, 0, false);
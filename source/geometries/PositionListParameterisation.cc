@@ -0,0 +1,37 @@
+// ----------------------------------------------------------------------------
+// nexus | PositionListParameterisation.cc
+//
+// Parameterisation that places the copies of a volume, without rotation,
+// in a list of positions. It replaces one G4PVPlacement per copy in large
+// arrays of identical volumes, such as the SiPMs of a tracking plane.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "PositionListParameterisation.h"
+
+#include <G4VPhysicalVolume.hh>
+
+using namespace nexus;
+
+
+PositionListParameterisation::PositionListParameterisation
+(const std::vector<G4ThreeVector>& positions):
+  G4VPVParameterisation(), positions_(positions)
+{
+}
+
+
+
+PositionListParameterisation::~PositionListParameterisation()
+{
+}
+
+
+
+void PositionListParameterisation::ComputeTransformation
+(const G4int copy_no, G4VPhysicalVolume* physvol) const
+{
+  physvol->SetTranslation(positions_[copy_no]);
+  physvol->SetRotation(nullptr);
+}
@@ -0,0 +1,49 @@
+// ----------------------------------------------------------------------------
+// nexus | PositionListParameterisation.h
+//
+// Parameterisation that places the copies of a volume, without rotation,
+// in a list of positions. It replaces one G4PVPlacement per copy in large
+// arrays of identical volumes, such as the SiPMs of a tracking plane.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef POSITION_LIST_PARAMETERISATION_H
+#define POSITION_LIST_PARAMETERISATION_H
+
+#include <G4VPVParameterisation.hh>
+#include <G4ThreeVector.hh>
+
+#include <vector>
+
+class G4VPhysicalVolume;
+
+
+namespace nexus {
+
+  class PositionListParameterisation: public G4VPVParameterisation
+  {
+  public:
+    /// Constructor
+    PositionListParameterisation(const std::vector<G4ThreeVector>& positions);
+    /// Destructor
+    ~PositionListParameterisation();
+
+    /// Place the given copy in its position
+    void ComputeTransformation(const G4int copy_no, G4VPhysicalVolume*) const;
+
+    /// Number of copies
+    G4int GetNumberOfCopies() const;
+
+  private:
+    std::vector<G4ThreeVector> positions_;
+  };
+
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline G4int PositionListParameterisation::GetNumberOfCopies() const
+  { return positions_.size(); }
+
+} // end namespace nexus
+
+#endif
@@ -9,6 +9,7 @@
 #include "OpticalMaterialProperties.h"
 #include "XenonProperties.h"
 #include "SellmeierEquation.h"
+#include "OpticalPropertiesCache.h"
 
 #include <G4MaterialPropertiesTable.hh>
 
@@ -18,6 +19,11 @@ using namespace nexus;
 using namespace CLHEP;
 
 namespace opticalprops {
+
+// The builders compute the tables from scratch. The public functions
+// at the end of the file serve them through the cache.
+namespace builders {
+
   /// Vacuum ///
   G4MaterialPropertiesTable* Vacuum()
   {
@@ -1690,4 +1696,203 @@ namespace opticalprops {
 
     return mpt;
   }
+
+} // end namespace builders
+
+
+
+  namespace {
+    G4MaterialPropertiesTable* Cached(const G4String& key,
+                                      const std::function<G4MaterialPropertiesTable*()>& builder)
+    {
+      return OpticalPropertiesCache::Instance().Get(key, builder);
+    }
+  }
+
+
+
+  G4MaterialPropertiesTable* Vacuum()
+  {
+    return Cached(OpticalPropertiesCache::MakeKey("Vacuum"),
+                  [] { return builders::Vacuum(); });
+  }
+
+
+  G4MaterialPropertiesTable* FusedSilica()
+  {
+    return Cached(OpticalPropertiesCache::MakeKey("FusedSilica"),
+                  [] { return builders::FusedSilica(); });
+  }
+
+
+  G4MaterialPropertiesTable* FakeFusedSilica(G4double transparency,
+                                             G4double thickness)
+  {
+    return Cached(OpticalPropertiesCache::MakeKey("FakeFusedSilica", transparency, thickness),
+                  [=] { return builders::FakeFusedSilica(transparency, thickness); });
+  }
+
+
+  G4MaterialPropertiesTable* ITO()
+  {
+    return Cached(OpticalPropertiesCache::MakeKey("ITO"),
+                  [] { return builders::ITO(); });
+  }
+
+
+  G4MaterialPropertiesTable* PEDOT()
+  {
+    return Cached(OpticalPropertiesCache::MakeKey("PEDOT"),
+                  [] { return builders::PEDOT(); });
+  }
+
+
+  G4MaterialPropertiesTable* GlassEpoxy()
+  {
+    return Cached(OpticalPropertiesCache::MakeKey("GlassEpoxy"),
+                  [] { return builders::GlassEpoxy(); });
+  }
+
+
+  G4MaterialPropertiesTable* Sapphire()
+  {
+    return Cached(OpticalPropertiesCache::MakeKey("Sapphire"),
+                  [] { return builders::Sapphire(); });
+  }
+
+
+  G4MaterialPropertiesTable* OptCoupler()
+  {
+    return Cached(OpticalPropertiesCache::MakeKey("OptCoupler"),
+                  [] { return builders::OptCoupler(); });
+  }
+
+
+  G4MaterialPropertiesTable* GAr(G4double sc_yield,
+                                 G4double e_lifetime)
+  {
+    return Cached(OpticalPropertiesCache::MakeKey("GAr", sc_yield, e_lifetime),
+                  [=] { return builders::GAr(sc_yield, e_lifetime); });
+  }
+
+
+  G4MaterialPropertiesTable* GXe(G4double pressure,
+                                 G4double temperature,
+                                 G4int    sc_yield,
+                                 G4double e_lifetime)
+  {
+    return Cached(OpticalPropertiesCache::MakeKey("GXe", pressure, temperature, sc_yield, e_lifetime),
+                  [=] { return builders::GXe(pressure, temperature, sc_yield, e_lifetime); });
+  }
+
+
+  G4MaterialPropertiesTable* LXe()
+  {
+    return Cached(OpticalPropertiesCache::MakeKey("LXe"),
+                  [] { return builders::LXe(); });
+  }
+
+
+  G4MaterialPropertiesTable* FakeGrid(G4double pressure,
+                                      G4double temperature,
+                                      G4double transparency,
+                                      G4double thickness,
+                                      G4int    sc_yield,
+                                      G4double e_lifetime,
+                                      G4double photoe_p)
+  {
+    return Cached(OpticalPropertiesCache::MakeKey("FakeGrid", pressure, temperature, transparency, thickness, sc_yield, e_lifetime, photoe_p),
+                  [=] { return builders::FakeGrid(pressure, temperature, transparency, thickness, sc_yield, e_lifetime, photoe_p); });
+  }
+
+
+  G4MaterialPropertiesTable* PTFE()
+  {
+    return Cached(OpticalPropertiesCache::MakeKey("PTFE"),
+                  [] { return builders::PTFE(); });
+  }
+
+
+  G4MaterialPropertiesTable* PolishedAl()
+  {
+    return Cached(OpticalPropertiesCache::MakeKey("PolishedAl"),
+                  [] { return builders::PolishedAl(); });
+  }
+
+
+  G4MaterialPropertiesTable* TPB()
+  {
+    return Cached(OpticalPropertiesCache::MakeKey("TPB"),
+                  [] { return builders::TPB(); });
+  }
+
+
+  G4MaterialPropertiesTable* DegradedTPB(G4double wls_eff)
+  {
+    return Cached(OpticalPropertiesCache::MakeKey("DegradedTPB", wls_eff),
+                  [=] { return builders::DegradedTPB(wls_eff); });
+  }
+
+
+  G4MaterialPropertiesTable* TPH()
+  {
+    return Cached(OpticalPropertiesCache::MakeKey("TPH"),
+                  [] { return builders::TPH(); });
+  }
+
+
+  G4MaterialPropertiesTable* EJ280()
+  {
+    return Cached(OpticalPropertiesCache::MakeKey("EJ280"),
+                  [] { return builders::EJ280(); });
+  }
+
+
+  G4MaterialPropertiesTable* EJ286()
+  {
+    return Cached(OpticalPropertiesCache::MakeKey("EJ286"),
+                  [] { return builders::EJ286(); });
+  }
+
+
+  G4MaterialPropertiesTable* Y11()
+  {
+    return Cached(OpticalPropertiesCache::MakeKey("Y11"),
+                  [] { return builders::Y11(); });
+  }
+
+
+  G4MaterialPropertiesTable* B2()
+  {
+    return Cached(OpticalPropertiesCache::MakeKey("B2"),
+                  [] { return builders::B2(); });
+  }
+
+
+  G4MaterialPropertiesTable* Pethylene()
+  {
+    return Cached(OpticalPropertiesCache::MakeKey("Pethylene"),
+                  [] { return builders::Pethylene(); });
+  }
+
+
+  G4MaterialPropertiesTable* FPethylene()
+  {
+    return Cached(OpticalPropertiesCache::MakeKey("FPethylene"),
+                  [] { return builders::FPethylene(); });
+  }
+
+
+  G4MaterialPropertiesTable* PMMA()
+  {
+    return Cached(OpticalPropertiesCache::MakeKey("PMMA"),
+                  [] { return builders::PMMA(); });
+  }
+
+
+  G4MaterialPropertiesTable* XXX()
+  {
+    return Cached(OpticalPropertiesCache::MakeKey("XXX"),
+                  [] { return builders::XXX(); });
+  }
 }
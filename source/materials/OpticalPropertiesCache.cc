@@ -0,0 +1,94 @@
+// ----------------------------------------------------------------------------
+// nexus | OpticalPropertiesCache.cc
+//
+// Cache of the optical property tables built in OpticalMaterialProperties.
+// Tables are built only once for every combination of builder and
+// parameters; later requests receive a copy of the cached table.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "OpticalPropertiesCache.h"
+
+#include <G4MaterialPropertiesTable.hh>
+
+#include <chrono>
+
+using namespace nexus;
+
+
+
+OpticalPropertiesCache& OpticalPropertiesCache::Instance()
+{
+  static OpticalPropertiesCache cache;
+  return cache;
+}
+
+
+
+OpticalPropertiesCache::OpticalPropertiesCache():
+  hits_(0), misses_(0), time_(0.)
+{
+}
+
+
+
+OpticalPropertiesCache::~OpticalPropertiesCache()
+{
+  for (auto& kv: tables_) delete kv.second;
+}
+
+
+
+G4MaterialPropertiesTable*
+OpticalPropertiesCache::Get(const G4String& key,
+                            const std::function<G4MaterialPropertiesTable*()>& builder)
+{
+  auto start = std::chrono::steady_clock::now();
+
+  auto it = tables_.find(key);
+  if (it == tables_.end()) {
+    it = tables_.emplace(key, builder()).first;
+    misses_++;
+  }
+  else {
+    hits_++;
+  }
+
+  G4MaterialPropertiesTable* mpt = Copy(it->second);
+
+  time_ += std::chrono::duration<G4double>
+    (std::chrono::steady_clock::now() - start).count();
+
+  return mpt;
+}
+
+
+
+G4MaterialPropertiesTable*
+OpticalPropertiesCache::Copy(const G4MaterialPropertiesTable* table) const
+{
+  G4MaterialPropertiesTable* mpt = new G4MaterialPropertiesTable();
+
+  const std::vector<G4String>& names = table->GetMaterialPropertyNames();
+  for (size_t i=0; i<names.size(); ++i) {
+    G4MaterialPropertyVector* vec = table->GetProperty(G4int(i));
+    if (vec) mpt->AddProperty(names[i], new G4MaterialPropertyVector(*vec), true);
+  }
+
+  const std::vector<G4String>& const_names = table->GetMaterialConstPropertyNames();
+  for (size_t i=0; i<const_names.size(); ++i) {
+    if (table->ConstPropertyExists(G4int(i)))
+      mpt->AddConstProperty(const_names[i], table->GetConstProperty(G4int(i)), true);
+  }
+
+  return mpt;
+}
+
+
+
+void OpticalPropertiesCache::PrintReport() const
+{
+  G4cout << "### Optical properties: " << misses_ << " tables built, "
+         << hits_ << " reused, " << time_ << " s" << G4endl;
+}
@@ -0,0 +1,86 @@
+// ----------------------------------------------------------------------------
+// nexus | OpticalPropertiesCache.h
+//
+// Cache of the optical property tables built in OpticalMaterialProperties.
+// Tables are built only once for every combination of builder and
+// parameters; later requests receive a copy of the cached table.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef OPTICAL_PROPERTIES_CACHE_H
+#define OPTICAL_PROPERTIES_CACHE_H
+
+#include <globals.hh>
+
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+class G4MaterialPropertiesTable;
+
+
+namespace nexus {
+
+  class OpticalPropertiesCache
+  {
+  public:
+    /// Return the single instance of the class
+    static OpticalPropertiesCache& Instance();
+
+    /// Return a copy of the table stored under the given key,
+    /// invoking the builder first if the key is not in the cache
+    G4MaterialPropertiesTable*
+    Get(const G4String& key, const std::function<G4MaterialPropertiesTable*()>& builder);
+
+    /// Build a cache key out of the name of a builder and its parameters
+    template <typename... Args>
+    static G4String MakeKey(const G4String& name, Args... args);
+
+    /// Number of requests served from the cache
+    G4long GetHits() const;
+    /// Number of tables that had to be built
+    G4long GetMisses() const;
+    /// Time spent building and copying tables, in seconds
+    G4double GetTime() const;
+
+    /// Print the cache statistics
+    void PrintReport() const;
+
+  private:
+    OpticalPropertiesCache();
+    ~OpticalPropertiesCache();
+
+    /// Return a deep copy of a table. Each material must own its table,
+    /// since G4Material deletes the table it replaces.
+    G4MaterialPropertiesTable* Copy(const G4MaterialPropertiesTable*) const;
+
+  private:
+    std::map<G4String, G4MaterialPropertiesTable*> tables_;
+
+    G4long hits_;
+    G4long misses_;
+    G4double time_;
+  };
+
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  template <typename... Args>
+  inline G4String OpticalPropertiesCache::MakeKey(const G4String& name, Args... args)
+  {
+    std::ostringstream key;
+    key << std::setprecision(17) << name;
+    ((key << '|' << args), ...);
+    return key.str();
+  }
+
+  inline G4long OpticalPropertiesCache::GetHits() const { return hits_; }
+
+  inline G4long OpticalPropertiesCache::GetMisses() const { return misses_; }
+
+  inline G4double OpticalPropertiesCache::GetTime() const { return time_; }
+
+} // namespace nexus
+
+#endif
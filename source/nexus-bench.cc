@@ -0,0 +1,231 @@
+// ----------------------------------------------------------------------------
+// nexus | nexus-bench.cc
+//
+// Main program of the nexus microbenchmarks. It runs the registered
+// benchmarks and writes the results in JSON format, so that they can be
+// compared across releases.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "Benchmark.h"
+
+#include <G4Version.hh>
+#include <Randomize.hh>
+
+#include <getopt.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+using namespace nexus;
+
+
+void PrintUsage()
+{
+  G4cerr  << "\nUsage: ./nexus-bench [-r number] [-s seed] [-f filter] [-o output]\n" << G4endl;
+  G4cerr  << "Available options:" << G4endl;
+  G4cerr  << "   -r, --repetitions     : Number of repetitions of each benchmark (default 5)\n"
+          << "   -s, --seed            : Random seed set before each repetition (default 12345)\n"
+          << "   -f, --filter          : Run only benchmarks whose name contains this string\n"
+          << "   -o, --output          : Name of the JSON output file (default nexus-bench.json)\n"
+          << "   -l, --list            : List the available benchmarks and exit"
+          << G4endl;
+  exit(EXIT_FAILURE);
+}
+
+
+struct BenchmarkResult
+{
+  G4String name;
+  G4long iterations;
+  G4double min, median, mean, stddev; // ns per iteration
+  G4double items_per_second;
+  std::map<G4String, G4double> counters; // median over the repetitions
+};
+
+
+G4String JSONEscape(const G4String& s)
+{
+  std::ostringstream out;
+  for (char c: s) {
+    if (c == '"' || c == '\\') out << '\\' << c;
+    else if (c == '\n') out << "\\n";
+    else out << c;
+  }
+  return out.str();
+}
+
+
+void WriteJSON(const G4String& filename, const std::vector<BenchmarkResult>& results,
+               G4int repetitions, G4long seed)
+{
+  std::time_t now = std::time(nullptr);
+  char date[32];
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+  char host[256] = "unknown";
+  gethostname(host, sizeof(host));
+
+  std::ofstream out(filename);
+  out << std::setprecision(6);
+  out << "{\n"
+      << "  \"context\": {\n"
+      << "    \"date\": \"" << date << "\",\n"
+      << "    \"host\": \"" << JSONEscape(host) << "\",\n"
+      << "    \"geant4_version\": \"" << JSONEscape(G4Version) << "\",\n"
+      << "    \"repetitions\": " << repetitions << ",\n"
+      << "    \"seed\": " << seed << "\n"
+      << "  },\n"
+      << "  \"benchmarks\": [";
+
+  for (size_t i=0; i<results.size(); ++i) {
+    const BenchmarkResult& r = results[i];
+    out << (i ? "," : "") << "\n    {\n"
+        << "      \"name\": \"" << JSONEscape(r.name) << "\",\n"
+        << "      \"iterations\": " << r.iterations << ",\n"
+        << "      \"time_unit\": \"ns\",\n"
+        << "      \"min_time\": " << r.min << ",\n"
+        << "      \"median_time\": " << r.median << ",\n"
+        << "      \"mean_time\": " << r.mean << ",\n"
+        << "      \"stddev_time\": " << r.stddev << ",\n"
+        << "      \"items_per_second\": " << r.items_per_second;
+    for (auto& counter: r.counters)
+      out << ",\n      \"" << JSONEscape(counter.first) << "\": " << counter.second;
+    out << "\n    }";
+  }
+  out << "\n  ]\n}\n";
+}
+
+
+G4int main(int argc, char** argv)
+{
+  G4int repetitions = 5;
+  G4long seed = 12345;
+  G4String filter = "";
+  G4String output = "nexus-bench.json";
+  G4bool list = false;
+
+  static struct option long_options[] =
+  {
+    {"repetitions", required_argument, 0, 'r'},
+    {"seed",        required_argument, 0, 's'},
+    {"filter",      required_argument, 0, 'f'},
+    {"output",      required_argument, 0, 'o'},
+    {"list",        no_argument,       0, 'l'},
+    {0, 0, 0, 0}
+  };
+
+  int c;
+
+  while (true) {
+
+    opterr = 0;
+    c = getopt_long(argc, argv, "r:s:f:o:l", long_options, 0);
+
+    if (c==-1) break; // Exit if we are done reading options
+
+    switch (c) {
+
+      case 'r':
+        repetitions = atoi(optarg);
+        break;
+
+      case 's':
+        seed = atol(optarg);
+        break;
+
+      case 'f':
+        filter = optarg;
+        break;
+
+      case 'o':
+        output = optarg;
+        break;
+
+      case 'l':
+        list = true;
+        break;
+
+      default:
+        PrintUsage();
+    }
+  }
+
+  if (repetitions < 1) PrintUsage();
+
+  std::vector<BenchmarkEntry>& benchmarks = BenchmarkRegistry::Get();
+  std::sort(benchmarks.begin(), benchmarks.end(),
+            [](const BenchmarkEntry& a, const BenchmarkEntry& b)
+            { return a.name < b.name; });
+
+  if (list) {
+    for (auto& b: benchmarks) G4cout << b.name << G4endl;
+    return EXIT_SUCCESS;
+  }
+
+  std::vector<BenchmarkResult> results;
+
+  for (auto& b: benchmarks) {
+
+    if (b.name.find(filter) == std::string::npos) continue;
+
+    std::vector<G4double> times;
+    G4double items = 1.;
+    std::map<G4String, std::vector<G4double>> counters;
+
+    for (G4int rep=0; rep<repetitions; ++rep) {
+      // Reset the seed so that every repetition (and every release)
+      // processes exactly the same random sequence
+      CLHEP::HepRandom::setTheSeed(seed);
+      BenchmarkState state(b.iterations);
+      b.function(state);
+      times.push_back(state.GetElapsedTime() / b.iterations);
+      items = state.GetItemsPerIteration();
+      for (auto& counter: state.GetCounters())
+        counters[counter.first].push_back(counter.second);
+    }
+
+    std::sort(times.begin(), times.end());
+
+    BenchmarkResult r;
+    r.name = b.name;
+    r.iterations = b.iterations;
+    r.min = times.front();
+    r.median = (times.size() % 2) ? times[times.size()/2] :
+      0.5 * (times[times.size()/2 - 1] + times[times.size()/2]);
+
+    G4double sum = 0., sum2 = 0.;
+    for (G4double t: times) { sum += t; sum2 += t*t; }
+    r.mean = sum / times.size();
+    r.stddev = std::sqrt(std::max(0., sum2/times.size() - r.mean*r.mean));
+    r.items_per_second = (r.median > 0.) ? items / r.median * 1.e9 : 0.;
+
+    for (auto& counter: counters) {
+      std::vector<G4double>& values = counter.second;
+      std::sort(values.begin(), values.end());
+      r.counters[counter.first] = values[values.size()/2];
+    }
+
+    G4cout << std::left << std::setw(40) << r.name << std::right
+           << std::setw(14) << std::setprecision(4) << r.median << " ns"
+           << std::setw(14) << std::setprecision(4) << r.items_per_second
+           << " items/s";
+    for (auto& counter: r.counters)
+      G4cout << "  " << counter.first << "=" << counter.second;
+    G4cout << G4endl;
+
+    results.push_back(r);
+  }
+
+  WriteJSON(output, results, repetitions, seed);
+  G4cout << "Results written to " << output << G4endl;
+
+  return EXIT_SUCCESS;
+}
@@ -20,8 +20,9 @@ using namespace nexus;
 
 
 HDF5Writer::HDF5Writer():
-  file_(0), irun_(0), ismp_(0), ihit_(0),
-  ipart_(0), ipos_(0), istep_(0)
+  file_(0), profileTable_(0), runStatsTable_(0), primaryTable_(0),
+  sourceTable_(0), irun_(0), ismp_(0), ihit_(0), ipart_(0), ipos_(0),
+  istep_(0), iprof_(0), istat_(0), iprim_(0), isrc_(0)
 {
 }
 
@@ -101,7 +102,7 @@ void HDF5Writer::WriteSensorDataInfo(int64_t evt_number, unsigned int sensor_id,
   ismp_++;
 }
 
-void HDF5Writer::WriteHitInfo(int64_t evt_number, int particle_indx, int hit_indx, float hit_position_x, float hit_position_y, float hit_position_z, float hit_time, float hit_energy, const char* label)
+void HDF5Writer::WriteHitInfo(int64_t evt_number, int particle_indx, int hit_indx, float hit_position_x, float hit_position_y, float hit_position_z, float hit_time, float hit_energy, const char* label, float weight)
 {
   hit_info_t trueInfo;
   trueInfo.event_id = evt_number;
@@ -114,12 +115,20 @@ void HDF5Writer::WriteHitInfo(int64_t evt_number, int particle_indx, int hit_ind
   strcpy(trueInfo.label, label);
   trueInfo.particle_id = particle_indx;
   trueInfo.hit_id = hit_indx;
+  trueInfo.weight = weight;
   writeHit(&trueInfo,  hitInfoTable_, memtypeHitInfo_, ihit_);
 
   ihit_++;
 }
 
-void HDF5Writer::WriteParticleInfo(int64_t evt_number, int particle_indx, const char* particle_name, char primary, int mother_id, float initial_vertex_x, float initial_vertex_y, float initial_vertex_z, float initial_vertex_t, float final_vertex_x, float final_vertex_y, float final_vertex_z, float final_vertex_t, const char* initial_volume, const char* final_volume, float ini_momentum_x, float ini_momentum_y, float ini_momentum_z, float final_momentum_x, float final_momentum_y, float final_momentum_z, float kin_energy, float length, const char* creator_proc, const char* final_proc)
+void HDF5Writer::WriteHitInfo(const std::vector<hit_info_t>& hits)
+{
+  writeHits(hits.data(), hits.size(), hitInfoTable_, memtypeHitInfo_, ihit_);
+
+  ihit_ += hits.size();
+}
+
+void HDF5Writer::WriteParticleInfo(int64_t evt_number, int particle_indx, const char* particle_name, char primary, int mother_id, float initial_vertex_x, float initial_vertex_y, float initial_vertex_z, float initial_vertex_t, float final_vertex_x, float final_vertex_y, float final_vertex_z, float final_vertex_t, const char* initial_volume, const char* final_volume, float ini_momentum_x, float ini_momentum_y, float ini_momentum_z, float final_momentum_x, float final_momentum_y, float final_momentum_z, float kin_energy, float length, const char* creator_proc, const char* final_proc, float weight)
 {
   particle_info_t trueInfo;
   trueInfo.event_id = evt_number;
@@ -152,6 +161,7 @@ void HDF5Writer::WriteParticleInfo(int64_t evt_number, int particle_indx, const
   strcpy(trueInfo.creator_proc, creator_proc);
   memset(trueInfo.final_proc, 0, STRLEN);
   strcpy(trueInfo.final_proc, final_proc);
+  trueInfo.weight = weight;
   writeParticle(&trueInfo,  particleInfoTable_, memtypeParticleInfo_, ipart_);
 
   ipart_++;
@@ -203,3 +213,118 @@ void HDF5Writer::WriteStep(int64_t evt_number,
 
   istep_++;
 }
+
+void HDF5Writer::WriteProfileInfo(const char* particle_name, const char* volume,
+                                  const char* proc_name, uint64_t steps,
+                                  uint64_t tracks, double cpu_time)
+{
+  // The profile table is only created if there is something to write
+  if (!profileTable_) {
+    std::string profile_group_name = "/PROFILE";
+    size_t profile_group = createGroup(file_, profile_group_name);
+    std::string profile_table_name = "stepping";
+    memtypeProfile_ = createProfileType();
+    profileTable_   = createTable(profile_group, profile_table_name, memtypeProfile_);
+    H5Gclose(profile_group);
+  }
+
+  profile_info_t profile;
+  memset(profile.particle_name, 0, STRLEN);
+  strncpy(profile.particle_name, particle_name, STRLEN-1);
+  memset(profile.volume, 0, STRLEN);
+  strncpy(profile.volume, volume, STRLEN-1);
+  memset(profile.proc_name, 0, STRLEN);
+  strncpy(profile.proc_name, proc_name, STRLEN-1);
+  profile.steps    = steps;
+  profile.tracks   = tracks;
+  profile.cpu_time = cpu_time;
+  writeProfile(&profile, profileTable_, memtypeProfile_, iprof_);
+
+  iprof_++;
+}
+
+
+
+void HDF5Writer::WriteRunStats(const char* param_key, const char* param_value)
+{
+  // The run statistics share the type of the configuration table
+  if (!runStatsTable_) {
+    hid_t group = H5Gopen(file_, "/MC", H5P_DEFAULT);
+    std::string run_stats_table_name = "run_stats";
+    runStatsTable_ = createTable(group, run_stats_table_name, memtypeRun_);
+    H5Gclose(group);
+  }
+
+  run_info_t runData;
+  memset(runData.param_key,   0, CONFLEN);
+  memset(runData.param_value, 0, CONFLEN);
+  strncpy(runData.param_key, param_key, CONFLEN-1);
+  strncpy(runData.param_value, param_value, CONFLEN-1);
+  writeRun(&runData, runStatsTable_, memtypeRun_, istat_);
+
+  istat_++;
+}
+
+
+void HDF5Writer::WritePrimaryInfo(int64_t evt_number, int vertex_id, int particle_id,
+                                  int mother_id, int pdg_code,
+                                  const char* particle_name,
+                                  double x, double y, double z, double time,
+                                  double px, double py, double pz,
+                                  double pol_x, double pol_y, double pol_z,
+                                  double mass, double charge, double weight)
+{
+  // The primaries table is only created if they are requested
+  if (!primaryTable_) {
+    hid_t group = H5Gopen(file_, "/MC", H5P_DEFAULT);
+    std::string primary_table_name = "primaries";
+    memtypePrimary_ = createPrimaryType();
+    primaryTable_   = createTable(group, primary_table_name, memtypePrimary_);
+    H5Gclose(group);
+  }
+
+  primary_info_t primary;
+  primary.event_id       = evt_number;
+  primary.vertex_id      = vertex_id;
+  primary.particle_id    = particle_id;
+  primary.mother_id      = mother_id;
+  primary.pdg_code       = pdg_code;
+  memset(primary.particle_name, 0, STRLEN);
+  strncpy(primary.particle_name, particle_name, STRLEN-1);
+  primary.x              = x;
+  primary.y              = y;
+  primary.z              = z;
+  primary.time           = time;
+  primary.px             = px;
+  primary.py             = py;
+  primary.pz             = pz;
+  primary.polarization_x = pol_x;
+  primary.polarization_y = pol_y;
+  primary.polarization_z = pol_z;
+  primary.mass           = mass;
+  primary.charge         = charge;
+  primary.weight         = weight;
+  writePrimary(&primary, primaryTable_, memtypePrimary_, iprim_);
+
+  iprim_++;
+}
+
+
+void HDF5Writer::WriteSourceInfo(int64_t evt_number, int source_id)
+{
+  // The sources table is only created by multi-source generators
+  if (!sourceTable_) {
+    hid_t group = H5Gopen(file_, "/MC", H5P_DEFAULT);
+    std::string source_table_name = "sources";
+    memtypeSource_ = createSourceType();
+    sourceTable_   = createTable(group, source_table_name, memtypeSource_);
+    H5Gclose(group);
+  }
+
+  source_info_t source;
+  source.event_id  = evt_number;
+  source.source_id = source_id;
+  writeSource(&source, sourceTable_, memtypeSource_, isrc_);
+
+  isrc_++;
+}
@@ -13,6 +13,7 @@
 
 #include <hdf5.h>
 #include <iostream>
+#include <vector>
 
 namespace nexus {
 
@@ -32,8 +33,9 @@ namespace nexus {
 
     void WriteRunInfo(const char* param_key, const char* param_value);
     void WriteSensorDataInfo(int64_t evt_number, unsigned int sensor_id, unsigned int time_bin, unsigned int charge);
-    void WriteHitInfo(int64_t evt_number, int particle_indx, int hit_indx, float hit_position_x, float hit_position_y, float hit_position_z, float hit_time, float hit_energy, const char* label);
-    void WriteParticleInfo(int64_t evt_number, int particle_indx, const char* particle_name, char primary, int mother_id, float initial_vertex_x, float initial_vertex_y, float initial_vertex_z, float initial_vertex_t, float final_vertex_x, float final_vertex_y, float final_vertex_z, float final_vertex_t, const char* initial_volume, const char* final_volume, float ini_momentum_x, float ini_momentum_y, float ini_momentum_z, float final_momentum_x, float final_momentum_y, float final_momentum_z, float kin_energy, float length, const char* creator_proc, const char* final_proc);
+    void WriteHitInfo(int64_t evt_number, int particle_indx, int hit_indx, float hit_position_x, float hit_position_y, float hit_position_z, float hit_time, float hit_energy, const char* label, float weight=1.);
+    void WriteHitInfo(const std::vector<hit_info_t>& hits);
+    void WriteParticleInfo(int64_t evt_number, int particle_indx, const char* particle_name, char primary, int mother_id, float initial_vertex_x, float initial_vertex_y, float initial_vertex_z, float initial_vertex_t, float final_vertex_x, float final_vertex_y, float final_vertex_z, float final_vertex_t, const char* initial_volume, const char* final_volume, float ini_momentum_x, float ini_momentum_y, float ini_momentum_z, float final_momentum_x, float final_momentum_y, float final_momentum_z, float kin_energy, float length, const char* creator_proc, const char* final_proc, float weight=1.);
     void WriteSensorPosInfo(unsigned int sensor_id, const char* sensor_name, float x, float y, float z);
     void WriteStep(int64_t evt_number,
                    int particle_id, const char* particle_name,
@@ -43,6 +45,17 @@ namespace nexus {
                    const char*      proc_name,
                    float initial_x, float initial_y, float initial_z,
                    float   final_x, float   final_y, float   final_z);
+    void WriteProfileInfo(const char* particle_name, const char* volume,
+                          const char* proc_name, uint64_t steps,
+                          uint64_t tracks, double cpu_time);
+    void WriteRunStats(const char* param_key, const char* param_value);
+    void WritePrimaryInfo(int64_t evt_number, int vertex_id, int particle_id,
+                          int mother_id, int pdg_code, const char* particle_name,
+                          double x, double y, double z, double time,
+                          double px, double py, double pz,
+                          double pol_x, double pol_y, double pol_z,
+                          double mass, double charge, double weight);
+    void WriteSourceInfo(int64_t evt_number, int source_id);
 
   private:
     size_t file_; ///< HDF5 file
@@ -57,6 +70,10 @@ namespace nexus {
     size_t particleInfoTable_;
     size_t snsPosTable_;
     size_t stepTable_;
+    size_t profileTable_;
+    size_t runStatsTable_;
+    size_t primaryTable_;
+    size_t sourceTable_;
 
     size_t memtypeRun_;
     size_t memtypeSnsData_;
@@ -64,6 +81,9 @@ namespace nexus {
     size_t memtypeParticleInfo_;
     size_t memtypeSnsPos_;
     size_t memtypeStep_;
+    size_t memtypeProfile_;
+    size_t memtypePrimary_;
+    size_t memtypeSource_;
 
     size_t irun_; ///< counter for configuration parameters
     size_t ismp_; ///< counter for written waveform samples
@@ -71,6 +91,10 @@ namespace nexus {
     size_t ipart_; ///< counter for particle information
     size_t ipos_; ///< counter for sensor positions
     size_t istep_; ///< counter for steps
+    size_t iprof_; ///< counter for profiling entries
+    size_t istat_; ///< counter for run statistics
+    size_t iprim_; ///< counter for primary particles
+    size_t isrc_; ///< counter for event sources
 
   };
 
@@ -0,0 +1,213 @@
+// ----------------------------------------------------------------------------
+// nexus | LightTablePersistencyManager.cc
+//
+// This persistency manager accumulates in memory the number of photons
+// detected by every sensor (and time bin) for every point of the grid
+// swept by LightTableGenerator. At the end of the job, the detection
+// probabilities are written in the text format read by ELLookupTable.
+// Points outside the fundamental domain of the symmetry of the detector
+// are not simulated and have no entries in the table.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "LightTablePersistencyManager.h"
+
+#include "LightTableGenerator.h"
+#include "PrimaryGeneration.h"
+#include "SensorHit.h"
+#include "TrajectoryMap.h"
+#include "FactoryBase.h"
+
+#include <G4GenericMessenger.hh>
+#include <G4Event.hh>
+#include <G4HCofThisEvent.hh>
+#include <G4PrimaryVertex.hh>
+#include <G4RunManager.hh>
+#include <G4SystemOfUnits.hh>
+
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+
+using namespace nexus;
+
+REGISTER_CLASS(LightTablePersistencyManager, PersistencyManagerBase)
+
+
+
+LightTablePersistencyManager::LightTablePersistencyManager():
+  PersistencyManagerBase(), msg_(0), filename_(""),
+  time_bins_(1), time_bin_size_(1.*microsecond)
+{
+  msg_ = new G4GenericMessenger(this, "/nexus/persistency/");
+  msg_->DeclareMethod("outputFile", &LightTablePersistencyManager::OpenFile, "");
+
+  G4GenericMessenger::Command& bins_cmd =
+    msg_->DeclareProperty("time_bins", time_bins_,
+                          "Number of time bins of the table (1 for S1 tables).");
+  bins_cmd.SetParameterName("time_bins", false);
+  bins_cmd.SetRange("time_bins>0");
+
+  G4GenericMessenger::Command& size_cmd =
+    msg_->DeclareProperty("time_bin_size", time_bin_size_,
+                          "Width of the time bins of the table.");
+  size_cmd.SetParameterName("time_bin_size", false);
+  size_cmd.SetUnitCategory("Time");
+  size_cmd.SetRange("time_bin_size>0.");
+
+  init_macro_ = "";
+  macros_.clear();
+  delayed_macros_.clear();
+}
+
+
+
+LightTablePersistencyManager::~LightTablePersistencyManager()
+{
+  delete msg_;
+}
+
+
+
+void LightTablePersistencyManager::OpenFile(G4String filename)
+{
+  filename_ = filename + ".dat";
+}
+
+
+
+const LightTableGenerator* LightTablePersistencyManager::GetGenerator() const
+{
+  const PrimaryGeneration* pg = dynamic_cast<const PrimaryGeneration*>
+    (G4RunManager::GetRunManager()->GetUserPrimaryGeneratorAction());
+  const LightTableGenerator* generator =
+    pg ? dynamic_cast<const LightTableGenerator*>(pg->GetGenerator()) : nullptr;
+
+  if (!generator) {
+    G4Exception("[LightTablePersistencyManager]", "GetGenerator()", FatalException,
+                "LightTableGenerator is required by LightTablePersistencyManager");
+  }
+
+  return generator;
+}
+
+
+
+G4bool LightTablePersistencyManager::Store(const G4Event* event)
+{
+  TrajectoryMap::Clear();
+
+  const LightTableGenerator* generator = GetGenerator();
+
+  if (counts_.empty()) {
+    counts_.resize(generator->GetNumberOfPoints());
+    generated_.resize(generator->GetNumberOfPoints(), 0.);
+  }
+
+  G4int point_id = generator->GetPointID(event->GetEventID());
+  if (point_id >= (G4int) counts_.size()) return false;
+
+  for (G4int i=0; i<event->GetNumberOfPrimaryVertex(); ++i)
+    generated_[point_id] += event->GetPrimaryVertex(i)->GetNumberOfParticle();
+
+  G4HCofThisEvent* hce = event->GetHCofThisEvent();
+  if (!hce) return true;
+
+  std::map<G4int, std::vector<G4double>>& point_counts = counts_[point_id];
+
+  for (G4int i=0; i<hce->GetNumberOfCollections(); ++i) {
+    SensorHitsCollection* hits =
+      dynamic_cast<SensorHitsCollection*>(hce->GetHC(i));
+    if (!hits) continue;
+
+    for (size_t j=0; j<hits->entries(); ++j) {
+      const SensorHit* hit = dynamic_cast<const SensorHit*>(hits->GetHit(j));
+      if (!hit) continue;
+
+      CheckTimeBinning(hit->GetBinSize());
+
+      std::vector<G4double>& sensor_counts = point_counts[hit->GetPmtID()];
+      if (sensor_counts.empty()) sensor_counts.resize(time_bins_, 0.);
+
+      // Photons arriving after the last time bin are counted in it
+      for (auto& bin: hit->GetHistogram()) {
+        G4int time_bin = std::min((G4int) (bin.first / time_bin_size_), time_bins_ - 1);
+        sensor_counts[time_bin] += bin.second;
+      }
+    }
+  }
+
+  return true;
+}
+
+
+
+void LightTablePersistencyManager::CheckTimeBinning(G4double sensor_bin_size) const
+{
+  // With a single bin all the photons are counted together
+  if (time_bins_ == 1) return;
+
+  // The photons of a sensor bin are counted in the table bin of its
+  // start, so each table bin must be made of whole sensor bins
+  G4double ratio = time_bin_size_ / sensor_bin_size;
+  if (ratio < 1. - 1.e-6 || std::abs(ratio - std::round(ratio)) > 1.e-6) {
+    G4String msg = "The time binning of the sensors (" +
+      std::to_string(sensor_bin_size/ns) + " ns) must divide time_bin_size (" +
+      std::to_string(time_bin_size_/ns) + " ns).";
+    G4Exception("[LightTablePersistencyManager]", "CheckTimeBinning()",
+                FatalException, msg);
+  }
+}
+
+
+
+void LightTablePersistencyManager::CloseFile()
+{
+  if (filename_ == "" || counts_.empty()) return;
+
+  const LightTableGenerator* generator = GetGenerator();
+
+  std::ofstream file(filename_);
+  if (!file.is_open()) {
+    G4Exception("[LightTablePersistencyManager]", "CloseFile()", JustWarning,
+                ("Cannot open output file " + filename_).c_str());
+    return;
+  }
+
+  G4ThreeVector grid_min = generator->GetGridMin();
+  G4ThreeVector grid_max = generator->GetGridMax();
+  G4ThreeVector pitch    = generator->GetPitch();
+  const LightTableSymmetry& symmetry = generator->GetSymmetry();
+
+  file << "* nexus light table\n"
+       << "* grid_min " << grid_min.x()/mm << " " << grid_min.y()/mm
+       << " " << grid_min.z()/mm << " mm\n"
+       << "* grid_max " << grid_max.x()/mm << " " << grid_max.y()/mm
+       << " " << grid_max.z()/mm << " mm\n"
+       << "* pitch " << pitch.x()/mm << " " << pitch.y()/mm
+       << " " << pitch.z()/mm << " mm\n"
+       << "* radius " << generator->GetRadius()/mm << " mm\n"
+       << "* num_points " << counts_.size() << "\n"
+       << "* rotation_order " << symmetry.GetRotationOrder() << "\n"
+       << "* reflection " << (symmetry.GetReflection() ? 1 : 0) << "\n"
+       << "* time_bins " << time_bins_ << "\n"
+       << "* time_bin_size " << time_bin_size_/microsecond << " mus\n";
+
+  file << "point_id sensor_id";
+  for (G4int i=0; i<time_bins_; ++i) file << " p" << i;
+  file << "\n";
+
+  file << std::setprecision(8);
+
+  for (size_t p=0; p<counts_.size(); ++p) {
+    if (generated_[p] <= 0.) continue;
+    for (auto& sensor: counts_[p]) {
+      file << p << " " << sensor.first;
+      for (G4double n: sensor.second) file << " " << n / generated_[p];
+      file << "\n";
+    }
+  }
+
+  file.close();
+}
@@ -0,0 +1,84 @@
+// ----------------------------------------------------------------------------
+// nexus | LightTablePersistencyManager.h
+//
+// This persistency manager accumulates in memory the number of photons
+// detected by every sensor (and time bin) for every point of the grid
+// swept by LightTableGenerator. At the end of the job, the detection
+// probabilities are written in the text format read by ELLookupTable.
+// Points outside the fundamental domain of the symmetry of the detector
+// are not simulated and have no entries in the table.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef LIGHT_TABLE_PERSISTENCY_MANAGER_H
+#define LIGHT_TABLE_PERSISTENCY_MANAGER_H
+
+#include "PersistencyManagerBase.h"
+
+#include <map>
+#include <vector>
+
+class G4GenericMessenger;
+
+
+namespace nexus {
+
+  class LightTableGenerator;
+
+
+  class LightTablePersistencyManager: public PersistencyManagerBase
+  {
+  public:
+    LightTablePersistencyManager();
+    ~LightTablePersistencyManager();
+
+    virtual G4bool Store(const G4Event*);
+    virtual G4bool Store(const G4Run*);
+    virtual G4bool Store(const G4VPhysicalVolume*);
+
+    virtual G4bool Retrieve(G4Event*&);
+    virtual G4bool Retrieve(G4Run*&);
+    virtual G4bool Retrieve(G4VPhysicalVolume*&);
+
+    /// Set the name of the output table
+    void OpenFile(G4String);
+    /// Write the light table to the output file
+    void CloseFile();
+
+  private:
+    const LightTableGenerator* GetGenerator() const;
+    /// Abort if the time bins of the sensor histograms do not
+    /// fit evenly in the time bins of the table
+    void CheckTimeBinning(G4double sensor_bin_size) const;
+
+  private:
+    G4GenericMessenger* msg_; ///< User configuration messenger
+
+    G4String filename_;      ///< Name of the output table
+    G4int time_bins_;        ///< Number of time bins per sensor
+    G4double time_bin_size_; ///< Width of the time bins
+
+    /// Photons detected per grid point, sensor and time bin
+    std::vector<std::map<G4int, std::vector<G4double>>> counts_;
+    /// Photons generated per grid point
+    std::vector<G4double> generated_;
+  };
+
+
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline G4bool LightTablePersistencyManager::Store(const G4Run*)
+  { return true; }
+  inline G4bool LightTablePersistencyManager::Store(const G4VPhysicalVolume*)
+  { return false; }
+  inline G4bool LightTablePersistencyManager::Retrieve(G4Event*&)
+  { return false; }
+  inline G4bool LightTablePersistencyManager::Retrieve(G4Run*&)
+  { return false; }
+  inline G4bool LightTablePersistencyManager::Retrieve(G4VPhysicalVolume*&)
+  { return false; }
+
+} // namespace nexus
+
+#endif
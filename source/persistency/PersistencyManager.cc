@@ -16,6 +16,11 @@
 #include "NexusApp.h"
 #include "DetectorConstruction.h"
 #include "SaveAllSteppingAction.h"
+#include "ProfilingSteppingAction.h"
+#include "DefaultEventAction.h"
+#include "DefaultTrackingAction.h"
+#include "PrimaryGeneration.h"
+#include "GeneratorInfo.h"
 #include "GeometryBase.h"
 #include "HDF5Writer.h"
 #include "PersistencyManagerBase.h"
@@ -23,6 +28,9 @@
 
 #include <G4GenericMessenger.hh>
 #include <G4Event.hh>
+#include <G4PrimaryVertex.hh>
+#include <G4PrimaryParticle.hh>
+#include <G4ParticleDefinition.hh>
 #include <G4TrajectoryContainer.hh>
 #include <G4Trajectory.hh>
 #include <G4SDManager.hh>
@@ -32,6 +40,7 @@
 
 #include <string>
 #include <sstream>
+#include <cstring>
 #include <iostream>
 #include <string>
 
@@ -44,9 +53,10 @@ REGISTER_CLASS(PersistencyManager, PersistencyManagerBase)
 PersistencyManager::PersistencyManager():
   PersistencyManagerBase(), msg_(0), ready_(false),
   store_evt_(true), store_steps_(false),
-  interacting_evt_(false), save_ie_numb_(false), event_type_("other"),
+  interacting_evt_(false), save_ie_numb_(false), save_primaries_(false),
+  event_type_("other"),
   saved_evts_(0), interacting_evts_(0), pmt_bin_size_(-1), sipm_bin_size_(-1),
-  nevt_(0), start_id_(0), first_evt_(true), h5writer_(0)
+  nevt_(0), start_id_(0), first_evt_(true), h5writer_(0), ihit_(0)
 {
   msg_ = new G4GenericMessenger(this, "/nexus/persistency/");
   msg_->DeclareMethod("outputFile", &PersistencyManager::OpenFile, "");
@@ -54,6 +64,17 @@ PersistencyManager::PersistencyManager():
                         "Type of event: bb0nu, bb2nu, background.");
   msg_->DeclareProperty("start_id", start_id_,
                         "Starting event ID for this job.");
+  msg_->DeclareProperty("save_primaries", save_primaries_,
+                        "Save the primary vertices of the events in /MC/primaries.");
+
+  G4GenericMessenger::Command& voxel_cmd =
+    msg_->DeclareMethodWithUnit("hit_voxel_size", "mm",
+                                &PersistencyManager::SetHitVoxelSize,
+                                "Side of the voxels the ionization hits are merged into (0 to keep every step).");
+  voxel_cmd.SetParameterName("hit_voxel_size", false);
+  voxel_cmd.SetRange("hit_voxel_size>=0.");
+  msg_->DeclareMethod("hit_voxel_per_track", &PersistencyManager::SetHitVoxelPerTrack,
+                      "Merge the ionization hits of each track separately.");
 
   init_macro_ = "";
   macros_.clear();
@@ -141,12 +162,20 @@ G4bool PersistencyManager::Store(const G4Event* event)
   if (store_steps_)
     StoreSteps();
 
+  // Store the source of the event, for the generators that tell it
+  const GeneratorInfo* gen_info = GetGeneratorInfo();
+  if (gen_info && gen_info->GetEventSourceID() >= 0)
+    h5writer_->WriteSourceInfo(nevt_, gen_info->GetEventSourceID());
+
+  // Store the primary vertices, to be replayed by HDF5ReplayGenerator
+  if (save_primaries_)
+    StorePrimaries(event);
+
   // Store the trajectories of the event
   StoreTrajectories(event->GetTrajectoryContainer());
 
   // Store ionization hits and sensor hits
-  ihits_ = nullptr;
-  hit_map_.clear();
+  ihit_ = 0;
   StoreHits(event->GetHCofThisEvent());
 
   nevt_++;
@@ -158,17 +187,71 @@ G4bool PersistencyManager::Store(const G4Event* event)
 }
 
 
+void PersistencyManager::StorePrimaries(const G4Event* event)
+{
+  // Particles are numbered from 1 within the event, following
+  // the order of the vertices, and the daughters of the pre-assigned
+  // decays refer to their mother (0 for the particles of the vertex)
+  G4int particle_id = 0;
+  for (G4int i=0; i<event->GetNumberOfPrimaryVertex(); ++i) {
+    G4PrimaryVertex* vertex = event->GetPrimaryVertex(i);
+    G4PrimaryParticle* particle = vertex->GetPrimary();
+    while (particle) {
+      StorePrimaryParticle(particle, i, 0, particle_id,
+                           vertex->GetPosition(), vertex->GetT0());
+      particle = particle->GetNext();
+    }
+  }
+}
+
+
+
+void PersistencyManager::StorePrimaryParticle(G4PrimaryParticle* particle,
+                                              G4int vertex_id, G4int mother_id,
+                                              G4int& particle_id,
+                                              const G4ThreeVector& position,
+                                              G4double time)
+{
+  G4int id = ++particle_id;
+
+  G4ThreeVector mom = particle->GetMomentum();
+  G4ThreeVector pol = particle->GetPolarization();
+  G4String name = particle->GetG4code() ?
+    particle->GetG4code()->GetParticleName() : G4String("");
+  h5writer_->WritePrimaryInfo(nevt_, vertex_id, id, mother_id,
+                              particle->GetPDGcode(), name.c_str(),
+                              position.x(), position.y(), position.z(), time,
+                              mom.x(), mom.y(), mom.z(),
+                              pol.x(), pol.y(), pol.z(),
+                              particle->GetMass(), particle->GetCharge(),
+                              particle->GetWeight());
+
+  G4PrimaryParticle* daughter = particle->GetDaughter();
+  while (daughter) {
+    StorePrimaryParticle(daughter, vertex_id, id, particle_id, position, time);
+    daughter = daughter->GetNext();
+  }
+}
+
+
+
 void PersistencyManager::StoreTrajectories(G4TrajectoryContainer* tc)
 {
   // If the pointer is null, no trajectories were stored in this event
   if (!tc) return;
 
+  // With trajectory pruning, the trajectories not kept are skipped
+  // and the mother of each particle is its closest stored ancestor
+  const DefaultTrackingAction* tracking = dynamic_cast<const DefaultTrackingAction*>
+    (G4RunManager::GetRunManager()->GetUserTrackingAction());
+
   // Loop through the trajectories stored in the container
   for (size_t i=0; i<tc->entries(); ++i) {
     Trajectory* trj = dynamic_cast<Trajectory*>((*tc)[i]);
     if (!trj) continue;
 
     G4int trackid = trj->GetTrackID();
+    if (tracking && !tracking->IsKept(trackid)) continue;
 
     G4double length = trj->GetTrackLength();
 
@@ -193,6 +276,7 @@ void PersistencyManager::StoreTrajectories(G4TrajectoryContainer* tc)
       primary = 1;
     } else {
       mother_id = trj->GetParentID();
+      if (tracking) mother_id = tracking->GetKeptAncestor(mother_id);
     }
     h5writer_->WriteParticleInfo(nevt_, trackid, trj->GetParticleName().c_str(),
 				 primary, mother_id,
@@ -206,7 +290,8 @@ void PersistencyManager::StoreTrajectories(G4TrajectoryContainer* tc)
                                  (float)final_mom.y(), (float)final_mom.z(),
 				 kin_energy, length,
                                  trj->GetCreatorProcess().c_str(),
-				 trj->GetFinalProcess().c_str());
+				 trj->GetFinalProcess().c_str(),
+                                 trj->GetWeight());
 
   }
 }
@@ -254,35 +339,40 @@ void PersistencyManager::StoreIonizationHits(G4VHitsCollection* hc)
     dynamic_cast<IonizationHitsCollection*>(hc);
   if (!hits) return;
 
-  double evt_energy = 0.;
   std::string sdname = hits->GetSDname();
 
+  // Hits point to stored particles only, if the trajectories are pruned
+  const DefaultTrackingAction* tracking = dynamic_cast<const DefaultTrackingAction*>
+    (G4RunManager::GetRunManager()->GetUserTrackingAction());
+
+  // All the hits of the collection are written at once
+  std::vector<hit_info_t> rows;
+  rows.reserve(hits->entries());
+
   for (size_t i=0; i<hits->entries(); i++) {
 
     IonizationHit* hit = dynamic_cast<IonizationHit*>(hits->GetHit(i));
     if (!hit) continue;
 
-    G4int trackid = hit->GetTrackID();
-
-
-    std::map<G4int, std::vector<G4int>* >::iterator it = hit_map_.find(trackid);
-    if (it != hit_map_.end()) {
-      ihits_ = it->second;
-    } else {
-      ihits_ = new std::vector<G4int>;
-      hit_map_[trackid] = ihits_;
-    }
-
-    ihits_->push_back(1);
-
     G4ThreeVector xyz = hit->GetPosition();
-    h5writer_->WriteHitInfo(nevt_, trackid,  ihits_->size() - 1,
-			    xyz[0], xyz[1], xyz[2],
-			    hit->GetTime(), hit->GetEnergyDeposit(),
-			    sdname.c_str());
 
-    evt_energy += hit->GetEnergyDeposit();
+    hit_info_t row;
+    row.event_id    = nevt_;
+    row.x           = xyz.x();
+    row.y           = xyz.y();
+    row.z           = xyz.z();
+    row.time        = hit->GetTime();
+    row.energy      = hit->GetEnergyDeposit();
+    memset(row.label, 0, STRLEN);
+    strncpy(row.label, sdname.c_str(), STRLEN-1);
+    row.particle_id = tracking ? tracking->GetKeptAncestor(hit->GetTrackID())
+                               : hit->GetTrackID();
+    row.hit_id      = ihit_++;
+    row.weight      = hit->GetWeight();
+    rows.push_back(row);
   }
+
+  h5writer_->WriteHitInfo(rows);
 }
 
 
@@ -374,6 +464,15 @@ void PersistencyManager::StoreSteps()
   sa->Reset();
 }
 
+
+const GeneratorInfo* PersistencyManager::GetGeneratorInfo() const
+{
+  const PrimaryGeneration* pg = dynamic_cast<const PrimaryGeneration*>
+    (G4RunManager::GetRunManager()->GetUserPrimaryGeneratorAction());
+  return pg ? dynamic_cast<const GeneratorInfo*>(pg->GetGenerator()) : nullptr;
+}
+
+
 G4bool PersistencyManager::Store(const G4Run*)
 {
   // Store the event type
@@ -400,6 +499,40 @@ G4bool PersistencyManager::Store(const G4Run*)
                            (std::to_string(it->second/microsecond)+" mus").c_str());
   }
 
+  // Store the run info of the generator, if it has any
+  // (e.g. the quantities needed to normalise the events to a rate)
+  const GeneratorInfo* gen_info = GetGeneratorInfo();
+  if (gen_info) {
+    GeneratorRunInfo info;
+    gen_info->GetRunInfo(info);
+    for (auto& entry: info)
+      h5writer_->WriteRunInfo(entry.first.c_str(), entry.second.c_str());
+  }
+
+  // Store the stepping profile, if it was recorded
+  const ProfilingSteppingAction* profiler =
+    dynamic_cast<const ProfilingSteppingAction*>
+    (G4RunManager::GetRunManager()->GetUserSteppingAction());
+  if (profiler) {
+    std::vector<ProfileEntry> profile = profiler->GetProfile();
+    for (auto& entry: profile)
+      h5writer_->WriteProfileInfo(entry.particle.c_str(), entry.volume.c_str(),
+                                  entry.process.c_str(), entry.steps,
+                                  entry.tracks, entry.cpu_time);
+  }
+
+  // Store the throughput and memory usage of the run
+  const DefaultEventAction* evt_action =
+    dynamic_cast<const DefaultEventAction*>
+    (G4RunManager::GetRunManager()->GetUserEventAction());
+  if (evt_action) {
+    for (auto& stat: evt_action->GetRunStatistics()) {
+      std::ostringstream value;
+      value << stat.second;
+      h5writer_->WriteRunStats(stat.first.c_str(), value.str().c_str());
+    }
+  }
+
   SaveConfigurationInfo(init_macro_);
   for (unsigned long i=0; i<macros_.size(); i++) {
     SaveConfigurationInfo(macros_[i]);
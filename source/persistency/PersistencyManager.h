@@ -11,13 +11,17 @@
 #define PERSISTENCY_MANAGER_H
 
 #include "PersistencyManagerBase.h"
+#include "IonizationSD.h"
 
 #include <G4VPersistencyManager.hh>
+#include <G4ThreeVector.hh>
 #include <map>
 #include <vector>
 
 
 class G4GenericMessenger;
+class G4Event;
+class G4PrimaryParticle;
 class G4TrajectoryContainer;
 class G4HCofThisEvent;
 class G4VHitsCollection;
@@ -25,6 +29,7 @@ class G4VHitsCollection;
 namespace nexus {
   class HDF5Writer;
   class IonizationHit;
+  class GeneratorInfo;
 }
 
 namespace nexus {
@@ -46,6 +51,11 @@ namespace nexus {
     void StoreSteps(G4bool);
     void SaveNumbOfInteractingEvents(G4bool);
 
+    /// Merge the ionization hits into voxels of the given side
+    void SetHitVoxelSize(G4double);
+    /// Keep the tracks apart when merging the ionization hits
+    void SetHitVoxelPerTrack(G4bool);
+
     ///
     virtual G4bool Store(const G4Event*);
     virtual G4bool Store(const G4Run*);
@@ -61,6 +71,10 @@ namespace nexus {
 
 
   private:
+    void StorePrimaries(const G4Event*);
+    void StorePrimaryParticle(G4PrimaryParticle*, G4int vertex_id,
+                              G4int mother_id, G4int& particle_id,
+                              const G4ThreeVector& position, G4double time);
     void StoreTrajectories(G4TrajectoryContainer*);
     void StoreHits(G4HCofThisEvent*);
     void StoreIonizationHits(G4VHitsCollection*);
@@ -69,6 +83,9 @@ namespace nexus {
 
     void SaveConfigurationInfo(G4String history);
 
+    /// Primary generator of the run, if it stores information of its own
+    const GeneratorInfo* GetGeneratorInfo() const;
+
 
   private:
     G4GenericMessenger* msg_; ///< User configuration messenger
@@ -83,6 +100,7 @@ namespace nexus {
     G4bool store_steps_; ///< Should we store the steps for the current event?
     G4bool interacting_evt_; ///< Has the current event interacted in ACTIVE?
     G4bool save_ie_numb_; ///< Should we save the number of interacting events in the configuration table?
+    G4bool save_primaries_; ///< Should we save the primary vertices of the events?
 
     G4String event_type_; ///< event type: bb0nu, bb2nu, background or not set
 
@@ -96,8 +114,7 @@ namespace nexus {
 
     HDF5Writer* h5writer_;  ///< Event writer to hdf5 file
 
-    std::vector<G4int>* ihits_;
-    std::map<G4int, std::vector<G4int>* > hit_map_;
+    G4int ihit_; ///< Index of the next ionization hit of the event
     std::vector<G4int> sns_posvec_;
 
     std::map<G4String, G4double> sensdet_bin_;
@@ -114,6 +131,10 @@ namespace nexus {
   { interacting_evt_ = ie; }
   inline void PersistencyManager::SaveNumbOfInteractingEvents(G4bool sie)
   {save_ie_numb_ = sie;}
+  inline void PersistencyManager::SetHitVoxelSize(G4double size)
+  { IonizationSD::SetVoxelSize(size); }
+  inline void PersistencyManager::SetHitVoxelPerTrack(G4bool per_track)
+  { IonizationSD::SetVoxelPerTrack(per_track); }
   inline G4bool PersistencyManager::Store(const G4VPhysicalVolume*)
   { return false; }
   inline G4bool PersistencyManager::Retrieve(G4Event*&)
@@ -49,6 +49,7 @@ hsize_t createHitInfoType()
   H5Tinsert (memtype, "label", HOFFSET (hit_info_t, label), strtype);
   H5Tinsert (memtype, "particle_id", HOFFSET (hit_info_t, particle_id), H5T_NATIVE_INT);
   H5Tinsert (memtype, "hit_id", HOFFSET (hit_info_t, hit_id), H5T_NATIVE_INT);
+  H5Tinsert (memtype, "weight", HOFFSET (hit_info_t, weight), H5T_NATIVE_FLOAT);
   return memtype;
 }
 
@@ -88,6 +89,7 @@ hsize_t createParticleInfoType()
   H5Tinsert (memtype, "length", HOFFSET (particle_info_t, length), H5T_NATIVE_FLOAT);
   H5Tinsert (memtype, "creator_proc", HOFFSET (particle_info_t, creator_proc), proc_strtype);
   H5Tinsert (memtype, "final_proc", HOFFSET (particle_info_t, final_proc), proc_strtype);
+  H5Tinsert (memtype, "weight", HOFFSET (particle_info_t, weight), H5T_NATIVE_FLOAT);
   return memtype;
 }
 
@@ -134,6 +136,60 @@ hsize_t createStepType()
   return memtype;
 }
 
+hsize_t createProfileType()
+{
+  hid_t strtype = H5Tcopy(H5T_C_S1);
+  H5Tset_size (strtype, STRLEN);
+
+  //Create compound datatype for the table
+  hsize_t memtype = H5Tcreate (H5T_COMPOUND, sizeof(profile_info_t));
+  H5Tinsert (memtype, "particle_name", HOFFSET(profile_info_t, particle_name), strtype          );
+  H5Tinsert (memtype, "volume"       , HOFFSET(profile_info_t, volume       ), strtype          );
+  H5Tinsert (memtype, "proc_name"    , HOFFSET(profile_info_t, proc_name    ), strtype          );
+  H5Tinsert (memtype, "steps"        , HOFFSET(profile_info_t, steps        ), H5T_NATIVE_UINT64);
+  H5Tinsert (memtype, "tracks"       , HOFFSET(profile_info_t, tracks       ), H5T_NATIVE_UINT64);
+  H5Tinsert (memtype, "cpu_time"     , HOFFSET(profile_info_t, cpu_time     ), H5T_NATIVE_DOUBLE);
+  return memtype;
+}
+
+hsize_t createPrimaryType()
+{
+  hid_t strtype = H5Tcopy(H5T_C_S1);
+  H5Tset_size (strtype, STRLEN);
+
+  //Create compound datatype for the table
+  hsize_t memtype = H5Tcreate (H5T_COMPOUND, sizeof(primary_info_t));
+  H5Tinsert (memtype, "event_id"      , HOFFSET(primary_info_t, event_id      ), H5T_NATIVE_INT64 );
+  H5Tinsert (memtype, "vertex_id"     , HOFFSET(primary_info_t, vertex_id     ), H5T_NATIVE_INT   );
+  H5Tinsert (memtype, "particle_id"   , HOFFSET(primary_info_t, particle_id   ), H5T_NATIVE_INT   );
+  H5Tinsert (memtype, "mother_id"     , HOFFSET(primary_info_t, mother_id     ), H5T_NATIVE_INT   );
+  H5Tinsert (memtype, "pdg_code"      , HOFFSET(primary_info_t, pdg_code      ), H5T_NATIVE_INT   );
+  H5Tinsert (memtype, "particle_name" , HOFFSET(primary_info_t, particle_name ), strtype          );
+  H5Tinsert (memtype, "x"             , HOFFSET(primary_info_t, x             ), H5T_NATIVE_DOUBLE);
+  H5Tinsert (memtype, "y"             , HOFFSET(primary_info_t, y             ), H5T_NATIVE_DOUBLE);
+  H5Tinsert (memtype, "z"             , HOFFSET(primary_info_t, z             ), H5T_NATIVE_DOUBLE);
+  H5Tinsert (memtype, "time"          , HOFFSET(primary_info_t, time          ), H5T_NATIVE_DOUBLE);
+  H5Tinsert (memtype, "px"            , HOFFSET(primary_info_t, px            ), H5T_NATIVE_DOUBLE);
+  H5Tinsert (memtype, "py"            , HOFFSET(primary_info_t, py            ), H5T_NATIVE_DOUBLE);
+  H5Tinsert (memtype, "pz"            , HOFFSET(primary_info_t, pz            ), H5T_NATIVE_DOUBLE);
+  H5Tinsert (memtype, "polarization_x", HOFFSET(primary_info_t, polarization_x), H5T_NATIVE_DOUBLE);
+  H5Tinsert (memtype, "polarization_y", HOFFSET(primary_info_t, polarization_y), H5T_NATIVE_DOUBLE);
+  H5Tinsert (memtype, "polarization_z", HOFFSET(primary_info_t, polarization_z), H5T_NATIVE_DOUBLE);
+  H5Tinsert (memtype, "mass"          , HOFFSET(primary_info_t, mass          ), H5T_NATIVE_DOUBLE);
+  H5Tinsert (memtype, "charge"        , HOFFSET(primary_info_t, charge        ), H5T_NATIVE_DOUBLE);
+  H5Tinsert (memtype, "weight"        , HOFFSET(primary_info_t, weight        ), H5T_NATIVE_DOUBLE);
+  return memtype;
+}
+
+hsize_t createSourceType()
+{
+  //Create compound datatype for the table
+  hsize_t memtype = H5Tcreate (H5T_COMPOUND, sizeof(source_info_t));
+  H5Tinsert (memtype, "event_id" , HOFFSET(source_info_t, event_id ), H5T_NATIVE_INT64);
+  H5Tinsert (memtype, "source_id", HOFFSET(source_info_t, source_id), H5T_NATIVE_INT  );
+  return memtype;
+}
+
 hid_t createTable(hid_t group, std::string& table_name, hsize_t memtype)
 {
   //Create 1D dataspace (evt number). First dimension is unlimited (initially 0)
@@ -231,6 +287,29 @@ void writeHit(hit_info_t* hitInfo, hid_t dataset, hid_t memtype, hsize_t counter
   H5Sclose(memspace);
 }
 
+void writeHits(const hit_info_t* hitInfo, hsize_t nhits, hid_t dataset, hid_t memtype, hsize_t counter)
+{
+  if (nhits == 0) return;
+
+  hid_t memspace, file_space;
+
+  // Extend the dataset once for all the rows
+  const hsize_t n_dims = 1;
+  hsize_t dims[n_dims] = {nhits};
+  memspace = H5Screate_simple(n_dims, dims, NULL);
+
+  dims[0] = counter + nhits;
+  H5Dset_extent(dataset, dims);
+
+  file_space = H5Dget_space(dataset);
+  hsize_t start[1] = {counter};
+  hsize_t count[1] = {nhits};
+  H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+  H5Dwrite(dataset, memtype, memspace, file_space, H5P_DEFAULT, hitInfo);
+  H5Sclose(file_space);
+  H5Sclose(memspace);
+}
+
 void writeParticle(particle_info_t* particleInfo, hid_t dataset, hid_t memtype, hsize_t counter)
 {
   hid_t memspace, file_space;
@@ -292,3 +371,88 @@ void writeStep(step_info_t* step, hid_t dataset, hid_t memtype, hsize_t counter)
   H5Sclose(file_space);
   H5Sclose(memspace);
 }
+
+void writeProfile(profile_info_t* profile, hid_t dataset, hid_t memtype, hsize_t counter)
+{
+  hid_t memspace, file_space;
+
+  const hsize_t n_dims = 1;
+  hsize_t dims[n_dims] = {1};
+  memspace = H5Screate_simple(n_dims, dims, NULL);
+
+  dims[0] = counter + 1;
+  H5Dset_extent(dataset, dims);
+
+  file_space = H5Dget_space(dataset);
+  hsize_t start[1] = {counter};
+  hsize_t count[1] = {1};
+  H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+  H5Dwrite(dataset, memtype, memspace, file_space, H5P_DEFAULT, profile);
+  H5Sclose(file_space);
+  H5Sclose(memspace);
+}
+
+void writePrimary(primary_info_t* primary, hid_t dataset, hid_t memtype, hsize_t counter)
+{
+  hid_t memspace, file_space;
+
+  const hsize_t n_dims = 1;
+  hsize_t dims[n_dims] = {1};
+  memspace = H5Screate_simple(n_dims, dims, NULL);
+
+  dims[0] = counter + 1;
+  H5Dset_extent(dataset, dims);
+
+  file_space = H5Dget_space(dataset);
+  hsize_t start[1] = {counter};
+  hsize_t count[1] = {1};
+  H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+  H5Dwrite(dataset, memtype, memspace, file_space, H5P_DEFAULT, primary);
+  H5Sclose(file_space);
+  H5Sclose(memspace);
+}
+
+void writeSource(source_info_t* source, hid_t dataset, hid_t memtype, hsize_t counter)
+{
+  hid_t memspace, file_space;
+
+  const hsize_t n_dims = 1;
+  hsize_t dims[n_dims] = {1};
+  memspace = H5Screate_simple(n_dims, dims, NULL);
+
+  dims[0] = counter + 1;
+  H5Dset_extent(dataset, dims);
+
+  file_space = H5Dget_space(dataset);
+  hsize_t start[1] = {counter};
+  hsize_t count[1] = {1};
+  H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+  H5Dwrite(dataset, memtype, memspace, file_space, H5P_DEFAULT, source);
+  H5Sclose(file_space);
+  H5Sclose(memspace);
+}
+
+hsize_t readPrimaries(primary_info_t* primaries, hid_t dataset, hid_t memtype,
+                      hsize_t first, hsize_t nrows)
+{
+  // Number of rows available from the first one
+  hid_t file_space = H5Dget_space(dataset);
+  hsize_t dims[1];
+  H5Sget_simple_extent_dims(file_space, dims, NULL);
+  if (first >= dims[0]) {
+    H5Sclose(file_space);
+    return 0;
+  }
+  if (first + nrows > dims[0]) nrows = dims[0] - first;
+
+  // Read all of them with a single call
+  hsize_t count[1] = {nrows};
+  hid_t memspace = H5Screate_simple(1, count, NULL);
+  hsize_t start[1] = {first};
+  H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+  herr_t status = H5Dread(dataset, memtype, memspace, file_space, H5P_DEFAULT, primaries);
+  H5Sclose(file_space);
+  H5Sclose(memspace);
+
+  return status < 0 ? 0 : nrows;
+}
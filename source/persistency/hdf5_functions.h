@@ -37,6 +37,7 @@
         char label[STRLEN];
         int particle_id;
         int hit_id;
+        float weight;
   } hit_info_t;
 
   typedef struct{
@@ -65,6 +66,7 @@
 	float length;
         char creator_proc[STRLEN];
 	char final_proc[STRLEN];
+	float weight;
   } particle_info_t;
 
   typedef struct{
@@ -91,12 +93,51 @@
     float     final_z;
   } step_info_t;
 
+  typedef struct{
+    char     particle_name[STRLEN];
+    char     volume[STRLEN];
+    char     proc_name[STRLEN];
+    uint64_t steps;
+    uint64_t tracks;
+    double   cpu_time;
+  } profile_info_t;
+
+  typedef struct{
+    int64_t event_id;
+    int     vertex_id;
+    int     particle_id;
+    int     mother_id;
+    int     pdg_code;
+    char    particle_name[STRLEN];
+    double  x;
+    double  y;
+    double  z;
+    double  time;
+    double  px;
+    double  py;
+    double  pz;
+    double  polarization_x;
+    double  polarization_y;
+    double  polarization_z;
+    double  mass;
+    double  charge;
+    double  weight;
+  } primary_info_t;
+
+  typedef struct{
+    int64_t event_id;
+    int     source_id;
+  } source_info_t;
+
   hsize_t createRunType();
   hsize_t createSensorDataType();
   hsize_t createHitInfoType();
   hsize_t createParticleInfoType();
   hsize_t createSensorPosType();
   hsize_t createStepType();
+  hsize_t createProfileType();
+  hsize_t createPrimaryType();
+  hsize_t createSourceType();
 
   hid_t createTable(hid_t group, std::string& table_name, hsize_t memtype);
   hid_t createGroup(hid_t file, std::string& groupName);
@@ -104,9 +145,16 @@
   void writeRun(run_info_t* runData, hid_t dataset, hid_t memtype, hsize_t counter);
   void writeSnsData(sns_data_t* snsData, hid_t dataset, hid_t memtype, hsize_t counter);
   void writeHit(hit_info_t* hitInfo, hid_t dataset, hid_t memtype, hsize_t counter);
+  void writeHits(const hit_info_t* hitInfo, hsize_t nhits, hid_t dataset, hid_t memtype, hsize_t counter);
   void writeParticle(particle_info_t* particleInfo, hid_t dataset, hid_t memtype, hsize_t counter);
   void writeSnsPos(sns_pos_t* snsPos, hid_t dataset, hid_t memtype, hsize_t counter);
   void writeStep(step_info_t* step, hid_t dataset, hid_t memtype, hsize_t counter);
+  void writeProfile(profile_info_t* profile, hid_t dataset, hid_t memtype, hsize_t counter);
+  void writePrimary(primary_info_t* primary, hid_t dataset, hid_t memtype, hsize_t counter);
+  void writeSource(source_info_t* source, hid_t dataset, hid_t memtype, hsize_t counter);
+
+  hsize_t readPrimaries(primary_info_t* primaries, hid_t dataset, hid_t memtype,
+                        hsize_t first, hsize_t nrows);
 
 
 #endif
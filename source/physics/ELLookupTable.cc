@@ -2,20 +2,29 @@
 // nexus | ELLookupTable.cc
 //
 // This class describes the generation of the EL light.
+// Tables written by LightTablePersistencyManager describe their grid and
+// symmetry in the header. Tables generated only in the fundamental domain
+// of a symmetry group are looked up by folding the point into the domain
+// and permuting the sensor IDs accordingly.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
 
 #include "ELLookupTable.h"
 
+#include <G4SystemOfUnits.hh>
+
 #include <fstream>
+#include <sstream>
 
 
 
 namespace nexus {
 
 
-  ELLookupTable::ELLookupTable(G4String filename)
+  ELLookupTable::ELLookupTable(G4String filename):
+    grid_(false), grid_min_(0., 0., 0.), grid_max_(0., 0., 0.),
+    pitch_(0., 0., 0.), nodes_{1, 1, 1}, time_bins_(5), time_bin_size_(0.)
   {
     // read the text files and store their content in the transient table
     ReadFiles(filename);
@@ -38,46 +47,173 @@ namespace nexus {
       {}
       //G4Exception("[ELLookupTable] ERROR: cannot open input file!");
 
-    // Deal with the header file
+    // Deal with the header file. The number of time bins, the grid
+    // and the symmetry of the table are read from it when available
+    // (see LightTablePersistencyManager).
     G4String line;
+    G4double radius = 0.;
+    G4int rotation_order = 1;
+    G4int reflection = 0;
 
     do {
       getline(file, line);
+      std::istringstream header(line);
+      std::string star, key;
+      header >> star >> key;
+      if (star != "*") continue;
+      if      (key == "time_bins") header >> time_bins_;
+      else if (key == "time_bin_size") {
+        header >> time_bin_size_;
+        time_bin_size_ *= microsecond;
+      }
+      else if (key == "rotation_order") header >> rotation_order;
+      else if (key == "reflection") header >> reflection;
+      else if (key == "radius") {
+        header >> radius;
+        radius *= mm;
+      }
+      else if (key == "grid_min" || key == "grid_max" || key == "pitch") {
+        G4double x, y, z;
+        header >> x >> y >> z;
+        G4ThreeVector v(x*mm, y*mm, z*mm);
+        if      (key == "grid_min") grid_min_ = v;
+        else if (key == "grid_max") grid_max_ = v;
+        else pitch_ = v;
+        grid_ = true;
+      }
     } while(line[0] == '*');
 
-    // Read file and store content in the transient table
+    symmetry_ = LightTableSymmetry(rotation_order, reflection != 0);
+    if (grid_) BuildGridIndex(radius);
 
-    int num_bins = 5;
-    int last_point_id = 0;
-    std::map<int, std::vector<double> > sensor_map;
+    // Read file and store content in the transient table,
+    // indexed by the point ID
 
-    while (!file.eof()) {
+    G4int point_id, sensor_id;
 
-      G4int point_id, sensor_id;
-      std::vector<double> probs;
+    while (file >> point_id >> sensor_id) {
 
-      file >> point_id >> sensor_id;
+      std::vector<double> probs;
 
-      for (G4int i=0; i<num_bins; i++) {
+      for (G4int i=0; i<time_bins_; i++) {
 	G4double prob;
 	file >> prob;
 	probs.push_back(prob);
       }
 
-      sensor_map.insert(std::make_pair(sensor_id, probs));
+      if (point_id >= (G4int) ELtable_.size())
+        ELtable_.resize(point_id + 1);
+
+      ELtable_[point_id][sensor_id] = probs;
+    }
+  }
+
+
+
+  void ELLookupTable::BuildGridIndex(G4double radius)
+  {
+    // Same grid as in LightTableGenerator: points ordered by x,
+    // then by y and then by z, and skipped outside the radius
+    for (G4int i=0; i<3; ++i) {
+      nodes_[i] = (pitch_[i] > 0.) ?
+        (G4int) std::floor((grid_max_[i] - grid_min_[i]) / pitch_[i] + 0.5) + 1 : 1;
+      nodes_[i] = std::max(nodes_[i], 1);
+    }
+
+    G4double max_r = radius * (1. + 1.e-9);
 
-      if (point_id != last_point_id) {
-	ELtable_.push_back(sensor_map);
+    grid_ids_.assign(nodes_[0] * nodes_[1] * nodes_[2], -1);
+    G4int point_id = 0;
+
+    for (G4int i=0; i<nodes_[0]; ++i) {
+      for (G4int j=0; j<nodes_[1]; ++j) {
+        for (G4int k=0; k<nodes_[2]; ++k) {
+          G4ThreeVector point(grid_min_.x() + i * pitch_.x(),
+                              grid_min_.y() + j * pitch_.y(),
+                              grid_min_.z() + k * pitch_.z());
+          if (radius > 0. && point.perp() > max_r) continue;
+          grid_ids_[(i * nodes_[1] + j) * nodes_[2] + k] = point_id++;
+        }
       }
+    }
+  }
+
+
+
+  std::map<int, std::vector<double> >
+  ELLookupTable::GetSensorsMap(const G4ThreeVector& hitpos)
+  {
+    if (!grid_) return GetCircularGridSensorsMap(hitpos);
+
+    if (symmetry_.IsTrivial()) return GetGridSensorsMap(hitpos);
+
+    // The table contains the point g(p) of the fundamental domain. The
+    // light detected by sensor s from p is that detected by g(s) from g(p).
+    G4ThreeVector image;
+    G4int element = symmetry_.Fold(hitpos, image);
+
+    if (!symmetry_.HasSensorPermutation())
+      symmetry_.BuildSensorPermutation(LightTableSymmetry::FindSensors(), 0.1*mm);
 
-      last_point_id = point_id;
+    std::map<int, std::vector<double> > folded_map;
+    for (auto& sensor: GetGridSensorsMap(image)) {
+      G4int sensor_id = symmetry_.UnmapSensor(element, sensor.first);
+      if (sensor_id >= 0) folded_map[sensor_id] = sensor.second;
     }
+
+    return folded_map;
+  }
+
+
+
+  G4long ELLookupTable::GetCellID(const G4ThreeVector& hitpos) const
+  {
+    // Tables without header are looked up by the 5-mm bins of x and y
+    if (!grid_) {
+      G4long binX = (G4long) std::ceil(hitpos[0]/5.);
+      G4long binY = (G4long) std::ceil(hitpos[1]/5.);
+      return (binX + 100000) * 200000 + (binY + 100000);
+    }
+
+    // Folded points are also told apart by the symmetry
+    // element, which permutes the sensors of the entry
+    G4ThreeVector image = hitpos;
+    G4int element = 0;
+    if (!symmetry_.IsTrivial()) element = symmetry_.Fold(hitpos, image);
+
+    return (G4long) GetGridNode(image) * symmetry_.GetOrder() + element;
+  }
+
+
+
+  G4int ELLookupTable::GetGridNode(const G4ThreeVector& pos) const
+  {
+    // Closest node of the grid
+    G4int node[3];
+    for (G4int i=0; i<3; ++i) {
+      node[i] = (pitch_[i] > 0.) ?
+        (G4int) std::floor((pos[i] - grid_min_[i]) / pitch_[i] + 0.5) : 0;
+      node[i] = std::min(std::max(node[i], 0), nodes_[i] - 1);
+    }
+
+    return (node[0] * nodes_[1] + node[1]) * nodes_[2] + node[2];
   }
 
 
 
   const std::map<int, std::vector<double> >&
-  ELLookupTable::GetSensorsMap(const G4ThreeVector& hitpos)
+  ELLookupTable::GetGridSensorsMap(const G4ThreeVector& pos)
+  {
+    G4int id = grid_ids_[GetGridNode(pos)];
+    if (id < 0 || id >= (G4int) ELtable_.size()) return empty_map_;
+
+    return ELtable_[id];
+  }
+
+
+
+  const std::map<int, std::vector<double> >&
+  ELLookupTable::GetCircularGridSensorsMap(const G4ThreeVector& hitpos)
   {
     /// The EL points must be in the middle of the bins.
     double radius = 92.5; // mm
@@ -2,6 +2,10 @@
 // nexus | ELLookupTable.h
 //
 // This class describes the generation of the EL light.
+// Tables written by LightTablePersistencyManager describe their grid and
+// symmetry in the header. Tables generated only in the fundamental domain
+// of a symmetry group are looked up by folding the point into the domain
+// and permuting the sensor IDs accordingly.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -13,6 +17,8 @@
 #include <G4ThreeVector.hh>
 #include <globals.hh>
 
+#include "LightTableSymmetry.h"
+
 #include <vector>
 #include <map>
 
@@ -30,17 +36,65 @@ namespace nexus {
     /// Read input files and store their content in the transient table
     void ReadFiles(G4String);
 
-    /// Returns the appropiate sensor map for a given point in the EL gap
-    virtual const std::map<int, std::vector<double> >&
+    /// Returns the appropiate sensor map for a given point in the EL gap.
+    /// It is returned by value, since the map of a point folded by the
+    /// symmetry of the table is built for each call.
+    virtual std::map<int, std::vector<double> >
     GetSensorsMap(const G4ThreeVector&);
 
+    /// Identifier of the table entry used for a point: points with the
+    /// same ID have the same sensor map
+    G4long GetCellID(const G4ThreeVector&) const;
+
+    /// Number of time bins of the probabilities of every sensor
+    G4int GetNumberOfTimeBins() const;
+    /// Width of the time bins (0 if not given in the header)
+    G4double GetTimeBinSize() const;
+
+  private:
+    /// Sensor map of a point of the table grid described in the header
+    const std::map<int, std::vector<double> >&
+    GetGridSensorsMap(const G4ThreeVector&);
+
+    /// Index of the grid node closest to a point
+    G4int GetGridNode(const G4ThreeVector&) const;
+
+    /// Sensor map of a point of the 5-mm circular grid of the
+    /// tables without header information
+    const std::map<int, std::vector<double> >&
+    GetCircularGridSensorsMap(const G4ThreeVector&);
+
+    /// Compute the point ID of every node of the grid
+    void BuildGridIndex(G4double radius);
 
   private:
 
     std::vector<std::map<int, std::vector<double> > > ELtable_;
 
+    G4bool grid_;             ///< The header describes the grid of the table
+    G4ThreeVector grid_min_;  ///< Lower corner of the grid
+    G4ThreeVector grid_max_;  ///< Upper corner of the grid
+    G4ThreeVector pitch_;     ///< Distance between grid points along each axis
+    G4int nodes_[3];          ///< Number of grid nodes along each axis
+    std::vector<G4int> grid_ids_; ///< Point ID of every node (-1 if none)
+
+    G4int time_bins_;         ///< Number of time bins per sensor
+    G4double time_bin_size_;  ///< Width of the time bins
+
+    LightTableSymmetry symmetry_; ///< Symmetry group of the table
+
+    /// Returned for points not covered by the table
+    const std::map<int, std::vector<double> > empty_map_;
   };
 
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline G4int ELLookupTable::GetNumberOfTimeBins() const
+  { return time_bins_; }
+
+  inline G4double ELLookupTable::GetTimeBinSize() const
+  { return time_bin_size_; }
+
 } // end namespace nexus
 
 #endif
@@ -10,6 +10,7 @@
 
 #include "IonizationElectron.h"
 #include "BaseDriftField.h"
+#include "IOUtils.h"
 
 #include <G4MaterialPropertiesTable.hh>
 #include <G4ParticleChange.hh>
@@ -28,13 +29,11 @@ using namespace CLHEP;
 Electroluminescence::Electroluminescence(const G4String& process_name,
 					                               G4ProcessType type):
   G4VDiscreteProcess(process_name, type), theFastIntegralTable_(0),
-  table_generation_(false), photons_per_point_(0)
+  table_generation_(false), photons_per_point_(0), yield_factor_(1.)
 {
   ParticleChange_ = new G4ParticleChange();
   pParticleChange = ParticleChange_;
 
-  BuildThePhysicsTable();
-
    /// Messenger
   msg_ = new G4GenericMessenger(this, "/Physics/Electroluminescence/",
 				"Control commands of the Electroluminescence physics process.");
@@ -78,7 +77,7 @@ Electroluminescence::PostStepDoIt(const G4Track& track, const G4Step& step)
   }
 
   // Get the light yield from the field
-  const G4double yield = field->LightYield();
+  const G4double yield = field->LightYield() * yield_factor_;
   G4double step_length = step.GetStepLength();
 
   if (yield <= 0.)
@@ -97,8 +96,14 @@ Electroluminescence::PostStepDoIt(const G4Track& track, const G4Step& step)
     num_photons = G4int(G4RandGauss::shoot(mean, sigma) + 0.5);
   }
 
-  if (table_generation_)
-    num_photons = photons_per_point_;
+  // With the optical prescale, the number of photons per point is scaled
+  // like the yield (rounded up or down at random to keep it unbiased)
+  // so that the table keeps its normalization to photons_per_point
+  if (table_generation_) {
+    G4double scaled = photons_per_point_ * yield_factor_;
+    num_photons = G4int(scaled);
+    if (G4UniformRand() < scaled - num_photons) ++num_photons;
+  }
 
   ParticleChange_->SetNumberOfSecondaries(num_photons);
 
@@ -189,6 +194,40 @@ Electroluminescence::PostStepDoIt(const G4Track& track, const G4Step& step)
 
 
 
+void Electroluminescence::BuildPhysicsTable(const G4ParticleDefinition&)
+{
+  BuildThePhysicsTable();
+}
+
+
+
+G4bool Electroluminescence::StorePhysicsTable(const G4ParticleDefinition* particle,
+                                              const G4String& directory, G4bool)
+{
+  if (!theFastIntegralTable_) return true;
+
+  G4String filename =
+    GetPhysicsTableFileName(particle, directory, "ELIntegral", true);
+  return StorePhysicsVectors(theFastIntegralTable_, filename);
+}
+
+
+
+G4bool Electroluminescence::RetrievePhysicsTable(const G4ParticleDefinition* particle,
+                                                 const G4String& directory, G4bool)
+{
+  if (theFastIntegralTable_) return true;
+
+  G4String filename =
+    GetPhysicsTableFileName(particle, directory, "ELIntegral", true);
+  theFastIntegralTable_ =
+    RetrievePhysicsVectors(filename, G4Material::GetNumberOfMaterials());
+
+  return (theFastIntegralTable_ != nullptr);
+}
+
+
+
 void Electroluminescence::BuildThePhysicsTable()
 {
   if (theFastIntegralTable_) return;
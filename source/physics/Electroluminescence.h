@@ -36,6 +36,16 @@ namespace nexus {
     /// secondaries at the end of the step.
     G4VParticleChange* PostStepDoIt(const G4Track&, const G4Step&);
 
+    /// Build the integral table of the EL spectrum of every material
+    void BuildPhysicsTable(const G4ParticleDefinition&);
+    /// Save the integral table in the given directory
+    G4bool StorePhysicsTable(const G4ParticleDefinition*, const G4String&, G4bool);
+    /// Load the integral table saved by StorePhysicsTable
+    G4bool RetrievePhysicsTable(const G4ParticleDefinition*, const G4String&, G4bool);
+
+    /// Scale the light yield (used to pre-scale the optical photons)
+    void SetYieldFactor(G4double);
+
   private:
 
     /// Returns infinity; i.e., the process does not limit the step,
@@ -56,8 +66,15 @@ namespace nexus {
 
     G4bool table_generation_;
     G4int photons_per_point_;
+
+    G4double yield_factor_; ///< Scale factor of the light yield
   };
 
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline void Electroluminescence::SetYieldFactor(G4double factor)
+  { yield_factor_ = factor; }
+
 } // end namespace nexus
 
 #endif
@@ -0,0 +1,182 @@
+// ----------------------------------------------------------------------------
+// nexus | ImportanceBiasing.cc
+//
+// Geometric importance biasing of gammas. Each logical volume (or, if
+// it has none, its region) is given an importance. When a gamma crosses
+// a boundary towards a volume of higher importance it is split into
+// copies, and towards a volume of lower importance it plays Russian
+// roulette. The track weights are adjusted so that the results remain
+// unbiased, and are stored in the output together with particles and hits.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "ImportanceBiasing.h"
+
+#include <G4Gamma.hh>
+#include <G4GenericMessenger.hh>
+#include <G4LogicalVolume.hh>
+#include <G4Region.hh>
+#include <Randomize.hh>
+
+#include <sstream>
+
+
+namespace nexus {
+
+
+  ImportanceBiasing::ImportanceBiasing(const G4String& process_name,
+                                       G4ProcessType type):
+    G4VDiscreteProcess(process_name, type), msg_(0),
+    splits_(0.), roulettes_(0.), killed_(0.)
+  {
+    particle_change_ = new G4ParticleChange();
+    pParticleChange = particle_change_;
+    // The weights of the copies are set here
+    particle_change_->SetSecondaryWeightByProcess(true);
+
+    msg_ = new G4GenericMessenger(this, "/Physics/ImportanceBiasing/",
+      "Control commands of the geometric importance biasing.");
+
+    msg_->DeclareMethod("importance", &ImportanceBiasing::SetImportance,
+                        "Importance of a logical volume or region: name importance.");
+  }
+
+
+
+  ImportanceBiasing::~ImportanceBiasing()
+  {
+    delete msg_;
+    delete particle_change_;
+  }
+
+
+
+  G4bool ImportanceBiasing::IsApplicable(const G4ParticleDefinition& pdef)
+  {
+    return (&pdef == G4Gamma::Definition());
+  }
+
+
+
+  G4double ImportanceBiasing::GetMeanFreePath(const G4Track&, G4double,
+                                              G4ForceCondition* condition)
+  {
+    *condition = StronglyForced;
+    return DBL_MAX;
+  }
+
+
+
+  void ImportanceBiasing::SetImportance(G4String command)
+  {
+    std::istringstream iss(command);
+
+    G4String name;
+    G4double importance;
+    iss >> name >> importance;
+
+    if (iss.fail() || importance <= 0.) {
+      G4Exception("[ImportanceBiasing]", "SetImportance()", FatalException,
+                  ("Wrong importance: " + command).c_str());
+    }
+
+    importances_[name] = importance;
+    importance_cache_.clear();
+  }
+
+
+
+  G4double ImportanceBiasing::GetImportance(const G4LogicalVolume* logic)
+  {
+    auto it = importance_cache_.find(logic);
+    if (it != importance_cache_.end()) return it->second;
+
+    // The logical volume takes precedence over its region
+    G4double importance = 1.;
+    auto imp = importances_.find(logic->GetName());
+    if (imp == importances_.end() && logic->GetRegion())
+      imp = importances_.find(logic->GetRegion()->GetName());
+    if (imp != importances_.end()) importance = imp->second;
+
+    importance_cache_[logic] = importance;
+    return importance;
+  }
+
+
+
+  G4VParticleChange*
+  ImportanceBiasing::PostStepDoIt(const G4Track& track, const G4Step& step)
+  {
+    particle_change_->Initialize(track);
+
+    if (track.GetTrackStatus() != fAlive ||
+        step.GetPostStepPoint()->GetStepStatus() != fGeomBoundary)
+      return G4VDiscreteProcess::PostStepDoIt(track, step);
+
+    // Leaving the world
+    const G4VPhysicalVolume* post_vol = step.GetPostStepPoint()->GetPhysicalVolume();
+    if (!post_vol) return G4VDiscreteProcess::PostStepDoIt(track, step);
+
+    G4double pre_importance =
+      GetImportance(step.GetPreStepPoint()->GetPhysicalVolume()->GetLogicalVolume());
+    G4double post_importance = GetImportance(post_vol->GetLogicalVolume());
+    if (pre_importance == post_importance)
+      return G4VDiscreteProcess::PostStepDoIt(track, step);
+
+    G4double ratio  = post_importance / pre_importance;
+    G4double weight = track.GetWeight() / ratio;
+
+    if (ratio > 1.) {
+      // Split into n copies (the track included), with n = ratio on average
+      G4int n = (G4int) ratio;
+      if (G4UniformRand() < ratio - n) n++;
+
+      particle_change_->ProposeWeight(weight);
+      particle_change_->SetNumberOfSecondaries(n - 1);
+
+      for (G4int i=1; i<n; ++i) {
+        G4Track* copy =
+          new G4Track(new G4DynamicParticle(*track.GetDynamicParticle()),
+                      track.GetGlobalTime(), track.GetPosition());
+        copy->SetWeight(weight);
+        copy->SetTouchableHandle(step.GetPostStepPoint()->GetTouchableHandle());
+        particle_change_->AddSecondary(copy);
+      }
+      splits_ += n - 1;
+    }
+    else {
+      // Russian roulette: the track survives with probability ratio
+      roulettes_ += 1.;
+      if (G4UniformRand() < ratio) {
+        particle_change_->ProposeWeight(weight);
+      }
+      else {
+        particle_change_->ProposeTrackStatus(fStopAndKill);
+        killed_ += 1.;
+      }
+    }
+
+    return G4VDiscreteProcess::PostStepDoIt(track, step);
+  }
+
+
+
+  void ImportanceBiasing::ResetStatistics()
+  {
+    splits_    = 0.;
+    roulettes_ = 0.;
+    killed_    = 0.;
+  }
+
+
+
+  void ImportanceBiasing::PrintStatistics() const
+  {
+    G4cout << "[ImportanceBiasing] " << splits_ << " copies created by splitting, "
+           << killed_ << " of " << roulettes_ << " tracks killed by Russian roulette"
+           << G4endl;
+  }
+
+
+} // end namespace nexus
@@ -0,0 +1,75 @@
+// ----------------------------------------------------------------------------
+// nexus | ImportanceBiasing.h
+//
+// Geometric importance biasing of gammas. Each logical volume (or, if
+// it has none, its region) is given an importance. When a gamma crosses
+// a boundary towards a volume of higher importance it is split into
+// copies, and towards a volume of lower importance it plays Russian
+// roulette. The track weights are adjusted so that the results remain
+// unbiased, and are stored in the output together with particles and hits.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef IMPORTANCE_BIASING_H
+#define IMPORTANCE_BIASING_H
+
+#include <G4VDiscreteProcess.hh>
+
+#include <map>
+
+class G4GenericMessenger;
+class G4LogicalVolume;
+
+
+namespace nexus {
+
+  class ImportanceBiasing: public G4VDiscreteProcess
+  {
+  public:
+    /// Constructor
+    ImportanceBiasing(const G4String& process_name="ImportanceBiasing",
+                      G4ProcessType type=fUserDefined);
+    /// Destructor
+    ~ImportanceBiasing();
+
+    /// Only gammas apply
+    G4bool IsApplicable(const G4ParticleDefinition&);
+
+    /// Split or roulette the track when it crosses a boundary
+    /// between volumes of different importance
+    G4VParticleChange* PostStepDoIt(const G4Track&, const G4Step&);
+
+    /// Set the importance of a logical volume or region,
+    /// given as "name importance"
+    void SetImportance(G4String);
+
+    /// Reset the splitting statistics
+    void ResetStatistics();
+    /// Print the splitting statistics
+    void PrintStatistics() const;
+
+  private:
+    /// Returns infinity; i. e. the process does not limit the step,
+    /// but sets the 'StronglyForced' condition for the PostStepDoIt
+    /// to be invoked at every step
+    G4double GetMeanFreePath(const G4Track&, G4double, G4ForceCondition*);
+
+    /// Importance of a logical volume (1 if not configured)
+    G4double GetImportance(const G4LogicalVolume*);
+
+  private:
+    G4ParticleChange* particle_change_;
+    G4GenericMessenger* msg_;
+
+    std::map<G4String, G4double> importances_;
+    std::map<const G4LogicalVolume*, G4double> importance_cache_;
+
+    G4double splits_;    ///< Copies created by splitting
+    G4double roulettes_; ///< Tracks that played Russian roulette
+    G4double killed_;    ///< Tracks killed by Russian roulette
+  };
+
+} // end namespace nexus
+
+#endif
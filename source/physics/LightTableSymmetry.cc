@@ -0,0 +1,152 @@
+// ----------------------------------------------------------------------------
+// nexus | LightTableSymmetry.cc
+//
+// Symmetry group of a light table: rotations by multiples of 2pi/N around
+// the z axis, optionally combined with the reflection y -> -y (that is,
+// the cyclic or dihedral group of order N or 2N). Light tables are only
+// generated in the fundamental domain of the group, and the detection
+// probability of any other point is that of its image in the domain,
+// for the sensor to which the group element maps the original one.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "LightTableSymmetry.h"
+
+#include "SensorSD.h"
+
+#include <G4PhysicalConstants.hh>
+
+
+namespace nexus {
+
+
+  LightTableSymmetry::LightTableSymmetry(G4int rotation_order, G4bool reflection):
+    rotation_order_(std::max(rotation_order, 1)), reflection_(reflection)
+  {
+  }
+
+
+
+  LightTableSymmetry::~LightTableSymmetry()
+  {
+  }
+
+
+
+  G4ThreeVector LightTableSymmetry::Transform(G4int element,
+                                              const G4ThreeVector& point) const
+  {
+    G4ThreeVector image = point;
+    if (element >= rotation_order_) image.setY(-image.y());
+    image.rotateZ((element % rotation_order_) * twopi / rotation_order_);
+    return image;
+  }
+
+
+
+  G4int LightTableSymmetry::Fold(const G4ThreeVector& point,
+                                 G4ThreeVector& image) const
+  {
+    G4double sector = twopi / rotation_order_;
+
+    G4double phi = point.phi();
+    if (phi < 0.) phi += twopi;
+
+    G4int k = std::min((G4int) (phi / sector), rotation_order_ - 1);
+
+    // Rotate the point back to the first sector and, in the second half
+    // of the sector, reflect it about the bisector (which is the same as
+    // reflecting it about the x axis and rotating it by one sector)
+    G4int element = (rotation_order_ - k) % rotation_order_;
+    if (reflection_ && phi - k * sector > sector / 2.)
+      element = (k + 1) % rotation_order_ + rotation_order_;
+
+    image = Transform(element, point);
+    return element;
+  }
+
+
+
+  G4bool LightTableSymmetry::InFundamentalDomain(const G4ThreeVector& point,
+                                                 G4double margin) const
+  {
+    if (IsTrivial()) return true;
+
+    G4double r = point.perp();
+    if (r <= margin) return true;
+
+    G4double tolerance = std::asin(std::min(1., margin / r));
+    G4double sector = twopi / rotation_order_;
+    G4double phi = point.phi();
+
+    if (reflection_)
+      return (phi >= -tolerance && phi <= sector / 2. + tolerance);
+    else
+      return (phi >= -tolerance && phi < sector + tolerance);
+  }
+
+
+
+  void LightTableSymmetry::BuildSensorPermutation
+  (const std::map<G4int, G4ThreeVector>& sensors, G4double tolerance)
+  {
+    permutation_.assign(GetOrder(), std::map<G4int, G4int>());
+    inverse_permutation_.assign(GetOrder(), std::map<G4int, G4int>());
+
+    G4int unmatched = 0;
+
+    for (G4int e=0; e<GetOrder(); ++e) {
+      for (auto& sensor: sensors) {
+        G4ThreeVector target = Transform(e, sensor.second);
+        G4int match = -1;
+        for (auto& other: sensors) {
+          if ((other.second - target).mag() < tolerance) {
+            match = other.first;
+            break;
+          }
+        }
+        if (match < 0) {
+          unmatched++;
+          continue;
+        }
+        permutation_[e][sensor.first] = match;
+        inverse_permutation_[e][match] = sensor.first;
+      }
+    }
+
+    if (unmatched > 0) {
+      G4Exception("[LightTableSymmetry]", "BuildSensorPermutation()", JustWarning,
+                  (std::to_string(unmatched) + " sensor images do not match any "
+                   "sensor: the geometry does not have the declared symmetry.").c_str());
+    }
+  }
+
+
+
+  G4int LightTableSymmetry::MapSensor(G4int element, G4int sensor_id) const
+  {
+    auto it = permutation_.at(element).find(sensor_id);
+    return (it != permutation_[element].end()) ? it->second : -1;
+  }
+
+
+
+  G4int LightTableSymmetry::UnmapSensor(G4int element, G4int sensor_id) const
+  {
+    auto it = inverse_permutation_.at(element).find(sensor_id);
+    return (it != inverse_permutation_[element].end()) ? it->second : -1;
+  }
+
+
+
+  std::map<G4int, G4ThreeVector> LightTableSymmetry::FindSensors()
+  {
+    std::map<G4int, G4ThreeVector> sensors;
+    for (auto& sensor: SensorSD::GetSensors())
+      sensors[sensor.first] = sensor.second.second;
+    return sensors;
+  }
+
+
+} // end namespace nexus
@@ -0,0 +1,96 @@
+// ----------------------------------------------------------------------------
+// nexus | LightTableSymmetry.h
+//
+// Symmetry group of a light table: rotations by multiples of 2pi/N around
+// the z axis, optionally combined with the reflection y -> -y (that is,
+// the cyclic or dihedral group of order N or 2N). Light tables are only
+// generated in the fundamental domain of the group, and the detection
+// probability of any other point is that of its image in the domain,
+// for the sensor to which the group element maps the original one.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef LIGHT_TABLE_SYMMETRY_H
+#define LIGHT_TABLE_SYMMETRY_H
+
+#include <G4ThreeVector.hh>
+#include <globals.hh>
+
+#include <map>
+#include <vector>
+
+
+namespace nexus {
+
+  class LightTableSymmetry
+  {
+  public:
+    /// Constructor
+    LightTableSymmetry(G4int rotation_order=1, G4bool reflection=false);
+    /// Destructor
+    ~LightTableSymmetry();
+
+    /// Number of elements of the group
+    G4int GetOrder() const;
+    /// True if the group only contains the identity
+    G4bool IsTrivial() const;
+
+    G4int GetRotationOrder() const;
+    G4bool GetReflection() const;
+
+    /// Apply an element of the group to a point
+    G4ThreeVector Transform(G4int element, const G4ThreeVector& point) const;
+
+    /// Return the element of the group that maps the point
+    /// into the fundamental domain, and the image of the point
+    G4int Fold(const G4ThreeVector& point, G4ThreeVector& image) const;
+
+    /// True if the point lies in the fundamental domain,
+    /// or closer to it than the given margin
+    G4bool InFundamentalDomain(const G4ThreeVector& point, G4double margin=0.) const;
+
+    /// Compute, for every element of the group, the permutation of the
+    /// sensors it induces. Sensors are given as (ID, position) pairs.
+    void BuildSensorPermutation(const std::map<G4int, G4ThreeVector>& sensors,
+                                G4double tolerance);
+    /// True if the sensor permutation was already built
+    G4bool HasSensorPermutation() const;
+
+    /// ID of the sensor to which an element of the group maps a sensor
+    /// (-1 if there is no sensor in the transformed position)
+    G4int MapSensor(G4int element, G4int sensor_id) const;
+    /// ID of the sensor that an element of the group maps into the given one
+    G4int UnmapSensor(G4int element, G4int sensor_id) const;
+
+    /// Positions of all the sensors (SensorSD volumes) of the geometry
+    static std::map<G4int, G4ThreeVector> FindSensors();
+
+  private:
+    G4int rotation_order_; ///< Order of the rotation subgroup
+    G4bool reflection_;    ///< Whether the reflection y -> -y is included
+
+    std::vector<std::map<G4int, G4int>> permutation_;
+    std::vector<std::map<G4int, G4int>> inverse_permutation_;
+  };
+
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline G4int LightTableSymmetry::GetOrder() const
+  { return rotation_order_ * (reflection_ ? 2 : 1); }
+
+  inline G4bool LightTableSymmetry::IsTrivial() const
+  { return GetOrder() == 1; }
+
+  inline G4int LightTableSymmetry::GetRotationOrder() const
+  { return rotation_order_; }
+
+  inline G4bool LightTableSymmetry::GetReflection() const
+  { return reflection_; }
+
+  inline G4bool LightTableSymmetry::HasSensorPermutation() const
+  { return !permutation_.empty(); }
+
+} // end namespace nexus
+
+#endif
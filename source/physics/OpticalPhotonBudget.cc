@@ -0,0 +1,192 @@
+// ----------------------------------------------------------------------------
+// nexus | OpticalPhotonBudget.cc
+//
+// Process that kills the optical photons that exceed a number of boundary
+// crossings, a path length or a time since their creation. The limits can
+// be set globally or for specific logical volumes (the ones of the volume
+// the photon is in). Photons killed for each reason are counted, so that
+// the bias introduced can be checked.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "OpticalPhotonBudget.h"
+
+#include <G4OpticalPhoton.hh>
+#include <G4GenericMessenger.hh>
+#include <G4LogicalVolume.hh>
+#include <G4SystemOfUnits.hh>
+
+#include <sstream>
+
+
+namespace nexus {
+
+
+  OpticalPhotonBudget::OpticalPhotonBudget(const G4String& process_name,
+                                           G4ProcessType type):
+    G4VDiscreteProcess(process_name, type), msg_(0),
+    default_limits_{0, 0., 0.}, boundaries_(0), photons_(0.)
+  {
+    particle_change_ = new G4ParticleChange();
+    pParticleChange = particle_change_;
+
+    msg_ = new G4GenericMessenger(this, "/Physics/OpticalPhotonBudget/",
+      "Control commands of the optical photon budget.");
+
+    G4GenericMessenger::Command& boundaries_cmd =
+      msg_->DeclareProperty("max_boundaries", default_limits_.max_boundaries,
+                            "Maximum number of boundaries crossed (0 = no limit).");
+    boundaries_cmd.SetParameterName("max_boundaries", false);
+    boundaries_cmd.SetRange("max_boundaries>=0");
+
+    G4GenericMessenger::Command& length_cmd =
+      msg_->DeclareProperty("max_path_length", default_limits_.max_path_length,
+                            "Maximum path length of the photons (0 = no limit).");
+    length_cmd.SetParameterName("max_path_length", false);
+    length_cmd.SetUnitCategory("Length");
+    length_cmd.SetRange("max_path_length>=0.");
+
+    G4GenericMessenger::Command& time_cmd =
+      msg_->DeclareProperty("max_time", default_limits_.max_time,
+                            "Maximum time since the creation of the photons (0 = no limit).");
+    time_cmd.SetParameterName("max_time", false);
+    time_cmd.SetUnitCategory("Time");
+    time_cmd.SetRange("max_time>=0.");
+
+    msg_->DeclareMethod("volume_limits", &OpticalPhotonBudget::SetVolumeLimits,
+                        "Limits in a logical volume: name max_boundaries "
+                        "max_path_length(mm) max_time(ns).");
+  }
+
+
+
+  OpticalPhotonBudget::~OpticalPhotonBudget()
+  {
+    delete msg_;
+    delete particle_change_;
+  }
+
+
+
+  G4bool OpticalPhotonBudget::IsApplicable(const G4ParticleDefinition& pdef)
+  {
+    return (&pdef == G4OpticalPhoton::Definition());
+  }
+
+
+
+  G4double OpticalPhotonBudget::GetMeanFreePath(const G4Track&, G4double,
+                                                G4ForceCondition* condition)
+  {
+    *condition = StronglyForced;
+    return DBL_MAX;
+  }
+
+
+
+  void OpticalPhotonBudget::SetVolumeLimits(G4String command)
+  {
+    std::istringstream iss(command);
+
+    G4String name;
+    Limits limits{0, 0., 0.};
+    iss >> name >> limits.max_boundaries
+        >> limits.max_path_length >> limits.max_time;
+
+    if (iss.fail()) {
+      G4Exception("[OpticalPhotonBudget]", "SetVolumeLimits()", FatalException,
+                  ("Wrong volume limits: " + command).c_str());
+    }
+
+    limits.max_path_length *= mm;
+    limits.max_time        *= ns;
+
+    volume_limits_[name] = limits;
+    limits_cache_.clear();
+  }
+
+
+
+  const OpticalPhotonBudget::Limits&
+  OpticalPhotonBudget::GetLimits(const G4LogicalVolume* logic)
+  {
+    auto it = limits_cache_.find(logic);
+    if (it != limits_cache_.end()) return *(it->second);
+
+    auto vl = volume_limits_.find(logic->GetName());
+    const Limits* limits =
+      (vl != volume_limits_.end()) ? &(vl->second) : &default_limits_;
+
+    limits_cache_[logic] = limits;
+    return *limits;
+  }
+
+
+
+  G4VParticleChange*
+  OpticalPhotonBudget::PostStepDoIt(const G4Track& track, const G4Step& step)
+  {
+    particle_change_->Initialize(track);
+
+    if (track.GetCurrentStepNumber() == 1) {
+      boundaries_ = 0;
+      photons_ += 1.;
+    }
+
+    // Photons killed by other processes in this step are not counted
+    if (track.GetTrackStatus() == fStopAndKill)
+      return G4VDiscreteProcess::PostStepDoIt(track, step);
+
+    if (step.GetPostStepPoint()->GetStepStatus() == fGeomBoundary)
+      boundaries_++;
+
+    const G4LogicalVolume* logic =
+      step.GetPreStepPoint()->GetTouchable()->GetVolume()->GetLogicalVolume();
+    const Limits& limits = GetLimits(logic);
+
+    G4String reason = "";
+    if (limits.max_boundaries > 0 && boundaries_ > limits.max_boundaries)
+      reason = "boundaries";
+    else if (limits.max_path_length > 0. && track.GetTrackLength() > limits.max_path_length)
+      reason = "path_length";
+    else if (limits.max_time > 0. && track.GetLocalTime() > limits.max_time)
+      reason = "time";
+
+    if (reason != "") {
+      particle_change_->ProposeTrackStatus(fStopAndKill);
+      killed_[logic->GetName()][reason] += 1.;
+    }
+
+    return G4VDiscreteProcess::PostStepDoIt(track, step);
+  }
+
+
+
+  void OpticalPhotonBudget::ResetStatistics()
+  {
+    photons_ = 0.;
+    killed_.clear();
+  }
+
+
+
+  void OpticalPhotonBudget::PrintStatistics() const
+  {
+    G4double total = 0.;
+    for (auto& volume: killed_)
+      for (auto& reason: volume.second) total += reason.second;
+
+    G4cout << "[OpticalPhotonBudget] " << total << " of " << photons_
+           << " optical photons killed";
+    if (photons_ > 0.) G4cout << " (" << 100. * total / photons_ << " %)";
+    G4cout << G4endl;
+
+    for (auto& volume: killed_)
+      for (auto& reason: volume.second)
+        G4cout << "  " << volume.first << " (" << reason.first << "): "
+               << reason.second << G4endl;
+  }
+
+
+} // end namespace nexus
@@ -0,0 +1,82 @@
+// ----------------------------------------------------------------------------
+// nexus | OpticalPhotonBudget.h
+//
+// Process that kills the optical photons that exceed a number of boundary
+// crossings, a path length or a time since their creation. The limits can
+// be set globally or for specific logical volumes (the ones of the volume
+// the photon is in). Photons killed for each reason are counted, so that
+// the bias introduced can be checked.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef OPTICAL_PHOTON_BUDGET_H
+#define OPTICAL_PHOTON_BUDGET_H
+
+#include <G4VDiscreteProcess.hh>
+
+#include <map>
+
+class G4GenericMessenger;
+class G4LogicalVolume;
+
+
+namespace nexus {
+
+  class OpticalPhotonBudget: public G4VDiscreteProcess
+  {
+  public:
+    /// Constructor
+    OpticalPhotonBudget(const G4String& process_name="OpticalPhotonBudget",
+                        G4ProcessType type=fUserDefined);
+    /// Destructor
+    ~OpticalPhotonBudget();
+
+    /// Only optical photons apply
+    G4bool IsApplicable(const G4ParticleDefinition&);
+
+    /// Kill the photon if any of its limits is exceeded
+    G4VParticleChange* PostStepDoIt(const G4Track&, const G4Step&);
+
+    /// Set the limits of the photons in a logical volume, given as
+    /// "name max_boundaries max_path_length(mm) max_time(ns)"
+    void SetVolumeLimits(G4String);
+
+    /// Reset the kill statistics
+    void ResetStatistics();
+    /// Print the kill statistics
+    void PrintStatistics() const;
+
+  private:
+    /// Returns infinity; i. e. the process does not limit the step,
+    /// but sets the 'StronglyForced' condition for the PostStepDoIt
+    /// to be invoked at every step
+    G4double GetMeanFreePath(const G4Track&, G4double, G4ForceCondition*);
+
+    struct Limits {
+      G4int max_boundaries;     ///< 0 = no limit
+      G4double max_path_length; ///< 0 = no limit
+      G4double max_time;        ///< 0 = no limit
+    };
+
+    /// Limits that apply in a logical volume
+    const Limits& GetLimits(const G4LogicalVolume*);
+
+  private:
+    G4ParticleChange* particle_change_;
+    G4GenericMessenger* msg_;
+
+    Limits default_limits_; ///< Limits outside the configured volumes
+    std::map<G4String, Limits> volume_limits_;
+    std::map<const G4LogicalVolume*, const Limits*> limits_cache_;
+
+    G4int boundaries_; ///< Boundaries crossed by the current photon
+
+    G4double photons_; ///< Photons tracked
+    /// Photons killed per volume and reason (boundaries, length, time)
+    std::map<G4String, std::map<G4String, G4double>> killed_;
+  };
+
+} // end namespace nexus
+
+#endif
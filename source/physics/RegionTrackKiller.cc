@@ -0,0 +1,206 @@
+// ----------------------------------------------------------------------------
+// nexus | RegionTrackKiller.cc
+//
+// Process that kills electrons, positrons and gammas in the outer regions
+// of the detector (shielding, vessel, ICS), either when their kinetic
+// energy falls below a per-region threshold or, for charged particles,
+// when their range is shorter than the distance to the nearest boundary,
+// so that they cannot leave the volume they are in. The limits are those
+// of the region at the end of the step. The kinetic energy of the killed
+// electrons and positrons is deposited locally (gammas are dropped), and
+// positrons are stopped rather than killed so that they still annihilate.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "RegionTrackKiller.h"
+
+#include <G4Electron.hh>
+#include <G4Positron.hh>
+#include <G4Gamma.hh>
+#include <G4GenericMessenger.hh>
+#include <G4LossTableManager.hh>
+#include <G4LogicalVolume.hh>
+#include <G4VPhysicalVolume.hh>
+#include <G4Region.hh>
+#include <G4UnitsTable.hh>
+#include <G4SystemOfUnits.hh>
+
+#include <sstream>
+
+
+namespace nexus {
+
+
+  RegionTrackKiller::RegionTrackKiller(const G4String& process_name,
+                                       G4ProcessType type):
+    G4VDiscreteProcess(process_name, type), msg_(0)
+  {
+    particle_change_ = new G4ParticleChange();
+    pParticleChange = particle_change_;
+
+    msg_ = new G4GenericMessenger(this, "/Physics/RegionTrackKiller/",
+      "Control commands of the region track killer.");
+
+    msg_->DeclareMethod("min_energy", &RegionTrackKiller::SetMinEnergy,
+                        "Minimum kinetic energy of electrons, positrons and "
+                        "gammas in a region: region energy(keV).");
+
+    msg_->DeclareMethod("kill_trapped", &RegionTrackKiller::SetKillTrapped,
+                        "Kill the electrons and positrons that cannot leave "
+                        "their volume in a region.");
+  }
+
+
+
+  RegionTrackKiller::~RegionTrackKiller()
+  {
+    delete msg_;
+    delete particle_change_;
+  }
+
+
+
+  G4bool RegionTrackKiller::IsApplicable(const G4ParticleDefinition& pdef)
+  {
+    return (&pdef == G4Electron::Definition() ||
+            &pdef == G4Positron::Definition() ||
+            &pdef == G4Gamma::Definition());
+  }
+
+
+
+  G4double RegionTrackKiller::GetMeanFreePath(const G4Track&, G4double,
+                                              G4ForceCondition* condition)
+  {
+    *condition = StronglyForced;
+    return DBL_MAX;
+  }
+
+
+
+  void RegionTrackKiller::SetMinEnergy(G4String command)
+  {
+    std::istringstream iss(command);
+
+    G4String name;
+    G4double energy;
+    iss >> name >> energy;
+
+    if (iss.fail() || energy < 0.) {
+      G4Exception("[RegionTrackKiller]", "SetMinEnergy()", FatalException,
+                  ("Wrong region minimum energy: " + command).c_str());
+    }
+
+    // Keep the other limit of the region, if any
+    auto it = region_limits_.emplace(name, Limits{0., false}).first;
+    it->second.min_energy = energy * keV;
+    limits_cache_.clear();
+  }
+
+
+
+  void RegionTrackKiller::SetKillTrapped(G4String name)
+  {
+    auto it = region_limits_.emplace(name, Limits{0., false}).first;
+    it->second.kill_trapped = true;
+    limits_cache_.clear();
+  }
+
+
+
+  const RegionTrackKiller::Limits*
+  RegionTrackKiller::GetLimits(const G4Region* region)
+  {
+    auto it = limits_cache_.find(region);
+    if (it != limits_cache_.end()) return it->second;
+
+    auto rl = region_limits_.find(region->GetName());
+    const Limits* limits =
+      (rl != region_limits_.end()) ? &(rl->second) : nullptr;
+
+    limits_cache_[region] = limits;
+    return limits;
+  }
+
+
+
+  G4VParticleChange*
+  RegionTrackKiller::PostStepDoIt(const G4Track& track, const G4Step& step)
+  {
+    particle_change_->Initialize(track);
+
+    // Tracks killed or stopped by other processes in this step are not counted
+    if (track.GetTrackStatus() != fAlive)
+      return G4VDiscreteProcess::PostStepDoIt(track, step);
+
+    // The track is killed at the post-step point, so the limits are those
+    // of the region it is in there (e.g. of an inner region just entered)
+    const G4VPhysicalVolume* volume = step.GetPostStepPoint()->GetPhysicalVolume();
+    if (!volume) return G4VDiscreteProcess::PostStepDoIt(track, step);
+
+    const G4Region* region = volume->GetLogicalVolume()->GetRegion();
+    const Limits* limits = GetLimits(region);
+    if (!limits) return G4VDiscreteProcess::PostStepDoIt(track, step);
+
+    G4double ekin = track.GetKineticEnergy();
+    const G4ParticleDefinition* pdef = track.GetDefinition();
+
+    G4String reason = "";
+    if (limits->min_energy > 0. && ekin < limits->min_energy) {
+      reason = "min_energy";
+    }
+    else if (limits->kill_trapped && pdef != G4Gamma::Definition()) {
+      // The safety is the distance to the nearest boundary,
+      // whatever the direction of the particle
+      G4double range = G4LossTableManager::Instance()->
+        GetRange(pdef, ekin, track.GetMaterialCutsCouple());
+      if (range < step.GetPostStepPoint()->GetSafety()) reason = "trapped";
+    }
+
+    if (reason != "") {
+      // Charged particles would have deposited their energy nearby,
+      // while gammas could have carried it anywhere
+      if (pdef->GetPDGCharge() != 0.)
+        particle_change_->ProposeLocalEnergyDeposit(ekin);
+      particle_change_->ProposeEnergy(0.);
+      if (pdef == G4Positron::Definition())
+        particle_change_->ProposeTrackStatus(fStopButAlive);
+      else
+        particle_change_->ProposeTrackStatus(fStopAndKill);
+
+      killed_[region->GetName()][reason] += 1.;
+      energy_[region->GetName()][reason] += ekin;
+    }
+
+    return G4VDiscreteProcess::PostStepDoIt(track, step);
+  }
+
+
+
+  void RegionTrackKiller::ResetStatistics()
+  {
+    killed_.clear();
+    energy_.clear();
+  }
+
+
+
+  void RegionTrackKiller::PrintStatistics() const
+  {
+    G4double total = 0.;
+    for (auto& region: killed_)
+      for (auto& reason: region.second) total += reason.second;
+
+    G4cout << "[RegionTrackKiller] " << total << " tracks killed" << G4endl;
+
+    for (auto& region: killed_)
+      for (auto& reason: region.second)
+        G4cout << "  " << region.first << " (" << reason.first << "): "
+               << reason.second << " tracks, "
+               << G4BestUnit(energy_.at(region.first).at(reason.first), "Energy")
+               << G4endl;
+  }
+
+
+} // end namespace nexus
@@ -0,0 +1,84 @@
+// ----------------------------------------------------------------------------
+// nexus | RegionTrackKiller.h
+//
+// Process that kills electrons, positrons and gammas in the outer regions
+// of the detector (shielding, vessel, ICS), either when their kinetic
+// energy falls below a per-region threshold or, for charged particles,
+// when their range is shorter than the distance to the nearest boundary,
+// so that they cannot leave the volume they are in. The limits are those
+// of the region at the end of the step. The kinetic energy of the killed
+// electrons and positrons is deposited locally (gammas are dropped), and
+// positrons are stopped rather than killed so that they still annihilate.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef REGION_TRACK_KILLER_H
+#define REGION_TRACK_KILLER_H
+
+#include <G4VDiscreteProcess.hh>
+
+#include <map>
+
+class G4GenericMessenger;
+class G4Region;
+
+
+namespace nexus {
+
+  class RegionTrackKiller: public G4VDiscreteProcess
+  {
+  public:
+    /// Constructor
+    RegionTrackKiller(const G4String& process_name="RegionTrackKiller",
+                      G4ProcessType type=fUserDefined);
+    /// Destructor
+    ~RegionTrackKiller();
+
+    /// Only electrons, positrons and gammas apply
+    G4bool IsApplicable(const G4ParticleDefinition&);
+
+    /// Kill the track if it is below the limits of its region
+    G4VParticleChange* PostStepDoIt(const G4Track&, const G4Step&);
+
+    /// Set the minimum kinetic energy in a region, given as
+    /// "region energy(keV)"
+    void SetMinEnergy(G4String);
+    /// Kill the charged particles that cannot leave their
+    /// volume in the given region
+    void SetKillTrapped(G4String);
+
+    /// Reset the kill statistics
+    void ResetStatistics();
+    /// Print the kill statistics
+    void PrintStatistics() const;
+
+  private:
+    /// Returns infinity; i. e. the process does not limit the step,
+    /// but sets the 'StronglyForced' condition for the PostStepDoIt
+    /// to be invoked at every step
+    G4double GetMeanFreePath(const G4Track&, G4double, G4ForceCondition*);
+
+    struct Limits {
+      G4double min_energy; ///< 0 = no limit
+      G4bool kill_trapped;
+    };
+
+    /// Limits that apply in a region (null if none)
+    const Limits* GetLimits(const G4Region*);
+
+  private:
+    G4ParticleChange* particle_change_;
+    G4GenericMessenger* msg_;
+
+    std::map<G4String, Limits> region_limits_;
+    std::map<const G4Region*, const Limits*> limits_cache_;
+
+    /// Tracks killed and energy deposited per region and reason
+    std::map<G4String, std::map<G4String, G4double>> killed_;
+    std::map<G4String, std::map<G4String, G4double>> energy_;
+  };
+
+} // end namespace nexus
+
+#endif
@@ -0,0 +1,128 @@
+// ----------------------------------------------------------------------------
+// nexus | S1LightMapSimulation.cc
+//
+// Fast simulation of the primary scintillation light. Scintillation photons
+// produced in the active region are not tracked: the sensor detecting each
+// of them (if any) is sampled from a voxelized light map, like the ones
+// written by LightTablePersistencyManager, and the sensor hit is filled
+// directly. Arrival times follow the time bins of the map or, for
+// single-bin maps, an exponential transit time profile.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "S1LightMapSimulation.h"
+
+#include "ELLookupTable.h"
+#include "SensorSD.h"
+
+#include <G4OpticalPhoton.hh>
+#include <G4VProcess.hh>
+#include <Randomize.hh>
+
+#include <algorithm>
+
+
+namespace nexus {
+
+
+  S1LightMapSimulation::S1LightMapSimulation(G4Region* region,
+                                             const G4String& light_map,
+                                             G4double transit_time,
+                                             G4double prescale):
+    G4VFastSimulationModel("S1LightMapSimulation", region),
+    light_map_(0), transit_time_(transit_time), weight_(1. / prescale),
+    last_cell_(-1)
+  {
+    light_map_ = new ELLookupTable(light_map);
+  }
+
+
+
+  S1LightMapSimulation::~S1LightMapSimulation()
+  {
+    delete light_map_;
+  }
+
+
+
+  G4bool S1LightMapSimulation::IsApplicable(const G4ParticleDefinition& pdef)
+  {
+    return (&pdef == G4OpticalPhoton::Definition());
+  }
+
+
+
+  G4bool S1LightMapSimulation::ModelTrigger(const G4FastTrack& ftrack)
+  {
+    const G4Track* track = ftrack.GetPrimaryTrack();
+
+    // Photons entering the region from outside are tracked as usual
+    if (track->GetCurrentStepNumber() != 1) return false;
+
+    const G4VProcess* creator = track->GetCreatorProcess();
+    return (creator && creator->GetProcessName() == "Scintillation");
+  }
+
+
+
+  void S1LightMapSimulation::BuildDistribution(const G4ThreeVector& position, G4long cell)
+  {
+    cdf_.clear();
+    outcomes_.clear();
+
+    G4double sum = 0.;
+    for (auto& sensor: light_map_->GetSensorsMap(position)) {
+      for (size_t bin=0; bin<sensor.second.size(); ++bin) {
+        if (sensor.second[bin] <= 0.) continue;
+        sum += sensor.second[bin];
+        cdf_.push_back(sum);
+        outcomes_.push_back(std::make_pair(sensor.first, (G4int) bin));
+      }
+    }
+
+    last_cell_ = cell;
+  }
+
+
+
+  void S1LightMapSimulation::DoIt(const G4FastTrack& ftrack, G4FastStep& fstep)
+  {
+    fstep.KillPrimaryTrack();
+    fstep.ProposePrimaryTrackPathLength(0.);
+
+    const G4Track* track = ftrack.GetPrimaryTrack();
+
+    // Photons are emitted along the step, each from its own position,
+    // but most of them share the table entry of the previous one
+    G4long cell = light_map_->GetCellID(track->GetPosition());
+    if (cell != last_cell_) BuildDistribution(track->GetPosition(), cell);
+
+    // The photon is detected with the total probability of the map,
+    // and then by each sensor and time bin with its own probability
+    G4double rnd = G4UniformRand();
+    if (cdf_.empty() || rnd >= cdf_.back()) return;
+
+    size_t i = std::upper_bound(cdf_.begin(), cdf_.end(), rnd) - cdf_.begin();
+    G4int sensor_id = outcomes_[i].first;
+    G4int time_bin  = outcomes_[i].second;
+
+    const auto& sensors = SensorSD::GetSensors();
+    auto sensor = sensors.find(sensor_id);
+    if (sensor == sensors.end()) return;
+
+    G4double time = track->GetGlobalTime();
+    if (light_map_->GetNumberOfTimeBins() > 1 && light_map_->GetTimeBinSize() > 0.)
+      time += (time_bin + G4UniformRand()) * light_map_->GetTimeBinSize();
+    else if (transit_time_ > 0.)
+      time += G4RandExponential::shoot(transit_time_);
+
+    // With the optical prescale, each photon stands for 1/prescale of them
+    G4int counts = G4int(weight_);
+    if (G4UniformRand() < weight_ - counts) ++counts;
+
+    sensor->second.first->FillHit(sensor_id, sensor->second.second, time, counts);
+  }
+
+
+} // end namespace nexus
@@ -0,0 +1,66 @@
+// ----------------------------------------------------------------------------
+// nexus | S1LightMapSimulation.h
+//
+// Fast simulation of the primary scintillation light. Scintillation photons
+// produced in the active region are not tracked: the sensor detecting each
+// of them (if any) is sampled from a voxelized light map, like the ones
+// written by LightTablePersistencyManager, and the sensor hit is filled
+// directly. Arrival times follow the time bins of the map or, for
+// single-bin maps, an exponential transit time profile.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef S1_LIGHT_MAP_SIMULATION_H
+#define S1_LIGHT_MAP_SIMULATION_H
+
+#include <G4VFastSimulationModel.hh>
+#include <G4ThreeVector.hh>
+
+#include <utility>
+#include <vector>
+
+
+namespace nexus {
+
+  class ELLookupTable;
+
+  class S1LightMapSimulation: public G4VFastSimulationModel
+  {
+  public:
+    /// Constructor. Each detected photon fills the hits with
+    /// 1/prescale counts on average.
+    S1LightMapSimulation(G4Region* region, const G4String& light_map,
+                         G4double transit_time, G4double prescale=1.);
+    /// Destructor
+    ~S1LightMapSimulation();
+
+    /// This model is only valid for optical photons
+    G4bool IsApplicable(const G4ParticleDefinition&);
+
+    /// The model is triggered by scintillation photons
+    /// in the first step after their creation
+    G4bool ModelTrigger(const G4FastTrack&);
+
+    /// Sample the detection of the photon and kill it
+    void DoIt(const G4FastTrack&, G4FastStep&);
+
+  private:
+    /// Compute the cumulative detection probabilities of a position,
+    /// which belongs to the given cell of the light map
+    void BuildDistribution(const G4ThreeVector&, G4long cell);
+
+  private:
+    ELLookupTable* light_map_; ///< Detection probabilities per voxel
+    G4double transit_time_;    ///< Mean transit time for single-bin maps
+    G4double weight_;          ///< Mean counts of each detected photon
+
+    /// Detection distribution of the last cell of the map looked up
+    G4long last_cell_; ///< -1 before the first lookup
+    std::vector<G4double> cdf_;
+    std::vector<std::pair<G4int, G4int>> outcomes_; ///< (sensor, time bin)
+  };
+
+} // end namespace nexus
+
+#endif
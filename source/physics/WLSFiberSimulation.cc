@@ -0,0 +1,222 @@
+// ----------------------------------------------------------------------------
+// nexus | WLSFiberSimulation.cc
+//
+// Fast simulation of the light transport along wavelength-shifting fibers.
+// Photons re-emitted in the fiber core are not tracked through the total
+// internal reflections along the fiber: those emitted within the trapping
+// cone (given by the refractive indices of core and cladding) are moved to
+// the fiber end they point to, with their attenuation along the fiber (from
+// the absorption lengths of the core) and their arrival time, and fill the
+// hit of the sensor closest to the emission point at that end. Photons
+// outside the cone are tracked as usual. The sensors facing each end
+// are found once and sorted by azimuth, so that the closest one is found
+// with a binary search.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "WLSFiberSimulation.h"
+
+#include "SensorSD.h"
+
+#include <G4OpticalPhoton.hh>
+#include <G4VProcess.hh>
+#include <G4Tubs.hh>
+#include <G4Material.hh>
+#include <G4MaterialPropertiesTable.hh>
+#include <G4VTouchable.hh>
+#include <G4PhysicalConstants.hh>
+#include <G4SystemOfUnits.hh>
+#include <Randomize.hh>
+
+#include <algorithm>
+
+
+namespace {
+
+  G4double PropertyValue(const G4Material* mat, const G4String& name,
+                         G4double energy, G4double default_value)
+  {
+    G4MaterialPropertiesTable* mpt = mat->GetMaterialPropertiesTable();
+    if (!mpt) return default_value;
+    G4MaterialPropertyVector* property = mpt->GetProperty(name);
+    if (!property) return default_value;
+    return property->Value(energy);
+  }
+
+}
+
+
+namespace nexus {
+
+
+  WLSFiberSimulation::WLSFiberSimulation(G4Region* region,
+                                         G4double trapping_efficiency,
+                                         G4double prescale):
+    G4VFastSimulationModel("WLSFiberSimulation", region),
+    trapping_efficiency_(trapping_efficiency), weight_(1. / prescale),
+    end_sensors_built_(false)
+  {
+  }
+
+
+
+  WLSFiberSimulation::~WLSFiberSimulation()
+  {
+  }
+
+
+
+  G4bool WLSFiberSimulation::IsApplicable(const G4ParticleDefinition& pdef)
+  {
+    return (&pdef == G4OpticalPhoton::Definition());
+  }
+
+
+
+  G4bool WLSFiberSimulation::ModelTrigger(const G4FastTrack& ftrack)
+  {
+    const G4Track* track = ftrack.GetPrimaryTrack();
+
+    // Photons entering the core from outside are tracked as usual,
+    // until they are absorbed and shifted in it
+    if (track->GetCurrentStepNumber() != 1) return false;
+
+    // Only photons shifted in the core itself, not in the volumes
+    // placed inside it (e.g. the TPB coating of bare fibers)
+    if (track->GetVolume() != ftrack.GetEnvelopePhysicalVolume()) return false;
+
+    const G4VProcess* creator = track->GetCreatorProcess();
+    if (!creator) return false;
+
+    return (creator->GetProcessName() == "WavelengthShifting" ||
+            creator->GetProcessName() == "OpWLS");
+  }
+
+
+
+  void WLSFiberSimulation::DoIt(const G4FastTrack& ftrack, G4FastStep& fstep)
+  {
+    const G4Track* track = ftrack.GetPrimaryTrack();
+    G4double energy = track->GetKineticEnergy();
+
+    // Photons that are not trapped return with the step untouched
+    // and are tracked as usual out of the fiber.
+
+    // Refractive indices of the core and of the medium surrounding it
+    const G4VTouchable* touchable = track->GetTouchable();
+    const G4Material* core = track->GetMaterial();
+    const G4Material* clad = (touchable->GetHistoryDepth() > 0) ?
+      touchable->GetVolume(1)->GetLogicalVolume()->GetMaterial() : core;
+
+    G4double n_core = PropertyValue(core, "RINDEX", energy, 1.);
+    G4double n_clad = PropertyValue(clad, "RINDEX", energy, 1.);
+    if (n_clad >= n_core) return;
+
+    // Photons are trapped if their angle with the fiber axis is below
+    // the critical one (cos > n_clad/n_core). A fixed trapping efficiency
+    // is applied as the cone holding that fraction of isotropic photons.
+    const G4Tubs* solid = dynamic_cast<const G4Tubs*>(ftrack.GetEnvelopeSolid());
+    if (!solid) return;
+
+    G4double cos_trap = (trapping_efficiency_ > 0.) ?
+      1. - trapping_efficiency_ : n_clad / n_core;
+    G4double cos_theta = ftrack.GetPrimaryTrackLocalDirection().z();
+    if (std::abs(cos_theta) <= cos_trap) return;
+
+    // The photon is transported along the fiber from here on
+    fstep.KillPrimaryTrack();
+    fstep.ProposePrimaryTrackPathLength(0.);
+
+    G4ThreeVector local = ftrack.GetPrimaryTrackLocalPosition();
+    G4double end_z = (cos_theta < 0.) ?
+      -solid->GetZHalfLength() : solid->GetZHalfLength();
+    G4double path = std::abs((end_z - local.z()) / cos_theta);
+
+    // Attenuation by bulk absorption and by re-absorption in the core
+    G4double inv_length = 0.;
+    G4double abs_length = PropertyValue(core, "ABSLENGTH",    energy, 0.);
+    G4double wls_length = PropertyValue(core, "WLSABSLENGTH", energy, 0.);
+    if (abs_length > 0.) inv_length += 1. / abs_length;
+    if (wls_length > 0.) inv_length += 1. / wls_length;
+    if (G4UniformRand() >= std::exp(-path * inv_length)) return;
+
+    G4double time = track->GetGlobalTime() + path * n_core / c_light;
+
+    // Sensor closest to the point of the fiber end facing the emission point
+    if (!end_sensors_built_) BuildEndSensors(ftrack);
+
+    G4int sensor_id = FindEndSensor(end_z > 0. ? 1 : 0,
+                                    G4ThreeVector(local.x(), local.y(), end_z));
+    if (sensor_id < 0) return;
+
+    // With the optical prescale, each photon stands for 1/prescale of them
+    G4int counts = G4int(weight_);
+    if (G4UniformRand() < weight_ - counts) ++counts;
+
+    auto& sensor = sensors_[sensor_id];
+    sensor.first->FillHit(sensor_id, sensor.second, time, counts);
+  }
+
+
+
+
+  void WLSFiberSimulation::BuildEndSensors(const G4FastTrack& ftrack)
+  {
+    // The sensors are looked for only once, even if none is found
+    end_sensors_built_ = true;
+    sensors_ = SensorSD::GetSensors();
+
+    // The region has a single envelope (the fiber barrel of NEXT-Flex)
+    const G4Tubs* solid = dynamic_cast<const G4Tubs*>(ftrack.GetEnvelopeSolid());
+    if (!solid) return;
+
+    G4double rmin  = solid->GetInnerRadius();
+    G4double rmax  = solid->GetOuterRadius();
+    G4double halfz = solid->GetZHalfLength();
+
+    // Sensors facing an end lie beyond it, within a short distance
+    // of the fiber ring (the tracking-plane sensors are far from it)
+    const G4double tolerance = std::max(rmax - rmin, 1.*cm);
+
+    for (auto& sensor: sensors_) {
+      G4ThreeVector local = ftrack.GetAffineTransformation()->
+        TransformPoint(sensor.second.second);
+      local_positions_[sensor.first] = local;
+
+      G4double r = local.perp();
+      if (r < rmin - tolerance || r > rmax + tolerance) continue;
+
+      if (std::abs(local.z() + halfz) < tolerance)
+        end_sensors_[0].push_back(std::make_pair(local.phi(), sensor.first));
+      else if (std::abs(local.z() - halfz) < tolerance)
+        end_sensors_[1].push_back(std::make_pair(local.phi(), sensor.first));
+    }
+
+    for (auto& end: end_sensors_) std::sort(end.begin(), end.end());
+  }
+
+
+
+  G4int WLSFiberSimulation::FindEndSensor(G4int end, const G4ThreeVector& local) const
+  {
+    const std::vector<std::pair<G4double, G4int>>& candidates = end_sensors_[end];
+    if (candidates.empty()) return -1;
+
+    // The closest sensor is one of the two neighbours in azimuth
+    // (wrapping around at +-pi)
+    auto next = std::lower_bound(candidates.begin(), candidates.end(),
+                                 std::make_pair(local.phi(), -1));
+    auto prev = (next == candidates.begin()) ? candidates.end() - 1 : next - 1;
+    if (next == candidates.end()) next = candidates.begin();
+
+    G4int next_id = next->second;
+    G4int prev_id = prev->second;
+    G4double next_dist2 = (local_positions_.at(next_id) - local).mag2();
+    G4double prev_dist2 = (local_positions_.at(prev_id) - local).mag2();
+
+    return (next_dist2 <= prev_dist2) ? next_id : prev_id;
+  }
+
+
+} // end namespace nexus
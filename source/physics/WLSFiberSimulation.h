@@ -0,0 +1,78 @@
+// ----------------------------------------------------------------------------
+// nexus | WLSFiberSimulation.h
+//
+// Fast simulation of the light transport along wavelength-shifting fibers.
+// Photons re-emitted in the fiber core are not tracked through the total
+// internal reflections along the fiber: those emitted within the trapping
+// cone (given by the refractive indices of core and cladding) are moved to
+// the fiber end they point to, with their attenuation along the fiber (from
+// the absorption lengths of the core) and their arrival time, and fill the
+// hit of the sensor closest to the emission point at that end. Photons
+// outside the cone are tracked as usual. The sensors facing each end
+// are found once and sorted by azimuth, so that the closest one is found
+// with a binary search.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef WLS_FIBER_SIMULATION_H
+#define WLS_FIBER_SIMULATION_H
+
+#include <G4VFastSimulationModel.hh>
+#include <G4ThreeVector.hh>
+
+#include <map>
+#include <vector>
+
+
+namespace nexus {
+
+  class SensorSD;
+
+  class WLSFiberSimulation: public G4VFastSimulationModel
+  {
+  public:
+    /// Constructor. A trapping efficiency of 0 means that it is
+    /// computed from the refractive indices of core and cladding.
+    /// Each detected photon fills the hits with 1/prescale counts
+    /// on average.
+    WLSFiberSimulation(G4Region* region, G4double trapping_efficiency=0.,
+                       G4double prescale=1.);
+    /// Destructor
+    ~WLSFiberSimulation();
+
+    /// This model is only valid for optical photons
+    G4bool IsApplicable(const G4ParticleDefinition&);
+
+    /// The model is triggered by photons wavelength-shifted in the
+    /// fiber core (not in its daughters), in their first step
+    G4bool ModelTrigger(const G4FastTrack&);
+
+    /// Transport the photon to the fiber ends and kill it,
+    /// if it is trapped in the fiber
+    void DoIt(const G4FastTrack&, G4FastStep&);
+
+  private:
+    /// Find the sensors facing each end of the fiber envelope
+    void BuildEndSensors(const G4FastTrack&);
+    /// Sensor closest to a point (in envelope coordinates) of a fiber end
+    G4int FindEndSensor(G4int end, const G4ThreeVector& local) const;
+
+  private:
+    G4double trapping_efficiency_; ///< Fixed trapping efficiency (if > 0)
+    G4double weight_;              ///< Mean counts of each detected photon
+
+    /// Sensitive detector and position of every sensor
+    std::map<G4int, std::pair<SensorSD*, G4ThreeVector>> sensors_;
+
+    /// Sensors facing the lower and upper end of the envelope,
+    /// as (azimuth, sensor ID) sorted by azimuth
+    std::vector<std::pair<G4double, G4int>> end_sensors_[2];
+    /// Positions of the sensors in envelope coordinates
+    std::map<G4int, G4ThreeVector> local_positions_;
+    G4bool end_sensors_built_; ///< True once the sensors have been looked for
+  };
+
+} // end namespace nexus
+
+#endif
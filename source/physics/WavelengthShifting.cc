@@ -10,6 +10,7 @@
 // ----------------------------------------------------------------------------
 
 #include "WavelengthShifting.h"
+#include "IOUtils.h"
 
 #include <G4OpticalPhoton.hh>
 #include <Randomize.hh>
@@ -29,8 +30,6 @@ namespace nexus {
 
     WLSTimeGeneratorProfile_ =
       new G4WLSTimeGeneratorProfileExponential("WLSTimeGeneratorProfileExponential");
-
-    BuildThePhysicsTable();
   }
 
   WavelengthShifting::~WavelengthShifting()
@@ -146,6 +145,34 @@ namespace nexus {
 
   }
 
+  void WavelengthShifting::BuildPhysicsTable(const G4ParticleDefinition&)
+  {
+    BuildThePhysicsTable();
+  }
+
+  G4bool WavelengthShifting::StorePhysicsTable(const G4ParticleDefinition* particle,
+                                               const G4String& directory, G4bool)
+  {
+    if (!wlsIntegralTable_) return true;
+
+    G4String filename =
+      GetPhysicsTableFileName(particle, directory, "WLSIntegral", true);
+    return StorePhysicsVectors(wlsIntegralTable_, filename);
+  }
+
+  G4bool WavelengthShifting::RetrievePhysicsTable(const G4ParticleDefinition* particle,
+                                                  const G4String& directory, G4bool)
+  {
+    if (wlsIntegralTable_) return true;
+
+    G4String filename =
+      GetPhysicsTableFileName(particle, directory, "WLSIntegral", true);
+    wlsIntegralTable_ =
+      RetrievePhysicsVectors(filename, G4Material::GetNumberOfMaterials());
+
+    return (wlsIntegralTable_ != nullptr);
+  }
+
   void WavelengthShifting::BuildThePhysicsTable()
   {
     if (wlsIntegralTable_) return;
@@ -32,6 +32,10 @@ namespace nexus {
     G4VParticleChange* PostStepDoIt(const G4Track& aTrack, const G4Step& aStep);
     G4double GetMeanFreePath(const G4Track& track, G4double, G4ForceCondition*);
 
+    void BuildPhysicsTable(const G4ParticleDefinition&);
+    G4bool StorePhysicsTable(const G4ParticleDefinition*, const G4String&, G4bool);
+    G4bool RetrievePhysicsTable(const G4ParticleDefinition*, const G4String&, G4bool);
+
   private:
     void BuildThePhysicsTable();
     void ComputeCumulativeDistribution(const G4MaterialPropertyVector& pdf, G4PhysicsOrderedFreeVector& cdf);
@@ -14,14 +14,30 @@
 #include "Electroluminescence.h"
 #include "WavelengthShifting.h"
 #include "OpPhotoelectricEffect.h"
+#include "OpticalPhotonBudget.h"
+#include "RegionTrackKiller.h"
+#include "ImportanceBiasing.h"
+#include "S1LightMapSimulation.h"
+#include "WLSFiberSimulation.h"
 
 #include <G4GenericMessenger.hh>
 #include <G4OpticalPhoton.hh>
+#include <G4Gamma.hh>
 #include <G4ProcessManager.hh>
 #include <G4ProcessTable.hh>
 #include <G4StepLimiter.hh>
 #include <G4FastSimulationManagerProcess.hh>
 #include <G4PhysicsConstructorFactory.hh>
+#include <G4Region.hh>
+#include <G4RegionStore.hh>
+#include <G4LogicalVolumeStore.hh>
+#include <G4SystemOfUnits.hh>
+#include <G4Material.hh>
+#include <G4MaterialPropertiesTable.hh>
+#include <G4OpticalSurface.hh>
+
+#include <fstream>
+#include <set>
 
 
 namespace nexus {
@@ -31,10 +47,16 @@ namespace nexus {
   G4_DECLARE_PHYSCONSTR_FACTORY(NexusPhysics);
 
 
+  G4double NexusPhysics::applied_prescale_ = 1.;
+
+
 
   NexusPhysics::NexusPhysics():
     G4VPhysicsConstructor("NexusPhysics"),
-    clustering_(true), drift_(true), electroluminescence_(true), photoelectric_(false)
+    clustering_(true), drift_(true), electroluminescence_(true), photoelectric_(false),
+    photon_budget_(false), region_killer_(false),
+    importance_biasing_(false), s1_light_map_(""), s1_transit_time_(0.),
+    fiber_fast_sim_(false), fiber_trapping_eff_(0.), optical_prescale_(1.)
   {
     msg_ = new G4GenericMessenger(this, "/PhysicsList/Nexus/",
       "Control commands of the nexus physics list.");
@@ -51,6 +73,41 @@ namespace nexus {
     msg_->DeclareProperty("photoelectric", photoelectric_,
       "Switch on/off the photoelectric effect.");
 
+    msg_->DeclareProperty("photon_budget", photon_budget_,
+      "Switch on/off the limits on the lifetime of optical photons.");
+
+    msg_->DeclareProperty("region_killer", region_killer_,
+      "Switch on/off the killing of low-energy tracks in outer regions.");
+
+    msg_->DeclareProperty("importance_biasing", importance_biasing_,
+      "Switch on/off the geometric importance biasing of gammas.");
+
+    msg_->DeclareProperty("s1_light_map", s1_light_map_,
+      "Light map used to simulate the S1 light without tracking it (empty = off).");
+
+    G4GenericMessenger::Command& transit_cmd =
+      msg_->DeclareProperty("s1_transit_time", s1_transit_time_,
+        "Mean transit time of the S1 photons for light maps without time bins.");
+    transit_cmd.SetUnitCategory("Time");
+    transit_cmd.SetParameterName("s1_transit_time", false);
+    transit_cmd.SetRange("s1_transit_time>=0.");
+
+    msg_->DeclareProperty("fiber_fast_sim", fiber_fast_sim_,
+      "Switch on/off the fast simulation of the light transport along WLS fibers.");
+
+    G4GenericMessenger::Command& trapping_cmd =
+      msg_->DeclareProperty("fiber_trapping_efficiency", fiber_trapping_eff_,
+        "Trapping efficiency of the WLS fibers (0 = computed from refractive indices).");
+    trapping_cmd.SetParameterName("fiber_trapping_efficiency", false);
+    trapping_cmd.SetRange("fiber_trapping_efficiency>=0. && fiber_trapping_efficiency<=1.");
+
+    G4GenericMessenger::Command& prescale_cmd =
+      msg_->DeclareProperty("optical_prescale", optical_prescale_,
+        "Fraction of the scintillation, EL and primary optical photons generated. "
+        "The detection efficiency of the sensors is divided by it.");
+    prescale_cmd.SetParameterName("optical_prescale", false);
+    prescale_cmd.SetRange("optical_prescale>0. && optical_prescale<=1.");
+
   }
 
 
@@ -106,6 +163,7 @@ namespace nexus {
 
     if (electroluminescence_) {
       Electroluminescence* el = new Electroluminescence();
+      el->SetYieldFactor(optical_prescale_);
       pmanager->AddDiscreteProcess(el);
     }
 
@@ -145,6 +203,142 @@ namespace nexus {
         }
       }
     }
+
+    // Add the lifetime limits of the optical photons
+
+    if (photon_budget_) {
+      pmanager = G4OpticalPhoton::Definition()->GetProcessManager();
+      pmanager->AddDiscreteProcess(new OpticalPhotonBudget());
+    }
+
+    // Add the killing of electrons, positrons and gammas in the outer
+    // regions (the limits are set through its own messenger)
+
+    if (region_killer_) {
+      RegionTrackKiller* killer = new RegionTrackKiller();
+
+      auto aParticleIterator = GetParticleIterator();
+      aParticleIterator->reset();
+      while ((*aParticleIterator)()) {
+        G4ParticleDefinition* particle = aParticleIterator->value();
+
+        if (killer->IsApplicable(*particle)) {
+          pmanager = particle->GetProcessManager();
+          pmanager->AddDiscreteProcess(killer);
+        }
+      }
+    }
+
+    // Add the splitting and Russian roulette of gammas
+    // (the importances are set through its own messenger)
+
+    if (importance_biasing_) {
+      pmanager = G4Gamma::Definition()->GetProcessManager();
+      pmanager->AddDiscreteProcess(new ImportanceBiasing());
+    }
+
+    if (optical_prescale_ < 1.) ApplyOpticalPrescale();
+
+    // Add the fast simulation of the S1 light in the active region
+
+    if (s1_light_map_ != "") {
+      G4Region* region = G4RegionStore::GetInstance()->GetRegion("DRIFT", false);
+      if (!region) {
+        G4Exception("[NexusPhysics]", "ConstructProcess()", FatalException,
+          "The S1 fast simulation requires a geometry with a DRIFT region.");
+      }
+      if (!std::ifstream(s1_light_map_).good()) {
+        G4Exception("[NexusPhysics]", "ConstructProcess()", FatalException,
+          ("Cannot open S1 light map " + s1_light_map_).c_str());
+      }
+
+      new S1LightMapSimulation(region, s1_light_map_, s1_transit_time_,
+                               optical_prescale_);
+    }
+
+    // Add the fast simulation of the light transport along WLS fibers
+
+    if (fiber_fast_sim_) {
+      // The region is created here, so that geometries
+      // without the fast simulation are not split in regions
+      G4LogicalVolume* core =
+        G4LogicalVolumeStore::GetInstance()->GetVolume("FIBER_CORE", false);
+      if (!core) {
+        G4Exception("[NexusPhysics]", "ConstructProcess()", FatalException,
+          "The fiber fast simulation requires a geometry with a FIBER_CORE volume.");
+      }
+
+      G4Region* region = G4RegionStore::GetInstance()->GetRegion("FIBER_CORE", false);
+      if (!region) region = new G4Region("FIBER_CORE");
+      region->AddRootLogicalVolume(core);
+
+      new WLSFiberSimulation(region, fiber_trapping_eff_, optical_prescale_);
+    }
+
+    // Both models act on optical photons through the same process
+
+    if (s1_light_map_ != "" || fiber_fast_sim_) {
+      pmanager = G4OpticalPhoton::Definition()->GetProcessManager();
+      pmanager->AddDiscreteProcess(new G4FastSimulationManagerProcess());
+    }
+  }
+
+
+
+  G4double NexusPhysics::GetOpticalPrescale()
+  {
+    return applied_prescale_;
+  }
+
+
+
+  void NexusPhysics::ApplyOpticalPrescale()
+  {
+    // Detection efficiencies of the sensors, which are divided by the
+    // prescale factor so that the expected number of detected photons
+    // does not change. Wavelength shifting keeps its yield, since the
+    // photons it absorbs have already been prescaled. The fast
+    // simulations, which do not use these efficiencies, weight
+    // their hits by the inverse of the prescale instead.
+    std::set<G4MaterialPropertyVector*> efficiencies;
+    G4double max_efficiency = 0.;
+
+    for (G4SurfaceProperty* property: *G4SurfaceProperty::GetSurfacePropertyTable()) {
+      G4OpticalSurface* surface = dynamic_cast<G4OpticalSurface*>(property);
+      if (!surface || !surface->GetMaterialPropertiesTable()) continue;
+      G4MaterialPropertyVector* efficiency =
+        surface->GetMaterialPropertiesTable()->GetProperty("EFFICIENCY");
+      if (!efficiency) continue;
+      efficiencies.insert(efficiency);
+      max_efficiency = std::max(max_efficiency, efficiency->GetMaxValue());
+    }
+
+    if (max_efficiency > optical_prescale_) {
+      G4Exception("[NexusPhysics]", "ApplyOpticalPrescale()", FatalException,
+        ("The optical prescale factor cannot be smaller than the maximum "
+         "detection efficiency of the sensors (" +
+         std::to_string(max_efficiency) + ").").c_str());
+    }
+
+    for (G4MaterialPropertyVector* efficiency: efficiencies)
+      efficiency->ScaleVector(1., 1. / optical_prescale_);
+
+    // Scintillation yields. Materials may share a properties table.
+    std::set<G4MaterialPropertiesTable*> tables;
+
+    for (G4Material* material: *G4Material::GetMaterialTable()) {
+      G4MaterialPropertiesTable* mpt = material->GetMaterialPropertiesTable();
+      if (!mpt || !tables.insert(mpt).second) continue;
+      if (!mpt->ConstPropertyExists("SCINTILLATIONYIELD")) continue;
+      mpt->AddConstProperty("SCINTILLATIONYIELD",
+        mpt->GetConstProperty("SCINTILLATIONYIELD") * optical_prescale_);
+    }
+
+    // Primary optical photons, thinned by their generators
+    applied_prescale_ = optical_prescale_;
+
+    G4cout << "[NexusPhysics] Optical photons prescaled by " << optical_prescale_
+           << " (maximum detection efficiency " << max_efficiency << ")" << G4endl;
   }
 
 } // end namespace nexus
@@ -29,13 +29,37 @@ namespace nexus {
     /// Construct all required physics processes (Geant4 mandatory method)
     virtual void ConstructProcess();
 
+    /// Fraction of the optical photons generated (1 if no prescale
+    /// is applied), which the generators of optical photons apply
+    /// to their primaries
+    static G4double GetOpticalPrescale();
+
+  private:
+    /// Scale the scintillation yield of all materials by the optical
+    /// prescale factor, divide the detection efficiency of all optical
+    /// surfaces by it and make it available to the generators
+    void ApplyOpticalPrescale();
+
   private:
     G4bool clustering_;          ///< Switch on/of the ionization clustering
     G4bool drift_;               ///< Switch on/of the ionization drift
     G4bool electroluminescence_; ///< Switch on/off the electroluminescence
     G4bool photoelectric_;       ///< Switch on/off the photoelectric effect
+    G4bool photon_budget_;       ///< Switch on/off the optical photon budget
+    G4bool region_killer_;       ///< Switch on/off the region track killer
+    G4bool importance_biasing_;  ///< Switch on/off the gamma importance biasing
+
+    G4String s1_light_map_;   ///< Light map of the S1 fast simulation
+    G4double s1_transit_time_; ///< Mean S1 transit time for single-bin maps
+
+    G4bool fiber_fast_sim_;        ///< Switch on/off the WLS fiber fast simulation
+    G4double fiber_trapping_eff_;  ///< Fixed fiber trapping efficiency (0 = computed)
+
+    G4double optical_prescale_; ///< Fraction of the optical photons generated
 
     G4GenericMessenger* msg_;
+
+    static G4double applied_prescale_; ///< Optical prescale in use
   };
 
 } // end namespace nexus
@@ -52,11 +52,15 @@ namespace nexus {
     G4ThreeVector GetPosition();
     void SetPosition(G4ThreeVector);
 
+    G4double GetWeight();
+    void SetWeight(G4double);
+
   private:
     G4int track_id_;
     G4double time_;
     G4double energy_dep_;
     G4ThreeVector position_;
+    G4double weight_; ///< Weight of the track (importance biasing)
   };
 
 
@@ -86,6 +90,9 @@ namespace nexus {
   inline void IonizationHit::SetPosition(G4ThreeVector xyz)
   { position_ = xyz; }
 
+  inline G4double IonizationHit::GetWeight() { return weight_; }
+  inline void IonizationHit::SetWeight(G4double w) { weight_ = w; }
+
 
 } // end namespace nexus
 
@@ -17,11 +17,19 @@
 #include <G4Step.hh>
 #include <G4OpticalPhoton.hh>
 
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
 
 
 using namespace nexus;
 
 
+G4double IonizationSD::voxel_size_ = 0.;
+G4bool IonizationSD::voxel_per_track_ = false;
+
+
 
 IonizationSD::IonizationSD(const G4String& name):
   G4VSensitiveDetector(name), include_(true)
@@ -57,6 +65,7 @@ void IonizationSD::Initialize(G4HCofThisEvent* hce)
     G4SDManager::GetSDMpointer()->GetCollectionID(SensitiveDetectorName+"/"+collectionName[0]);
   hce->AddHitsCollection(hcid, IHC_);
 
+  voxels_.clear();
 }
 
 
@@ -74,15 +83,21 @@ G4bool IonizationSD::ProcessHits(G4Step* step, G4TouchableHistory*)
   // Discard steps where no energy was deposited in the detector
   if (edep <= 0.) return false;
 
-  // Create a hit and set its properties
-  IonizationHit* hit = new IonizationHit();
-  hit->SetTrackID(step->GetTrack()->GetTrackID());
-  hit->SetTime(step->GetTrack()->GetGlobalTime());
-  hit->SetEnergyDeposit(edep);
-  hit->SetPosition(step->GetPostStepPoint()->GetPosition());
-
-  // Add hit to collection
-  IHC_->insert(hit);
+  if (voxel_size_ > 0.) {
+    AddToVoxel(track, edep, step->GetPostStepPoint()->GetPosition());
+  }
+  else {
+    // Create a hit and set its properties
+    IonizationHit* hit = new IonizationHit();
+    hit->SetTrackID(step->GetTrack()->GetTrackID());
+    hit->SetTime(step->GetTrack()->GetGlobalTime());
+    hit->SetEnergyDeposit(edep);
+    hit->SetPosition(step->GetPostStepPoint()->GetPosition());
+    hit->SetWeight(step->GetTrack()->GetWeight());
+
+    // Add hit to collection
+    IHC_->insert(hit);
+  }
 
   // Add energy deposit to the trajectory associated
   // to the current track
@@ -100,6 +115,72 @@ G4bool IonizationSD::ProcessHits(G4Step* step, G4TouchableHistory*)
 
 
 
+void IonizationSD::AddToVoxel(G4Track* track, G4double edep,
+                              const G4ThreeVector& position)
+{
+  // Deposits of tracks with different weights (importance
+  // biasing) are never merged, so that the weights stay exact
+  VoxelKey key;
+  key.ix = (G4long) std::floor(position.x() / voxel_size_);
+  key.iy = (G4long) std::floor(position.y() / voxel_size_);
+  key.iz = (G4long) std::floor(position.z() / voxel_size_);
+  key.track_id = voxel_per_track_ ? track->GetTrackID() : 0;
+  key.weight = track->GetWeight();
+
+  G4double time = track->GetGlobalTime();
+
+  auto it = voxels_.find(key);
+  if (it == voxels_.end()) {
+    IonizationHit* hit = new IonizationHit();
+    hit->SetTrackID(track->GetTrackID());
+    hit->SetTime(time);
+    hit->SetEnergyDeposit(edep);
+    hit->SetPosition(position);
+    hit->SetWeight(key.weight);
+    IHC_->insert(hit);
+
+    voxels_[key] = Voxel{hit, edep};
+    return;
+  }
+
+  // Energy-weighted centroid in space and time
+  Voxel& voxel = it->second;
+  IonizationHit* hit = voxel.hit;
+  G4double energy = hit->GetEnergyDeposit() + edep;
+  G4double f = edep / energy;
+  hit->SetPosition(hit->GetPosition() + f * (position - hit->GetPosition()));
+  hit->SetTime(hit->GetTime() + f * (time - hit->GetTime()));
+  hit->SetEnergyDeposit(energy);
+
+  if (edep > voxel.max_edep) {
+    voxel.max_edep = edep;
+    hit->SetTrackID(track->GetTrackID());
+  }
+}
+
+
+
+size_t IonizationSD::VoxelHash::operator()(const VoxelKey& key) const
+{
+  // Combination of the fields as in boost::hash_combine
+  size_t seed = 0;
+  auto combine = [&seed](size_t value) {
+    seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+  };
+  uint64_t weight_bits;
+  std::memcpy(&weight_bits, &key.weight, sizeof(weight_bits));
+
+  combine(std::hash<G4long>()(key.ix));
+  combine(std::hash<G4long>()(key.iy));
+  combine(std::hash<G4long>()(key.iz));
+  combine(std::hash<G4int>()(key.track_id));
+  combine(std::hash<uint64_t>()(weight_bits));
+  return seed;
+}
+
+
+
 void IonizationSD::EndOfEvent(G4HCofThisEvent*)
 {
+  voxels_.clear();
 }
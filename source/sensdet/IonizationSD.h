@@ -12,7 +12,10 @@
 #include <G4VSensitiveDetector.hh>
 #include "IonizationHit.h"
 
+#include <unordered_map>
+
 class G4Step;
+class G4Track;
 class G4HCofThisEvent;
 class G4TouchableHistory;
 
@@ -42,19 +45,61 @@ namespace nexus {
 
     void IncludeInTotalEnergyDeposit(G4bool);
 
+    /// Merge the deposits of each event into cubic voxels of the given
+    /// side (none if zero or negative), for all the ionization detectors.
+    /// Each voxel hit is placed at the energy-weighted centroid of its
+    /// deposits, and belongs to the track of its largest deposit.
+    static void SetVoxelSize(G4double);
+    /// Keep the deposits of different tracks in separate voxel hits
+    static void SetVoxelPerTrack(G4bool);
+
   private:
     ///
     virtual G4bool ProcessHits(G4Step*, G4TouchableHistory*);
 
+    /// Add a deposit to the hit of its voxel, creating it if needed
+    void AddToVoxel(G4Track*, G4double edep, const G4ThreeVector& position);
+
   private:
+    /// Voxel of the event (and track or weight, if they are kept apart)
+    struct VoxelKey {
+      G4long ix, iy, iz;
+      G4int track_id;
+      G4double weight;
+      G4bool operator==(const VoxelKey&) const;
+    };
+    struct VoxelHash {
+      size_t operator()(const VoxelKey&) const;
+    };
+    /// Hit of a voxel and largest deposit added to it
+    struct Voxel {
+      IonizationHit* hit;
+      G4double max_edep;
+    };
+
     IonizationHitsCollection* IHC_;
     G4String det_name_;
     G4bool include_;
+
+    std::unordered_map<VoxelKey, Voxel, VoxelHash> voxels_; ///< Voxels of the event
+
+    static G4double voxel_size_;
+    static G4bool voxel_per_track_;
   };
 
   inline void IonizationSD::IncludeInTotalEnergyDeposit(G4bool inc)
   { include_ = inc; }
 
+  inline void IonizationSD::SetVoxelSize(G4double size)
+  { voxel_size_ = size; }
+
+  inline void IonizationSD::SetVoxelPerTrack(G4bool per_track)
+  { voxel_per_track_ = per_track; }
+
+  inline G4bool IonizationSD::VoxelKey::operator==(const VoxelKey& other) const
+  { return ix == other.ix && iy == other.iy && iz == other.iz &&
+           track_id == other.track_id && weight == other.weight; }
+
 } // end namespace nexus
 
 #endif
@@ -15,14 +15,82 @@
 #include <G4OpBoundaryProcess.hh>
 #include <G4RunManager.hh>
 #include <G4RunManager.hh>
+#include <G4TransportationManager.hh>
+#include <G4Navigator.hh>
+#include <G4NavigationHistory.hh>
+#include <G4TouchableHistory.hh>
+#include <G4LogicalVolume.hh>
+#include <G4VPhysicalVolume.hh>
+#include <G4VPVParameterisation.hh>
+
+
+namespace {
+
+  void AddSensors(G4NavigationHistory& history,
+                  std::map<G4int, std::pair<nexus::SensorSD*, G4ThreeVector>>& sensors)
+  {
+    G4LogicalVolume* logic = history.GetTopVolume()->GetLogicalVolume();
+
+    nexus::SensorSD* sd =
+      dynamic_cast<nexus::SensorSD*>(logic->GetSensitiveDetector());
+    if (sd) {
+      G4TouchableHistory touchable(history);
+      sensors[sd->FindPmtID(&touchable)] =
+        std::make_pair(sd, touchable.GetTranslation());
+    }
+
+    for (size_t i=0; i<logic->GetNoDaughters(); ++i) {
+      G4VPhysicalVolume* daughter = logic->GetDaughter(i);
+
+      if (!daughter->IsReplicated()) {
+        history.NewLevel(daughter, kNormal, daughter->GetCopyNo());
+        AddSensors(history, sensors);
+        history.BackLevel();
+        continue;
+      }
+
+      // Parameterised volumes are visited copy by copy.
+      // Replicas are not used for sensors.
+      G4VPVParameterisation* param = daughter->GetParameterisation();
+      if (!param) continue;
+
+      EAxis axis; G4int ncopies; G4double width, offset; G4bool consuming;
+      daughter->GetReplicationData(axis, ncopies, width, offset, consuming);
+
+      // The volume is moved to each copy in turn, and then put back
+      // where it was, which the navigator may rely on
+      G4ThreeVector translation = daughter->GetTranslation();
+      G4RotationMatrix* rotation = daughter->GetRotation();
+      G4int copy_no = daughter->GetCopyNo();
+
+      for (G4int copy=0; copy<ncopies; ++copy) {
+        param->ComputeTransformation(copy, daughter);
+        daughter->SetCopyNo(copy);
+        history.NewLevel(daughter, kParameterised, copy);
+        AddSensors(history, sensors);
+        history.BackLevel();
+      }
+
+      daughter->SetTranslation(translation);
+      daughter->SetRotation(rotation);
+      daughter->SetCopyNo(copy_no);
+    }
+  }
+
+}
 
 
 namespace nexus {
 
 
+  std::map<G4int, std::pair<SensorSD*, G4ThreeVector>> SensorSD::sensors_;
+  G4bool SensorSD::sensors_built_ = false;
+
+
+
   SensorSD::SensorSD(G4String sdname):
     G4VSensitiveDetector(sdname),
-    naming_order_(0), sensor_depth_(0), mother_depth_(0)
+    naming_order_(0), sensor_depth_(0), mother_depth_(0), id_offset_(0)
   {
     // Register the name of the collection of hits
     collectionName.insert(GetCollectionUniqueName());
@@ -67,6 +135,17 @@ namespace nexus {
 
     G4int pmt_id = FindPmtID(touchable);
 
+    G4double time = step->GetPostStepPoint()->GetGlobalTime();
+    FillHit(pmt_id, touchable->GetTranslation(), time);
+
+    return true;
+  }
+
+
+
+  void SensorSD::FillHit(G4int pmt_id, const G4ThreeVector& position,
+                         G4double time, G4int counts)
+  {
     SensorHit* hit = 0;
     for (size_t i=0; i<HC_->entries(); i++) {
       if ((*HC_)[i]->GetPmtID() == pmt_id) {
@@ -81,26 +160,57 @@ namespace nexus {
       hit = new SensorHit();
       hit->SetPmtID(pmt_id);
       hit->SetBinSize(timebinning_);
-      hit->SetPosition(touchable->GetTranslation());
+      hit->SetPosition(position);
       HC_->insert(hit);
     }
 
-    G4double time = step->GetPostStepPoint()->GetGlobalTime();
-    hit->Fill(time);
-
-    return true;
+    hit->Fill(time, counts);
   }
 
 
 
-  G4int SensorSD::FindPmtID(const G4VTouchable* touchable)
+  G4int SensorSD::FindPmtID(const G4VTouchable* touchable) const
   {
     G4int pmtid = touchable->GetCopyNumber(sensor_depth_);
     if (naming_order_ != 0) {
       G4int motherid = touchable->GetCopyNumber(mother_depth_);
       pmtid = naming_order_ * motherid + pmtid;
     }
-    return pmtid;
+    return pmtid + id_offset_;
+  }
+
+
+
+  std::map<G4int, std::pair<SensorSD*, G4ThreeVector>> SensorSD::FindSensors()
+  {
+    std::map<G4int, std::pair<SensorSD*, G4ThreeVector>> sensors;
+
+    G4VPhysicalVolume* world = G4TransportationManager::GetTransportationManager()
+      ->GetNavigatorForTracking()->GetWorldVolume();
+    if (!world) return sensors;
+
+    G4NavigationHistory history;
+    history.SetFirstEntry(world);
+    AddSensors(history, sensors);
+
+    return sensors;
+  }
+
+
+
+  void SensorSD::BuildSensorMap()
+  {
+    sensors_ = FindSensors();
+    sensors_built_ = true;
+  }
+
+
+
+  const std::map<G4int, std::pair<SensorSD*, G4ThreeVector>>& SensorSD::GetSensors()
+  {
+    // Applications other than nexus (e.g. the tests) may not build it
+    if (!sensors_built_) BuildSensorMap();
+    return sensors_;
   }
 
 
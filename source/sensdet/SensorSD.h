@@ -13,6 +13,8 @@
 #include <G4VSensitiveDetector.hh>
 #include "SensorHit.h"
 
+#include <map>
+
 class G4Step;
 class G4HCofThisEvent;
 class G4VTouchable;
@@ -51,6 +53,11 @@ namespace nexus {
     void SetDetectorNamingOrder(G4int);
     /// Return the naming order of the SD
     G4int GetDetectorNamingOrder() const;
+    /// Set an offset added to the IDs of the sensors (used when the
+    /// copy numbers start from 0, as in parameterised placements)
+    void SetDetectorIDOffset(G4int);
+    /// Return the offset added to the IDs of the sensors
+    G4int GetDetectorIDOffset() const;
 
     /// Return the time binning chosen for the pmt hits
     G4double GetTimeBinning() const;
@@ -62,19 +69,41 @@ namespace nexus {
     /// persistency manager to select the collection.
     static G4String GetCollectionUniqueName();
 
+    /// Return the ID of the sensor of a given touchable
+    G4int FindPmtID(const G4VTouchable*) const;
+
+    /// Add detected photons to the hit of a sensor, creating it if needed.
+    /// Used as well by the models that do not track optical photons.
+    void FillHit(G4int pmt_id, const G4ThreeVector& position,
+                 G4double time, G4int counts=1);
+
+    /// Sensitive detector and position of every sensor of the geometry,
+    /// found by walking the geometry tree. The parameterised volumes
+    /// visited are left as they were, but this must not be done while
+    /// a track is being navigated: use GetSensors then.
+    static std::map<G4int, std::pair<SensorSD*, G4ThreeVector>> FindSensors();
+
+    /// Build the map returned by GetSensors. Invoked
+    /// at the beginning of every run by the application.
+    static void BuildSensorMap();
+    /// Sensors of the geometry, as found at the beginning of the run
+    static const std::map<G4int, std::pair<SensorSD*, G4ThreeVector>>& GetSensors();
+
   private:
 
     G4bool ProcessHits(G4Step*, G4TouchableHistory*);
 
-    G4int FindPmtID(const G4VTouchable*);
-
     G4int naming_order_; ///< Order of the naming scheme
     G4int sensor_depth_; ///< Depth of the SD in the geometry tree
     G4int mother_depth_; ///< Depth of the SD's mother in the geometry tree
+    G4int id_offset_;    ///< Offset added to the sensor IDs
 
     G4double timebinning_; ///< Time bin width
 
     SensorHitsCollection* HC_; ///< Pointer to the collection of hits
+
+    static std::map<G4int, std::pair<SensorSD*, G4ThreeVector>> sensors_;
+    static G4bool sensors_built_;
   };
 
   // INLINE METHODS //////////////////////////////////////////////////
@@ -88,6 +117,9 @@ namespace nexus {
   inline void SensorSD::SetDetectorNamingOrder(G4int o) { naming_order_ = o; }
   inline G4int SensorSD::GetDetectorNamingOrder() const { return naming_order_; }
 
+  inline void SensorSD::SetDetectorIDOffset(G4int o) { id_offset_ = o; }
+  inline G4int SensorSD::GetDetectorIDOffset() const { return id_offset_; }
+
   inline G4double SensorSD::GetTimeBinning() const { return timebinning_; }
   inline void SensorSD::SetTimeBinning(G4double tb) { timebinning_ = tb; }
 
@@ -0,0 +1,75 @@
+#include <GenbbFileReader.h>
+
+#include <catch.hpp>
+
+#include <cstdio>
+#include <fstream>
+
+
+TEST_CASE("GENBB file reader") {
+
+  // This test checks that the events of a GENBB file are indexed
+  // and parsed correctly, also when reading starts at a later event
+
+  std::string filename = "genbb_file_reader_test.genbb";
+  {
+    std::ofstream genbb(filename);
+    genbb << " GENBB generated file: test.genbb\n"
+          << " First event and full number of events:\n"
+          << "           1           3\n"
+          << "    \n"
+          << "       0  0.00000       2\n"
+          << "  3 -0.664532      0.813668     -0.105448      0.00000    \n"
+          << "  3 -0.481507       1.58726       1.51959      0.00000    \n"
+          << "       1  0.50000       1\n"
+          << "  1  1.2E-01  -2.5D+00  0.00000  1.0E-09\n"
+          << "       2  0.00000       0\n";
+  }
+  std::remove((filename + ".idx").c_str());
+
+  nexus::GenbbFileReader reader(filename);
+  REQUIRE (reader.IsOpen());
+  REQUIRE (reader.GetNumberOfEvents() == 3);
+
+  nexus::GenbbEvent event;
+
+  SECTION ("Sequential reading"){
+    REQUIRE (reader.ReadEvent(event));
+    REQUIRE (event.number == 0);
+    REQUIRE (event.particles.size() == 2);
+    REQUIRE (event.particles[0].g3code == 3);
+    REQUIRE (event.particles[0].px == Approx(-0.664532));
+    REQUIRE (event.particles[1].pz == Approx( 1.51959));
+
+    REQUIRE (reader.ReadEvent(event));
+    REQUIRE (event.time == Approx(0.5));
+    REQUIRE (event.particles.size() == 1);
+    REQUIRE (event.particles[0].px   == Approx( 0.12));
+    REQUIRE (event.particles[0].py   == Approx(-2.5));
+    REQUIRE (event.particles[0].time == Approx( 1.e-9));
+
+    REQUIRE (reader.ReadEvent(event));
+    REQUIRE (event.particles.empty());
+
+    REQUIRE (!reader.ReadEvent(event));
+  }
+
+  SECTION ("Seek and index"){
+    reader.Seek(2);
+    REQUIRE (reader.ReadEvent(event));
+    REQUIRE (event.number == 2);
+
+    // A second reader uses the index written by the first one
+    std::ifstream index(filename + ".idx");
+    REQUIRE (index.good());
+
+    nexus::GenbbFileReader indexed(filename);
+    REQUIRE (indexed.GetNumberOfEvents() == 3);
+    indexed.Seek(1);
+    REQUIRE (indexed.ReadEvent(event));
+    REQUIRE (event.number == 1);
+  }
+
+  std::remove(filename.c_str());
+  std::remove((filename + ".idx").c_str());
+}
@@ -0,0 +1,126 @@
+#include <HistogramSampler.h>
+#include <Randomize.hh>
+
+#include <catch.hpp>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+
+TEST_CASE("Histogram sampler") {
+
+  // 1D histogram with bins of width 1 centred at 0, 1, 2 and 3
+  std::vector<G4double> contents = {1., 0., 3., 6.};
+  std::vector<std::vector<G4double>> centres = {{0., 1., 2., 3.}};
+  std::vector<std::vector<G4double>> widths  = {{1., 1., 1., 1.}};
+
+  nexus::HistogramSampler sampler;
+  sampler.SetHistogram(contents, centres, widths);
+
+  SECTION ("Bin frequencies follow the contents"){
+    const G4int nsamples = 100000;
+    std::vector<G4int> counts(contents.size(), 0);
+    for (G4int i=0; i<nsamples; ++i)
+      counts[sampler.SampleBin()]++;
+
+    REQUIRE (counts[1] == 0);
+    REQUIRE (counts[0] / (G4double) nsamples == Approx(0.1).margin(0.01));
+    REQUIRE (counts[2] / (G4double) nsamples == Approx(0.3).margin(0.01));
+    REQUIRE (counts[3] / (G4double) nsamples == Approx(0.6).margin(0.01));
+  }
+
+  SECTION ("Samples lie inside their bin"){
+    std::vector<G4double> values;
+    for (G4int i=0; i<1000; ++i) {
+      sampler.Sample(values);
+      REQUIRE (values.size() == 1);
+      REQUIRE (values[0] >= -0.5);
+      REQUIRE (values[0] <=  3.5);
+      REQUIRE ((values[0] < 0.5 || values[0] > 1.5));
+    }
+  }
+
+  SECTION ("Window restricts the bins"){
+    sampler.SetWindow(0, 1.5, 2.5);
+    for (G4int i=0; i<1000; ++i)
+      REQUIRE (sampler.SampleBin() == 2);
+  }
+
+  SECTION ("Range covers the bin edges"){
+    G4double min, max;
+    sampler.GetRange(0, min, max);
+    REQUIRE (min == Approx(-0.5));
+    REQUIRE (max == Approx( 3.5));
+  }
+
+}
+
+
+TEST_CASE("Histogram sampler CSV cache") {
+
+  // This test checks that a histogram read back from the
+  // binary cache is identical to the one parsed from the CSV file,
+  // and that the cache is used instead of the CSV file when
+  // the size and modification time of the latter are unchanged
+
+  std::string filename = "histogram_sampler_test.csv";
+  {
+    std::ofstream csv(filename);
+    csv << "value,1.5,0.1,10,0.2,2\n";
+    csv << "value,0,0.3,10,0.2,2\n";
+    csv << "value,2.5,0.1,12,0.2,2\n";
+    csv << "zenith,0\n";
+  }
+  std::remove((filename + ".cache").c_str());
+
+  nexus::HistogramSampler parsed;
+  parsed.LoadCSV(filename, 2);
+
+  std::ifstream cache(filename + ".cache");
+  REQUIRE (cache.good());
+
+  nexus::HistogramSampler cached;
+  cached.LoadCSV(filename, 2);
+
+  REQUIRE (parsed.GetDimension()    == 2);
+  REQUIRE (parsed.GetNumberOfBins() == 3);
+  REQUIRE (cached.GetNumberOfBins() == 3);
+
+  for (size_t bin=0; bin<3; ++bin) {
+    REQUIRE (cached.GetBinContent(bin) == parsed.GetBinContent(bin));
+    for (size_t dim=0; dim<2; ++dim) {
+      REQUIRE (cached.GetBinCentre(bin, dim) == parsed.GetBinCentre(bin, dim));
+      REQUIRE (cached.GetBinWidth (bin, dim) == parsed.GetBinWidth (bin, dim));
+    }
+  }
+
+  REQUIRE (parsed.GetBinCentre(2, 1) == Approx(12.));
+  REQUIRE (parsed.GetBinWidth (2, 1) == Approx(2.));
+
+  // Change a bin content without changing the size or
+  // the modification time of the file: the cache must be hit
+  auto mtime = std::filesystem::last_write_time(filename);
+  {
+    std::ofstream csv(filename);
+    csv << "value,4.5,0.1,10,0.2,2\n";
+    csv << "value,0,0.3,10,0.2,2\n";
+    csv << "value,2.5,0.1,12,0.2,2\n";
+    csv << "zenith,0\n";
+  }
+  std::filesystem::last_write_time(filename, mtime);
+
+  nexus::HistogramSampler hit;
+  hit.LoadCSV(filename, 2);
+  REQUIRE (hit.GetBinContent(0) == parsed.GetBinContent(0));
+
+  // Without the cache the new contents are read
+  std::remove((filename + ".cache").c_str());
+  nexus::HistogramSampler miss;
+  miss.LoadCSV(filename, 2);
+  REQUIRE (miss.GetBinContent(0) != parsed.GetBinContent(0));
+
+  std::remove(filename.c_str());
+  std::remove((filename + ".cache").c_str());
+}
@@ -0,0 +1,123 @@
+#include <VertexPool.h>
+#include <Randomize.hh>
+
+#include <catch.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <set>
+#include <vector>
+
+
+TEST_CASE("Vertex pool") {
+
+  // Vertices numbered along x, to tell them apart
+  G4int sampled = 0;
+  auto generate = [&sampled]() { return G4ThreeVector(sampled++, 0., 0.); };
+
+  const size_t size = 100;
+  nexus::VertexPool pool(generate, size);
+  pool.Fill("", "");
+
+  SECTION ("All vertices are drawn once before sampling again"){
+    std::set<G4double> drawn;
+    for (size_t i=0; i<size; ++i)
+      drawn.insert(pool.Draw().x());
+
+    REQUIRE (drawn.size() == size);
+    REQUIRE (*drawn.begin()  == 0.);
+    REQUIRE (*drawn.rbegin() == size - 1.);
+    REQUIRE (pool.GetRemaining() == 0);
+    REQUIRE (pool.GetRefills()   == 0);
+
+    // The next vertex comes from a new pool
+    REQUIRE (pool.Draw().x() >= size);
+    REQUIRE (pool.GetRefills() == 1);
+    REQUIRE (sampled == 2 * size);
+  }
+
+  SECTION ("Size check"){
+    // A single job never draws a vertex twice
+    REQUIRE (pool.UncertaintyFactor(10 * size, 1) == 1.);
+    REQUIRE (pool.CheckSize(10 * size, 1));
+
+    // Two jobs drawing the whole pool use the same vertices
+    REQUIRE (pool.UncertaintyFactor(size, 2) == Approx(std::sqrt(2.)));
+    REQUIRE (pool.UncertaintyFactor(size / 4, 2) == Approx(std::sqrt(1.25)));
+    REQUIRE (pool.UncertaintyFactor(4 * size, 2) == Approx(std::sqrt(1.25)));
+    REQUIRE (!pool.CheckSize(size / 4, 2));
+    REQUIRE ( pool.CheckSize(size / 40, 2));
+  }
+
+  SECTION ("Statistical uncertainty of the jobs sharing the pool"){
+    // Mean of x over the events of several jobs reading the same pool,
+    // each with its own random stream, compared with its expected spread
+    const size_t jobs = 4, events = 50, trials = 4000;
+    std::vector<G4double> xs(size);
+    auto shared = [&xs, &sampled]() { return G4ThreeVector(xs[sampled++ % size], 0., 0.); };
+
+    G4double sum = 0., sum2 = 0.;
+    for (size_t t=0; t<trials; ++t) {
+      // A new pool of independent vertices for each trial
+      for (auto& x: xs) x = G4UniformRand();
+      G4double mean = 0.;
+      for (size_t j=0; j<jobs; ++j) {
+        sampled = 0;
+        nexus::VertexPool job(shared, size);
+        job.Fill("", "");
+        for (size_t e=0; e<events; ++e) mean += job.Draw().x();
+      }
+      mean /= jobs * events;
+      sum  += mean;
+      sum2 += mean * mean;
+    }
+    G4double variance = sum2 / trials - (sum / trials) * (sum / trials);
+
+    // Uniform x: sigma^2 = 1/12
+    G4double expected = pool.UncertaintyFactor(events, jobs) / std::sqrt(12. * jobs * events);
+    REQUIRE (std::sqrt(variance) == Approx(expected).epsilon(0.05));
+  }
+
+}
+
+
+TEST_CASE("Vertex pool cache") {
+
+  const std::string filename = "VertexPoolTests.vtx";
+
+  G4int sampled = 0;
+  auto generate = [&sampled]() { return G4ThreeVector(sampled++, 1., 2.); };
+
+  // The first pool is sampled and written
+  nexus::VertexPool first(generate, 10);
+  first.Fill(filename, "key");
+  REQUIRE (sampled == 10);
+
+  SECTION ("The pool is read with the same key"){
+    nexus::VertexPool second(generate, 10);
+    second.Fill(filename, "key");
+    REQUIRE (sampled == 10);
+
+    std::set<G4double> drawn;
+    for (size_t i=0; i<10; ++i) {
+      G4ThreeVector vertex = second.Draw();
+      REQUIRE (vertex.y() == 1.);
+      REQUIRE (vertex.z() == 2.);
+      drawn.insert(vertex.x());
+    }
+    REQUIRE (drawn.size() == 10);
+    REQUIRE (*drawn.rbegin() == 9.);
+  }
+
+  SECTION ("The pool is sampled again with another key or size"){
+    nexus::VertexPool second(generate, 10);
+    second.Fill(filename, "other key");
+    REQUIRE (sampled == 20);
+
+    nexus::VertexPool third(generate, 5);
+    third.Fill(filename, "other key");
+    REQUIRE (sampled == 25);
+  }
+
+  std::remove(filename.c_str());
+}
@@ -0,0 +1,301 @@
+// ----------------------------------------------------------------------------
+// nexus | GenbbFileReader.cc
+//
+// Reader of the event files written by Decay0/GENBB. The file is mapped
+// in memory and indexed once (the offsets of the events are stored in a
+// sidecar file next to it), so that reading can start at any event, and
+// numbers are parsed without going through the C++ streams.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "GenbbFileReader.h"
+#include "IOUtils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace {
+
+  // Number parsing on the mapped buffer. The GENBB files only contain
+  // plain decimal numbers, so there is no need for locale handling.
+
+  inline void SkipSpaces(const char*& p, const char* end)
+  {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) ++p;
+  }
+
+
+  inline void SkipLine(const char*& p, const char* end)
+  {
+    const void* eol = std::memchr(p, '\n', end - p);
+    p = eol ? static_cast<const char*>(eol) + 1 : end;
+  }
+
+
+  G4bool ParseLong(const char*& p, const char* end, G4long& value)
+  {
+    SkipSpaces(p, end);
+
+    G4bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) negative = (*p++ == '-');
+
+    const char* start = p;
+    G4long result = 0;
+    while (p < end && *p >= '0' && *p <= '9') result = 10 * result + (*p++ - '0');
+    if (p == start) return false;
+
+    value = negative ? -result : result;
+    return true;
+  }
+
+
+  G4bool ParseDouble(const char*& p, const char* end, G4double& value)
+  {
+    SkipSpaces(p, end);
+
+    G4bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) negative = (*p++ == '-');
+
+    // Up to 19 significant digits fit in the integer mantissa
+    const char* start = p;
+    uint64_t mantissa = 0;
+    G4int exponent = 0;
+    G4int digits = 0;
+
+    for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+      if (digits < 19) { mantissa = 10 * mantissa + (*p - '0'); if (mantissa) ++digits; }
+      else             ++exponent;
+    }
+    if (p < end && *p == '.') {
+      for (++p; p < end && *p >= '0' && *p <= '9'; ++p) {
+        if (digits < 19) { mantissa = 10 * mantissa + (*p - '0'); if (mantissa) ++digits; --exponent; }
+      }
+    }
+    if (p == start || (p == start + 1 && *start == '.')) return false;
+
+    // Exponent, also in the FORTRAN D notation
+    if (p < end && (*p == 'e' || *p == 'E' || *p == 'd' || *p == 'D')) {
+      const char* exp_start = p++;
+      G4long exp_value;
+      if (ParseLong(p, end, exp_value)) exponent += exp_value;
+      else                              p = exp_start;
+    }
+
+    // Powers of ten are exact up to 1e22, so dividing
+    // keeps short decimal fractions correctly rounded
+    G4double result = static_cast<G4double>(mantissa);
+    if      (exponent > 0) result *= std::pow(10.,  exponent);
+    else if (exponent < 0) result /= std::pow(10., -exponent);
+
+    value = negative ? -result : result;
+    return true;
+  }
+
+} // end anonymous namespace
+
+
+namespace nexus {
+
+
+  GenbbFileReader::GenbbFileReader(const std::string& filename):
+    filename_(filename), data_(nullptr), size_(0), next_(0)
+  {
+    G4int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return;
+
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+      void* map = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (map != MAP_FAILED) {
+        data_ = static_cast<const char*>(map);
+        size_ = info.st_size;
+        madvise(map, size_, MADV_SEQUENTIAL);
+      }
+    }
+    close(fd);
+
+    if (!data_) return;
+
+    // The index is tied to the size and modification time of the file
+    std::error_code error;
+    auto mtime = std::filesystem::last_write_time(filename, error);
+    std::string key = HashString(filename + " " + std::to_string(size_) + " " +
+                                 std::to_string(mtime.time_since_epoch().count()));
+    std::string index = filename + ".idx";
+
+    if (!ReadIndex(index, key)) {
+      BuildIndex();
+      WriteIndex(index, key);
+    }
+  }
+
+
+
+  GenbbFileReader::~GenbbFileReader()
+  {
+    if (data_) munmap(const_cast<char*>(data_), size_);
+  }
+
+
+
+  size_t GenbbFileReader::FindFirstEvent() const
+  {
+    // The events follow the line "First event and full number of events:"
+    // and the line with these two numbers
+    const char* end = data_ + size_;
+    const char* key = "First event";
+    const char* p = std::search(data_, end, key, key + std::strlen(key));
+    if (p == end) return size_;
+
+    SkipLine(p, end);
+    SkipLine(p, end);
+    return p - data_;
+  }
+
+
+
+  void GenbbFileReader::BuildIndex()
+  {
+    offsets_.clear();
+
+    const char* end = data_ + size_;
+    const char* p = data_ + FindFirstEvent();
+
+    while (true) {
+      SkipSpaces(p, end);
+      if (p >= end) break;
+
+      const char* event_start = p;
+      G4long number, entries;
+      G4double time;
+      if (!ParseLong(p, end, number) || !ParseDouble(p, end, time) ||
+          !ParseLong(p, end, entries) || entries < 0) {
+        G4Exception("[GenbbFileReader]", "BuildIndex()", JustWarning,
+                    ("Malformed event in " + filename_ +
+                     ", ignoring the rest of the file.").c_str());
+        break;
+      }
+
+      // One line per particle after the event line
+      SkipLine(p, end);
+      for (G4long i=0; i<entries && p < end; ++i) SkipLine(p, end);
+
+      offsets_.push_back(event_start - data_);
+    }
+  }
+
+
+
+  void GenbbFileReader::Seek(size_t event)
+  {
+    if (event > offsets_.size())
+      G4Exception("[GenbbFileReader]", "Seek()", FatalException,
+                  ("Event " + std::to_string(event) + " is beyond the end of " +
+                   filename_ + " (" + std::to_string(offsets_.size()) + " events).").c_str());
+    next_ = event;
+  }
+
+
+
+  G4bool GenbbFileReader::ReadEvent(GenbbEvent& event)
+  {
+    if (next_ >= offsets_.size()) return false;
+
+    const char* end = data_ + size_;
+    const char* p = data_ + offsets_[next_];
+
+    G4long entries = 0;
+    G4bool ok = ParseLong(p, end, event.number) &&
+                ParseDouble(p, end, event.time) &&
+                ParseLong(p, end, entries);
+
+    event.particles.resize(ok ? entries : 0);
+    for (G4long i=0; ok && i<entries; ++i) {
+      GenbbParticle& particle = event.particles[i];
+      G4long g3code;
+      ok = ParseLong(p, end, g3code) &&
+           ParseDouble(p, end, particle.px) &&
+           ParseDouble(p, end, particle.py) &&
+           ParseDouble(p, end, particle.pz) &&
+           ParseDouble(p, end, particle.time);
+      particle.g3code = g3code;
+    }
+
+    if (!ok)
+      G4Exception("[GenbbFileReader]", "ReadEvent()", FatalException,
+                  ("Malformed event " + std::to_string(next_) + " in " + filename_).c_str());
+
+    ++next_;
+    return true;
+  }
+
+
+  // -------
+
+  // Index format (native binary):
+  // <magic> <key length> <key> <number of events> <offsets>
+  static const char index_magic[8] = {'G','E','N','B','B','I','D','X'};
+
+  G4bool GenbbFileReader::ReadIndex(const std::string& filename, const std::string& key)
+  {
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open()) return false;
+
+    char magic[8];
+    uint64_t key_size = 0;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(&key_size), sizeof(key_size));
+    if (!in.good() || std::memcmp(magic, index_magic, sizeof(magic)) != 0 ||
+        key_size != key.size()) return false;
+
+    std::string stored(key_size, ' ');
+    in.read(&stored[0], key_size);
+    if (!in.good() || stored != key) return false;
+
+    uint64_t nevents = 0;
+    in.read(reinterpret_cast<char*>(&nevents), sizeof(nevents));
+    if (!in.good() || nevents > size_) return false;
+
+    std::vector<uint64_t> offsets(nevents);
+    in.read(reinterpret_cast<char*>(offsets.data()), nevents * sizeof(uint64_t));
+    if (!in.good()) return false;
+
+    for (auto offset: offsets)
+      if (offset >= size_) return false;
+
+    offsets_.swap(offsets);
+    return true;
+  }
+
+
+
+  void GenbbFileReader::WriteIndex(const std::string& filename, const std::string& key) const
+  {
+    std::ostringstream out;
+
+    uint64_t key_size = key.size();
+    uint64_t nevents  = offsets_.size();
+    out.write(index_magic, sizeof(index_magic));
+    out.write(reinterpret_cast<const char*>(&key_size), sizeof(key_size));
+    out.write(key.data(), key_size);
+    out.write(reinterpret_cast<const char*>(&nevents), sizeof(nevents));
+    out.write(reinterpret_cast<const char*>(offsets_.data()),
+              nevents * sizeof(uint64_t));
+
+    // Failing to write the index is not an error
+    WriteFileAtomically(filename, out.str());
+  }
+
+
+} // end namespace nexus
@@ -0,0 +1,92 @@
+// ----------------------------------------------------------------------------
+// nexus | GenbbFileReader.h
+//
+// Reader of the event files written by Decay0/GENBB. The file is mapped
+// in memory and indexed once (the offsets of the events are stored in a
+// sidecar file next to it), so that reading can start at any event, and
+// numbers are parsed without going through the C++ streams.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef GENBB_FILE_READER_H
+#define GENBB_FILE_READER_H
+
+#include <globals.hh>
+
+#include <cstdint>
+#include <vector>
+
+
+namespace nexus {
+
+  /// Particle of a GENBB event
+  struct GenbbParticle {
+    G4int g3code;      ///< GEANT3 particle code
+    G4double px, py, pz; ///< Momentum components in MeV
+    G4double time;     ///< Time shift from the previous particle in seconds
+  };
+
+  /// Event of a GENBB file
+  struct GenbbEvent {
+    G4long number;   ///< Event number in the file
+    G4double time;   ///< Start time of the event in seconds
+    std::vector<GenbbParticle> particles;
+  };
+
+
+  class GenbbFileReader
+  {
+  public:
+    /// Constructor. Maps the file and loads or builds its index.
+    GenbbFileReader(const std::string& filename);
+    /// Destructor
+    ~GenbbFileReader();
+
+    /// False if the file could not be opened or mapped
+    G4bool IsOpen() const;
+
+    /// Number of events in the file
+    size_t GetNumberOfEvents() const;
+
+    /// Index of the next event to be read
+    size_t GetNextEvent() const;
+
+    /// Continue reading at the given event (counted from 0)
+    void Seek(size_t event);
+
+    /// Read the next event. Returns false at the end of the file.
+    G4bool ReadEvent(GenbbEvent& event);
+
+  private:
+    /// Offset of the first event, after the file header
+    size_t FindFirstEvent() const;
+    /// Scan the file for the offsets of the events
+    void BuildIndex();
+
+    G4bool ReadIndex(const std::string& filename, const std::string& key);
+    void WriteIndex(const std::string& filename, const std::string& key) const;
+
+  private:
+    std::string filename_;
+    const char* data_; ///< Mapped file
+    size_t size_;      ///< Size of the mapped file
+
+    std::vector<uint64_t> offsets_; ///< Offset of each event in the file
+    size_t next_;      ///< Index of the next event to be read
+  };
+
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline G4bool GenbbFileReader::IsOpen() const
+  { return data_ != nullptr; }
+
+  inline size_t GenbbFileReader::GetNumberOfEvents() const
+  { return offsets_.size(); }
+
+  inline size_t GenbbFileReader::GetNextEvent() const
+  { return next_; }
+
+} // end namespace nexus
+
+#endif
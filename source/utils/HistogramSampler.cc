@@ -0,0 +1,304 @@
+// ----------------------------------------------------------------------------
+// nexus | HistogramSampler.cc
+//
+// Sampler of N-dimensional histograms given as lists of bins (content,
+// centre and width in each dimension), such as the muon flux tables.
+// Bins are selected in constant time with Walker's alias method; a
+// window in any dimension restricts the table to the bins whose centre
+// lies inside it, so that no sample is rejected. Histograms read from
+// CSV files are cached in a binary file next to them.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "HistogramSampler.h"
+#include "IOUtils.h"
+
+#include <Randomize.hh>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+
+namespace nexus {
+
+
+  HistogramSampler::HistogramSampler()
+  {
+  }
+
+
+
+  HistogramSampler::~HistogramSampler()
+  {
+  }
+
+
+
+  void HistogramSampler::LoadCSV(const std::string& filename, size_t ndim)
+  {
+    std::error_code error;
+    auto size  = std::filesystem::file_size(filename, error);
+    auto mtime = std::filesystem::last_write_time(filename, error);
+    if (error)
+      G4Exception("[HistogramSampler]", "LoadCSV()",
+                  FatalException, (" could not read in the CSV file " + filename).c_str());
+
+    // The cache is tied to the size and modification time of the file
+    std::string key = HashString(filename + " " + std::to_string(size) + " " +
+                                 std::to_string(mtime.time_since_epoch().count()) +
+                                 " " + std::to_string(ndim));
+    std::string cache = filename + ".cache";
+
+    if (ReadCache(cache, key)) return;
+
+    std::ifstream file(filename);
+    if (!file.is_open())
+      G4Exception("[HistogramSampler]", "LoadCSV()",
+                  FatalException, (" could not read in the CSV file " + filename).c_str());
+
+    std::vector<G4double> contents;
+    std::vector<std::vector<G4double>> centres(ndim), widths(ndim);
+
+    const std::string header = "value,";
+    std::string line;
+    while (std::getline(file, line)) {
+      if (line.compare(0, header.size(), header) != 0) continue;
+
+      // Content, then the centres and the widths in each dimension
+      const char* ptr = line.c_str() + header.size();
+      char* end;
+      std::vector<G4double> fields;
+      for (size_t i=0; i<1+2*ndim; ++i) {
+        fields.push_back(std::strtod(ptr, &end));
+        if (end == ptr)
+          G4Exception("[HistogramSampler]", "LoadCSV()", FatalException,
+                      (" wrong line in " + filename + ": " + line).c_str());
+        ptr = (*end == ',') ? end + 1 : end;
+      }
+
+      contents.push_back(fields[0]);
+      for (size_t d=0; d<ndim; ++d) {
+        centres[d].push_back(fields[1+d]);
+        widths [d].push_back(fields[1+ndim+d]);
+      }
+    }
+
+    SetHistogram(contents, centres, widths);
+    WriteCache(cache, key);
+  }
+
+
+
+  void HistogramSampler::SetHistogram(const std::vector<G4double>& contents,
+                                      const std::vector<std::vector<G4double>>& centres,
+                                      const std::vector<std::vector<G4double>>& widths)
+  {
+    if (contents.empty() || centres.size() != widths.size())
+      G4Exception("[HistogramSampler]", "SetHistogram()",
+                  FatalException, " empty or inconsistent histogram");
+
+    for (size_t d=0; d<centres.size(); ++d) {
+      if (centres[d].size() != contents.size() || widths[d].size() != contents.size())
+        G4Exception("[HistogramSampler]", "SetHistogram()",
+                    FatalException, " empty or inconsistent histogram");
+    }
+
+    contents_ = contents;
+    centres_  = centres;
+    widths_   = widths;
+
+    G4double inf = std::numeric_limits<G4double>::infinity();
+    windows_.assign(centres_.size(), std::make_pair(-inf, inf));
+
+    BuildAliasTable();
+  }
+
+
+
+  void HistogramSampler::SetWindow(size_t dim, G4double min, G4double max)
+  {
+    if (dim >= windows_.size() || min > max)
+      G4Exception("[HistogramSampler]", "SetWindow()",
+                  FatalException, " wrong sampling window");
+
+    windows_[dim] = std::make_pair(min, max);
+    BuildAliasTable();
+  }
+
+
+
+  void HistogramSampler::BuildAliasTable()
+  {
+    bins_.clear();
+    G4double total = 0.;
+
+    for (size_t i=0; i<contents_.size(); ++i) {
+      if (contents_[i] <= 0.) continue;
+
+      G4bool inside = true;
+      for (size_t d=0; d<centres_.size(); ++d) {
+        if (centres_[d][i] < windows_[d].first || centres_[d][i] > windows_[d].second)
+          inside = false;
+      }
+
+      if (inside) {
+        bins_.push_back(i);
+        total += contents_[i];
+      }
+    }
+
+    if (bins_.empty())
+      G4Exception("[HistogramSampler]", "BuildAliasTable()",
+                  FatalException, " no bin with positive content inside the sampling window");
+
+    // Vose's construction: each entry keeps its own bin with
+    // probability prob_ and takes its alias otherwise
+    size_t n = bins_.size();
+    prob_.assign(n, 1.);
+    alias_.resize(n);
+
+    std::vector<G4double> scaled(n);
+    std::vector<size_t> small, large;
+    for (size_t i=0; i<n; ++i) {
+      alias_[i]  = i;
+      scaled[i] = contents_[bins_[i]] * n / total;
+      if (scaled[i] < 1.) small.push_back(i);
+      else                large.push_back(i);
+    }
+
+    while (!small.empty() && !large.empty()) {
+      size_t s = small.back(); small.pop_back();
+      size_t l = large.back();
+
+      prob_[s]  = scaled[s];
+      alias_[s] = l;
+
+      scaled[l] -= 1. - scaled[s];
+      if (scaled[l] < 1.) {
+        large.pop_back();
+        small.push_back(l);
+      }
+    }
+
+    // What is left over is 1 up to rounding errors
+    for (size_t i: small) prob_[i] = 1.;
+    for (size_t i: large) prob_[i] = 1.;
+  }
+
+
+
+  size_t HistogramSampler::SampleBin() const
+  {
+    G4double u = G4UniformRand() * bins_.size();
+    size_t i = std::min(static_cast<size_t>(u), bins_.size() - 1);
+
+    if (u - i < prob_[i]) return bins_[i];
+    else                  return bins_[alias_[i]];
+  }
+
+
+
+  void HistogramSampler::Sample(std::vector<G4double>& values, Smearing smearing) const
+  {
+    size_t bin = SampleBin();
+
+    values.resize(centres_.size());
+    for (size_t d=0; d<centres_.size(); ++d) {
+      G4double centre = centres_[d][bin];
+      G4double width  = widths_[d][bin];
+
+      if (smearing == kUniform)
+        values[d] = centre + (G4UniformRand() - 0.5) * width;
+      else if (smearing == kGauss)
+        values[d] = centre + G4RandGauss::shoot(0., width);
+      else
+        values[d] = centre;
+    }
+  }
+
+
+
+  void HistogramSampler::GetRange(size_t dim, G4double& min, G4double& max) const
+  {
+    min =  std::numeric_limits<G4double>::infinity();
+    max = -std::numeric_limits<G4double>::infinity();
+
+    for (size_t i=0; i<contents_.size(); ++i) {
+      min = std::min(min, centres_[dim][i] - widths_[dim][i]/2.);
+      max = std::max(max, centres_[dim][i] + widths_[dim][i]/2.);
+    }
+  }
+
+
+  // -------
+
+  // Cache format (native binary):
+  // <key length> <key> <dimensions> <bins> <contents>
+  // <centres of dimension 1> ... <widths of dimension 1> ...
+  G4bool HistogramSampler::ReadCache(const std::string& filename, const std::string& key)
+  {
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open()) return false;
+
+    uint64_t key_size = 0;
+    in.read(reinterpret_cast<char*>(&key_size), sizeof(key_size));
+    if (!in.good() || key_size != key.size()) return false;
+
+    std::string stored(key_size, ' ');
+    in.read(&stored[0], key_size);
+    if (!in.good() || stored != key) return false;
+
+    uint64_t ndim = 0, nbins = 0;
+    in.read(reinterpret_cast<char*>(&ndim),  sizeof(ndim));
+    in.read(reinterpret_cast<char*>(&nbins), sizeof(nbins));
+    if (!in.good()) return false;
+
+    std::vector<G4double> contents(nbins);
+    std::vector<std::vector<G4double>> centres(ndim, std::vector<G4double>(nbins));
+    std::vector<std::vector<G4double>> widths (ndim, std::vector<G4double>(nbins));
+
+    auto read = [&in, nbins](std::vector<G4double>& v) {
+      in.read(reinterpret_cast<char*>(v.data()), nbins * sizeof(G4double));
+    };
+    read(contents);
+    for (auto& v: centres) read(v);
+    for (auto& v: widths)  read(v);
+    if (!in.good()) return false;
+
+    SetHistogram(contents, centres, widths);
+    return true;
+  }
+
+
+
+  void HistogramSampler::WriteCache(const std::string& filename, const std::string& key) const
+  {
+    std::ostringstream out;
+
+    uint64_t key_size = key.size();
+    uint64_t ndim     = centres_.size();
+    uint64_t nbins    = contents_.size();
+    out.write(reinterpret_cast<const char*>(&key_size), sizeof(key_size));
+    out.write(key.data(), key_size);
+    out.write(reinterpret_cast<const char*>(&ndim),  sizeof(ndim));
+    out.write(reinterpret_cast<const char*>(&nbins), sizeof(nbins));
+
+    auto write = [&out](const std::vector<G4double>& v) {
+      out.write(reinterpret_cast<const char*>(v.data()), v.size() * sizeof(G4double));
+    };
+    write(contents_);
+    for (auto& v: centres_) write(v);
+    for (auto& v: widths_)  write(v);
+
+    // Failing to write the cache is not an error
+    WriteFileAtomically(filename, out.str());
+  }
+
+
+} // end namespace nexus
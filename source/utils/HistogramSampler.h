@@ -0,0 +1,106 @@
+// ----------------------------------------------------------------------------
+// nexus | HistogramSampler.h
+//
+// Sampler of N-dimensional histograms given as lists of bins (content,
+// centre and width in each dimension), such as the muon flux tables.
+// Bins are selected in constant time with Walker's alias method; a
+// window in any dimension restricts the table to the bins whose centre
+// lies inside it, so that no sample is rejected. Histograms read from
+// CSV files are cached in a binary file next to them.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef HISTOGRAM_SAMPLER_H
+#define HISTOGRAM_SAMPLER_H
+
+#include <globals.hh>
+
+#include <utility>
+#include <vector>
+
+
+namespace nexus {
+
+  class HistogramSampler
+  {
+  public:
+    /// How the sampled values are spread around the bin centre
+    enum Smearing { kNone, kUniform, kGauss };
+
+    /// Constructor
+    HistogramSampler();
+    /// Destructor
+    ~HistogramSampler();
+
+    /// Read a histogram of the given dimension from a CSV file with lines
+    /// value,<content>,<centre 1>,...,<centre N>,<width 1>,...,<width N>
+    /// (other lines are ignored). The binary cache is used if it was
+    /// written from the same version of the file, and rewritten otherwise.
+    void LoadCSV(const std::string& filename, size_t ndim);
+
+    /// Set the histogram directly: contents, and centres and
+    /// widths of the bins in each dimension ([dimension][bin])
+    void SetHistogram(const std::vector<G4double>& contents,
+                      const std::vector<std::vector<G4double>>& centres,
+                      const std::vector<std::vector<G4double>>& widths);
+
+    /// Restrict the sampling to the bins whose centre in
+    /// the given dimension lies in [min, max]
+    void SetWindow(size_t dim, G4double min, G4double max);
+
+    /// Index of a bin drawn according to the contents
+    size_t SampleBin() const;
+
+    /// Draw a bin and fill the values in each dimension, smeared
+    /// uniformly within the bin or with a Gaussian of sigma equal
+    /// to the bin width
+    void Sample(std::vector<G4double>& values, Smearing smearing=kUniform) const;
+
+    /// Lowest and highest bin edges in a dimension
+    void GetRange(size_t dim, G4double& min, G4double& max) const;
+
+    size_t GetDimension() const;
+    size_t GetNumberOfBins() const;
+    G4double GetBinContent(size_t bin) const;
+    G4double GetBinCentre(size_t bin, size_t dim) const;
+    G4double GetBinWidth(size_t bin, size_t dim) const;
+
+  private:
+    /// Build the alias table over the bins inside the windows
+    void BuildAliasTable();
+
+    G4bool ReadCache(const std::string& filename, const std::string& key);
+    void WriteCache(const std::string& filename, const std::string& key) const;
+
+  private:
+    std::vector<G4double> contents_;
+    std::vector<std::vector<G4double>> centres_; ///< [dimension][bin]
+    std::vector<std::vector<G4double>> widths_;  ///< [dimension][bin]
+    std::vector<std::pair<G4double, G4double>> windows_; ///< [dimension]
+
+    std::vector<size_t> bins_;     ///< Bins allowed by the windows
+    std::vector<G4double> prob_;   ///< Probability of keeping each entry
+    std::vector<size_t> alias_;    ///< Alias of each entry (index in bins_)
+  };
+
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline size_t HistogramSampler::GetDimension() const
+  { return centres_.size(); }
+
+  inline size_t HistogramSampler::GetNumberOfBins() const
+  { return contents_.size(); }
+
+  inline G4double HistogramSampler::GetBinContent(size_t bin) const
+  { return contents_[bin]; }
+
+  inline G4double HistogramSampler::GetBinCentre(size_t bin, size_t dim) const
+  { return centres_[dim][bin]; }
+
+  inline G4double HistogramSampler::GetBinWidth(size_t bin, size_t dim) const
+  { return widths_[dim][bin]; }
+
+} // end namespace nexus
+
+#endif
@@ -6,6 +6,42 @@
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
 #include "IOUtils.h"
+#include "HistogramSampler.h"
+
+#include <G4PhysicsTable.hh>
+#include <G4PhysicsOrderedFreeVector.hh>
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <filesystem>
+#include <cstdlib>
+#include <cstdio>
+
+#include <unistd.h>
+#include <sys/stat.h>
+
+namespace {
+
+  // Append the bins of a histogram read with HistogramSampler to the
+  // vectors of the deprecated loaders ([dimension] for centres and widths)
+  void AppendHistData(const std::string& filename, std::vector<G4double>& value,
+                      const std::vector<std::vector<G4double>*>& centres,
+                      const std::vector<std::vector<G4double>*>& widths)
+  {
+    nexus::HistogramSampler sampler;
+    sampler.LoadCSV(filename, centres.size());
+
+    for (size_t bin=0; bin<sampler.GetNumberOfBins(); ++bin) {
+      value.push_back(sampler.GetBinContent(bin));
+      for (size_t dim=0; dim<centres.size(); ++dim) {
+        centres[dim]->push_back(sampler.GetBinCentre(bin, dim));
+        widths[dim]->push_back(sampler.GetBinWidth(bin, dim));
+      }
+    }
+  }
+
+}
 
 namespace nexus {
 
@@ -14,142 +50,33 @@ namespace nexus {
   // Input file format:
   // value,<intensity in bin>,<histogram x bin i centre>,<histogram x bin i width>
   void LoadHistData1D(std::string filename, std::vector<G4double> &value,
-                                    std::vector<G4double> &x, std::vector<G4double> &x_smear){
-    
-    // Open the file
-    std::ifstream FileIn_(filename);
-
-    // Check if file has opened properly
-    if (!FileIn_.is_open()){
-      G4Exception("[RandomUtils]", "LoadHistData1D()",
-                FatalException, " could not read in the CSV file ");
-    }
-
-    // Read the Data from the file as strings
-    std::string s_header, s_value, s_x;
-    std::string s_x_smear;
-
-    // Loop over the lines in the file and add the values to a vector
-    while (FileIn_.peek()!=EOF) {
-
-      std::getline(FileIn_, s_header, ',');
-
-      if (s_header == "value"){
-
-        std::getline(FileIn_, s_value, ',');
-        std::getline(FileIn_, s_x, ',');
-        std::getline(FileIn_, s_x_smear, '\n');
-
-        value.push_back(stod(s_value));
-        x.push_back(stod(s_x));
-        x_smear.push_back(stod(s_x_smear));
-      }
-
-    } // END While
-
-    FileIn_.close();
-  
-  } // END LoadHistData1D
+                      std::vector<G4double> &x, std::vector<G4double> &x_smear)
+  {
+    AppendHistData(filename, value, {&x}, {&x_smear});
+  }
 
   // --------
 
   // Input file format:
   // value,<intensity in bin>,<histogram x bin i centre>,<histogram y bin j centre>,<histogram x bin i width>,<histogram y bin j width>
   void LoadHistData2D(std::string filename, std::vector<G4double> &value,
-                                     std::vector<G4double> &x, std::vector<G4double> &y,
-                                     std::vector<G4double> &x_smear,
-                                     std::vector<G4double> &y_smear){
-    
-    // Open the file
-    std::ifstream FileIn_(filename);
-    
-    // Check if file has opened properly
-    if (!FileIn_.is_open()){
-      G4Exception("[RandomUtils]", "LoadHistData2D()",
-                FatalException, " could not read in the CSV file ");
-    }
-
-    // Read the Data from the file as strings
-    std::string s_header, s_value, s_x, s_y;
-    std::string s_x_smear, s_y_smear;
-
-    // Loop over the lines in the file and add the values to a vector
-    while (FileIn_.peek()!=EOF) {
-
-      std::getline(FileIn_, s_header, ',');
-      
-      if (s_header == "value"){
-
-        std::getline(FileIn_, s_value, ',');
-        std::getline(FileIn_, s_x, ',');
-        std::getline(FileIn_, s_y, ',');
-        std::getline(FileIn_, s_x_smear, ',');
-        std::getline(FileIn_, s_y_smear, '\n');
-
-        value.push_back(stod(s_value));
-        x.push_back(stod(s_x));
-        y.push_back(stod(s_y));
-        x_smear.push_back(stod(s_x_smear));
-        y_smear.push_back(stod(s_y_smear));
-
-      }
-    
-    } // END While
-
-    FileIn_.close();
-  
-  } // END LoadHistData2D
-  
+                      std::vector<G4double> &x, std::vector<G4double> &y,
+                      std::vector<G4double> &x_smear,
+                      std::vector<G4double> &y_smear)
+  {
+    AppendHistData(filename, value, {&x, &y}, {&x_smear, &y_smear});
+  }
 
   // --------
 
   // Input file format:
   // value,<intensity in bin>,<histogram x bin i centre>,<histogram y bin j centre>,<histogram z bin k centre>,<histogram x bin i width>,<histogram y bin j width>,<histogram z bin k width>
   void LoadHistData3D(std::string filename, std::vector<G4double> &value,
-                        std::vector<G4double> &x, std::vector<G4double> &y, std::vector<G4double> &z,
-                        std::vector<G4double> &x_smear, std::vector<G4double> &y_smear, std::vector<G4double> &z_smear){
-    
-    std::ifstream FileIn_(filename);
-
-    // Check if file has opened properly
-    if (!FileIn_.is_open()){
-      G4Exception("[RandomUtils]", "LoadHistData3D()",
-                FatalException, " could not read in the CSV file ");
-    }
-
-    // Read the Data from the file as strings
-    std::string s_header, s_value, s_x, s_y, s_z;
-    std::string s_x_smear, s_y_smear, s_z_smear;
-
-    // Loop over the lines in the file and add the values to a vector
-    while (FileIn_.peek()!=EOF) {
-
-      std::getline(FileIn_, s_header, ',');
-
-      if (s_header == "value"){
-      
-        std::getline(FileIn_, s_value, ',');
-        std::getline(FileIn_, s_x, ',');
-        std::getline(FileIn_, s_y, ',');
-        std::getline(FileIn_, s_z, ',');
-        std::getline(FileIn_, s_x_smear, ',');
-        std::getline(FileIn_, s_y_smear, ',');
-        std::getline(FileIn_, s_z_smear, '\n');
-
-        value.push_back(stod(s_value));
-        x.push_back(stod(s_x));
-        y.push_back(stod(s_y));
-        z.push_back(stod(s_z));
-        x_smear.push_back(stod(s_x_smear));
-        y_smear.push_back(stod(s_y_smear));
-        z_smear.push_back(stod(s_z_smear));
-      }
-
-    } // END While
-
-    FileIn_.close();
-  
-  }  // END LoadHistData3D
+                      std::vector<G4double> &x, std::vector<G4double> &y, std::vector<G4double> &z,
+                      std::vector<G4double> &x_smear, std::vector<G4double> &y_smear, std::vector<G4double> &z_smear)
+  {
+    AppendHistData(filename, value, {&x, &y, &z}, {&x_smear, &y_smear, &z_smear});
+  }
 
   // --------
 
@@ -218,5 +145,115 @@ namespace nexus {
 
   // -------
 
+  std::string HashString(const std::string& data)
+  {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c: data) {
+      hash ^= c;
+      hash *= 1099511628211ULL;
+    }
+
+    std::ostringstream hex;
+    hex << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return hex.str();
+  }
+
+
+  // -------
+
+
+  G4bool WriteFileAtomically(const std::string& filename, const std::string& data)
+  {
+    // mkstemp creates the file and guarantees that its name is unique,
+    // even among jobs started at the same time on a shared file system
+    std::string tmp = filename + ".XXXXXX";
+    int fd = mkstemp(tmp.data());
+    if (fd < 0) return false;
+
+    // mkstemp creates the file readable only by its owner
+    fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+
+    size_t written = 0;
+    while (written < data.size()) {
+      ssize_t n = write(fd, data.data() + written, data.size() - written);
+      if (n <= 0) break;
+      written += n;
+    }
+
+    G4bool ok = (close(fd) == 0) && (written == data.size());
+
+    std::error_code error;
+    if (ok) std::filesystem::rename(tmp, filename, error);
+    if (!ok || error) {
+      std::remove(tmp.c_str());
+      return false;
+    }
+    return true;
+  }
+
+
+  // -------
+
+  // File format:
+  // <number of vectors>
+  // <number of entries of vector i> <energy 0> <value 0> <energy 1> ...
+  G4bool StorePhysicsVectors(const G4PhysicsTable* table, const std::string& filename)
+  {
+    std::ofstream out(filename);
+    if (!out.is_open()) return false;
+
+    out << std::setprecision(17) << table->entries() << "\n";
+
+    for (size_t i=0; i<table->entries(); i++) {
+      const G4PhysicsVector* vec = (*table)(i);
+      size_t n = vec ? vec->GetVectorLength() : 0;
+      out << n;
+      for (size_t j=0; j<n; j++)
+        out << " " << vec->Energy(j) << " " << (*vec)[j];
+      out << "\n";
+    }
+
+    return out.good();
+  }
+
+
+  // -------
+
+
+  G4PhysicsTable* RetrievePhysicsVectors(const std::string& filename, size_t entries)
+  {
+    std::ifstream in(filename);
+    if (!in.is_open()) return nullptr;
+
+    size_t stored = 0;
+    in >> stored;
+    if (in.fail() || stored != entries) return nullptr;
+
+    G4PhysicsTable* table = new G4PhysicsTable(entries);
+
+    for (size_t i=0; i<entries; i++) {
+      size_t n = 0;
+      in >> n;
+      G4PhysicsOrderedFreeVector* vec = new G4PhysicsOrderedFreeVector();
+      for (size_t j=0; j<n && in.good(); j++) {
+        G4double energy, value;
+        in >> energy >> value;
+        vec->InsertValues(energy, value);
+      }
+      table->insertAt(i, vec);
+
+      if (in.fail()) {
+        table->clearAndDestroy();
+        delete table;
+        return nullptr;
+      }
+    }
+
+    return table;
+  }
+
+
+  // -------
+
 
 }
@@ -10,24 +10,34 @@
 
 #include <Randomize.hh>
 
+#include <vector>
+
+class G4PhysicsTable;
+
 
 #ifndef IOUTILS_H
 #define IOUTILS_H
 
 namespace nexus {
 
-    /// Read in the 1d histogram stored in a csv file
+    /// Read in the 1d histogram stored in a csv file.
+    /// Deprecated: use HistogramSampler::LoadCSV, which it wraps.
+    [[deprecated("use HistogramSampler::LoadCSV")]]
     void LoadHistData1D(std::string filename, std::vector<G4double> &value,
                         std::vector<G4double> &x,
                         std::vector<G4double> &x_smear);
-    
-    /// Read in the 2d histogram stored in a csv file
+
+    /// Read in the 2d histogram stored in a csv file.
+    /// Deprecated: use HistogramSampler::LoadCSV, which it wraps.
+    [[deprecated("use HistogramSampler::LoadCSV")]]
     void LoadHistData2D(std::string filename, std::vector<G4double> &value,
                         std::vector<G4double> &x, std::vector<G4double> &y,
                         std::vector<G4double> &x_smear,
                         std::vector<G4double> &y_smear);
-    
-    /// Read in the 3d histogram stored in a csv file
+
+    /// Read in the 3d histogram stored in a csv file.
+    /// Deprecated: use HistogramSampler::LoadCSV, which it wraps.
+    [[deprecated("use HistogramSampler::LoadCSV")]]
     void LoadHistData3D(std::string filename, std::vector<G4double> &value,
                         std::vector<G4double> &x, std::vector<G4double> &y, std::vector<G4double> &z,
                         std::vector<G4double> &x_smear, std::vector<G4double> &y_smear, std::vector<G4double> &z_smear);
@@ -35,8 +45,26 @@ namespace nexus {
 
     // Check if a loaded variable from a csv is in the desired range
     // Header name is the string in the file that identifies the bins you want to check. e.g. energy, azimuth, zenith
+    // Deprecated: use HistogramSampler::GetRange.
+    [[deprecated("use HistogramSampler::GetRange")]]
     void CheckVarBounds(std::string filename, G4double var_min, G4double var_max, std::string HeaderName);
 
+    /// 64-bit FNV-1a hash of a string, in hexadecimal form
+    std::string HashString(const std::string& data);
+
+    /// Replace the contents of a file with the given bytes. They are
+    /// written to a uniquely named temporary file in the same directory
+    /// and moved into place, so that concurrent jobs never read a
+    /// partial file. Returns false, leaving the file untouched, on failure.
+    G4bool WriteFileAtomically(const std::string& filename, const std::string& data);
+
+    /// Write the vectors of a physics table to a text file
+    G4bool StorePhysicsVectors(const G4PhysicsTable* table, const std::string& filename);
+
+    /// Read a table written by StorePhysicsVectors. Returns a null pointer
+    /// if the file is missing or does not hold the expected number of vectors.
+    G4PhysicsTable* RetrievePhysicsVectors(const std::string& filename, size_t entries);
+
 
 }
 
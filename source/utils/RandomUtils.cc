@@ -7,6 +7,8 @@
 // ----------------------------------------------------------------------------
 #include "RandomUtils.h"
 
+#include <algorithm>
+
 namespace nexus {
 
   G4double UniformRandomInRange(G4double max_value, G4double min_value)
@@ -34,9 +36,12 @@ namespace nexus {
                           cosTheta).unit();
   }
 
-  G4int GetRandBinIndex(G4RandGeneral *fRandomGeneral, std::vector<G4double> intensity){
+  G4int GetRandBinIndex(G4RandGeneral *fRandomGeneral, const std::vector<G4double>& intensity){
 
-    return round(fRandomGeneral->fire()*intensity.size());
+    // The continuous distribution is uniform within each bin, so the
+    // bin is the integer part (a draw of 1 belongs to the last bin)
+    G4int nbins = intensity.size();
+    return std::min(G4int(fRandomGeneral->fire()*nbins), nbins - 1);
 
   }
 
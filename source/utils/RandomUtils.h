@@ -10,6 +10,8 @@
 
 #include <Randomize.hh>
 
+#include <vector>
+
 
 #ifndef RAND_U_H
 #define RAND_U_H
@@ -21,8 +23,10 @@ namespace nexus {
     G4ThreeVector RandomDirectionInRange(G4double costheta_min, G4double costheta_max,
                                        G4double phi_min, G4double phi_max);
 
-    /// Get the random bin index of histogram distribution
-    G4int GetRandBinIndex(G4RandGeneral *fRandomGeneral, std::vector<G4double> value);
+    /// Get the random bin index of histogram distribution.
+    /// Deprecated: use HistogramSampler::SampleBin.
+    [[deprecated("use HistogramSampler::SampleBin")]]
+    G4int GetRandBinIndex(G4RandGeneral *fRandomGeneral, const std::vector<G4double>& value);
 
     /// Get the value of the random sample
     G4double Sample(G4double sample, G4bool smear, G4double smearval);
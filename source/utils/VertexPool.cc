@@ -0,0 +1,183 @@
+// ----------------------------------------------------------------------------
+// nexus | VertexPool.cc
+//
+// Pool of pre-sampled vertices, for regions of the geometry where each
+// vertex costs many rejected tries. The pool is sampled once and stored
+// in a binary cache file shared by all the jobs with the same geometry;
+// vertices are then drawn from it in random order, without repetition,
+// and the pool is sampled again when all of them have been used.
+// Note that all the jobs reading the same cache draw from the same
+// vertices, so their events are not independent: CheckSize tells
+// whether the pool is large enough for that to be negligible.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "VertexPool.h"
+#include "IOUtils.h"
+
+#include <Randomize.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+
+
+namespace nexus {
+
+
+  VertexPool::VertexPool(std::function<G4ThreeVector()> generate, size_t size):
+    generate_(generate), size_(size), remaining_(0), refills_(0)
+  {
+    if (size_ == 0)
+      G4Exception("[VertexPool]", "VertexPool()",
+                  FatalException, "The pool must hold at least one vertex.");
+  }
+
+
+
+  VertexPool::~VertexPool()
+  {
+  }
+
+
+
+  void VertexPool::Fill(const std::string& filename, const std::string& key)
+  {
+    if (filename != "" && ReadCache(filename, key)) return;
+
+    Sample();
+    if (filename != "") WriteCache(filename, key);
+  }
+
+
+
+  void VertexPool::Sample()
+  {
+    vertices_.resize(size_);
+    for (auto& vertex: vertices_) vertex = generate_();
+    remaining_ = size_;
+  }
+
+
+
+  G4ThreeVector VertexPool::Draw()
+  {
+    if (remaining_ == 0) {
+      if (!vertices_.empty()) ++refills_;
+      Sample();
+    }
+
+    // Partial Fisher-Yates shuffle: the vertex drawn is
+    // moved out of the range of the remaining ones
+    size_t i = G4RandFlat::shootInt(remaining_);
+    --remaining_;
+    std::swap(vertices_[i], vertices_[remaining_]);
+
+    return vertices_[remaining_];
+  }
+
+
+
+  G4double VertexPool::UncertaintyFactor(size_t events, size_t jobs) const
+  {
+    if (events == 0 || jobs <= 1) return 1.;
+
+    // Each job draws its first min(n, N) vertices from the pool of N without
+    // repetition, and the rest from new pools of its own. Vertex i is then
+    // drawn c_i times by the J jobs, and the variance of an average over the
+    // M = J n events is sigma^2 sum(c_i^2) / M^2. Its expectation over
+    // the vertices drawn by each job is sigma^2 / M times
+    //   1 + (J-1) min(n, N)^2 / (N n)
+    G4double n = events;
+    G4double N = size_;
+    G4double shared = std::min(n, N);
+    return std::sqrt(1. + (jobs - 1) * shared * shared / (N * n));
+  }
+
+
+
+  G4bool VertexPool::CheckSize(size_t events, size_t jobs, G4double tolerance) const
+  {
+    G4double factor = UncertaintyFactor(events, jobs);
+    if (factor <= 1. + tolerance) return true;
+
+    // Smallest pool within the tolerance, from the formula above
+    // with n <= N (which holds for such a pool if the tolerance
+    // is below 40%)
+    G4double excess = (1. + tolerance) * (1. + tolerance) - 1.;
+    size_t needed = std::ceil((jobs - 1) * events / excess);
+
+    G4String msg = "The " + std::to_string(jobs) + " jobs of " + std::to_string(events) +
+      " events sharing the pool of " + std::to_string(size_) + " vertices draw the same" +
+      " vertices: the statistical uncertainty of their combined events is " +
+      std::to_string(G4int(std::round(100. * (factor - 1.)))) +
+      "% larger than with independent vertices. Use a pool of at least " +
+      std::to_string(needed) + " vertices.";
+    G4Exception("[VertexPool]", "CheckSize()", JustWarning, msg);
+    return false;
+  }
+
+
+  // -------
+
+  // Cache format (native binary):
+  // <key length> <key> <vertices> <x y z of each vertex>
+  G4bool VertexPool::ReadCache(const std::string& filename, const std::string& key)
+  {
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open()) return false;
+
+    uint64_t key_size = 0;
+    in.read(reinterpret_cast<char*>(&key_size), sizeof(key_size));
+    if (!in.good() || key_size != key.size()) return false;
+
+    std::string stored(key_size, ' ');
+    in.read(&stored[0], key_size);
+    if (!in.good() || stored != key) return false;
+
+    uint64_t nvertices = 0;
+    in.read(reinterpret_cast<char*>(&nvertices), sizeof(nvertices));
+    if (!in.good() || nvertices != size_) return false;
+
+    std::vector<G4double> xyz(3 * nvertices);
+    in.read(reinterpret_cast<char*>(xyz.data()), xyz.size() * sizeof(G4double));
+    if (!in.good()) return false;
+
+    vertices_.resize(size_);
+    for (size_t i=0; i<size_; ++i)
+      vertices_[i].set(xyz[3*i], xyz[3*i+1], xyz[3*i+2]);
+    remaining_ = size_;
+
+    return true;
+  }
+
+
+
+  void VertexPool::WriteCache(const std::string& filename, const std::string& key) const
+  {
+    std::ostringstream out;
+
+    uint64_t key_size  = key.size();
+    uint64_t nvertices = vertices_.size();
+    out.write(reinterpret_cast<const char*>(&key_size), sizeof(key_size));
+    out.write(key.data(), key_size);
+    out.write(reinterpret_cast<const char*>(&nvertices), sizeof(nvertices));
+
+    std::vector<G4double> xyz;
+    xyz.reserve(3 * nvertices);
+    for (auto& vertex: vertices_) {
+      xyz.push_back(vertex.x());
+      xyz.push_back(vertex.y());
+      xyz.push_back(vertex.z());
+    }
+    out.write(reinterpret_cast<const char*>(xyz.data()), xyz.size() * sizeof(G4double));
+
+    // Failing to write the cache is not an error
+    WriteFileAtomically(filename, out.str());
+  }
+
+
+} // end namespace nexus
@@ -0,0 +1,90 @@
+// ----------------------------------------------------------------------------
+// nexus | VertexPool.h
+//
+// Pool of pre-sampled vertices, for regions of the geometry where each
+// vertex costs many rejected tries. The pool is sampled once and stored
+// in a binary cache file shared by all the jobs with the same geometry;
+// vertices are then drawn from it in random order, without repetition,
+// and the pool is sampled again when all of them have been used.
+// Note that all the jobs reading the same cache draw from the same
+// vertices, so their events are not independent: CheckSize tells
+// whether the pool is large enough for that to be negligible.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef VERTEX_POOL_H
+#define VERTEX_POOL_H
+
+#include <G4ThreeVector.hh>
+
+#include <functional>
+#include <vector>
+
+
+namespace nexus {
+
+  class VertexPool
+  {
+  public:
+    /// Constructor, with the function that samples one vertex
+    /// and the number of vertices of the pool
+    VertexPool(std::function<G4ThreeVector()> generate, size_t size);
+    /// Destructor
+    ~VertexPool();
+
+    /// Read the pool from the cache file if it was written with the
+    /// same key (e.g. a hash of the geometry and the region); otherwise
+    /// sample it and write the file. No cache is used if the name is empty.
+    void Fill(const std::string& filename, const std::string& key);
+
+    /// Next vertex, in random order. A new pool is sampled
+    /// (not read from the cache) once all the vertices were used.
+    G4ThreeVector Draw();
+
+    /// Factor by which the statistical uncertainty of any average over
+    /// the events of the given number of jobs, which share the pool,
+    /// exceeds that of the same events with independent vertices
+    G4double UncertaintyFactor(size_t events, size_t jobs) const;
+
+    /// Check that the vertices shared by the jobs increase the statistical
+    /// uncertainty of their combined events by no more than the tolerance,
+    /// warning otherwise. Returns false if the pool is too small.
+    G4bool CheckSize(size_t events, size_t jobs, G4double tolerance=0.05) const;
+
+    size_t GetSize() const;
+    /// Number of vertices not drawn yet from the current pool
+    size_t GetRemaining() const;
+    /// Number of times the pool was sampled again
+    size_t GetRefills() const;
+
+  private:
+    /// Sample all the vertices of the pool
+    void Sample();
+
+    G4bool ReadCache(const std::string& filename, const std::string& key);
+    void WriteCache(const std::string& filename, const std::string& key) const;
+
+  private:
+    std::function<G4ThreeVector()> generate_;
+    size_t size_;
+
+    std::vector<G4ThreeVector> vertices_;
+    size_t remaining_; ///< Vertices [0, remaining_) not drawn yet
+    size_t refills_;
+  };
+
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline size_t VertexPool::GetSize() const
+  { return size_; }
+
+  inline size_t VertexPool::GetRemaining() const
+  { return remaining_; }
+
+  inline size_t VertexPool::GetRefills() const
+  { return refills_; }
+
+} // end namespace nexus
+
+#endif
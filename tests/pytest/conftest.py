@@ -56,6 +56,16 @@ def nexus_full_output_file_demopp(output_tmpdir, full_base_name_demopp):
     return os.path.join(output_tmpdir, full_base_name_demopp + '.h5')
 
 
+@pytest.fixture(scope = 'session')
+def pruned_base_name_next100():
+    return 'NEXT100_pruned_electron'
+
+
+@pytest.fixture(scope = 'session')
+def nexus_pruned_output_file_next100(output_tmpdir, pruned_base_name_next100):
+    return os.path.join(output_tmpdir, pruned_base_name_next100 + '.h5')
+
+
 @pytest.fixture(scope = 'session')
 def new_detector(nexus_full_output_file_new):
     pmt_ids         = [i for i in range(12)]
@@ -44,6 +44,7 @@ def test_hdf5_structure(detectors):
             assert 'length'             in pcolumns
             assert 'creator_proc'       in pcolumns
             assert 'final_proc'         in pcolumns
+            assert 'weight'             in pcolumns
 
 
             hcolumns = h5out.root.MC.hits.colnames
@@ -57,6 +58,7 @@ def test_hdf5_structure(detectors):
             assert 'label'       in hcolumns
             assert 'particle_id' in hcolumns
             assert 'hit_id'      in hcolumns
+            assert 'weight'      in hcolumns
 
 
             scolumns = h5out.root.MC.sns_response.colnames
@@ -184,3 +186,59 @@ def test_sensor_names_are_the_same_across_tables(detectors):
             test(filename.format(run=run))
     else:
         test(filename)
+
+
+
+def test_primaries_match_primary_particles(nexus_full_output_file_next100):
+    """
+    Check that the saved primary vertices correspond
+    to the primary particles of the particle table.
+    """
+    filename = nexus_full_output_file_next100
+
+    primaries = pd.read_hdf(filename, 'MC/primaries')
+    particles = pd.read_hdf(filename, 'MC/particles')
+    particles = particles[particles.primary == 1]
+
+    assert len(primaries) == len(particles)
+    assert np.all(primaries.mother_id == 0)
+
+    primaries = primaries.sort_values(['event_id', 'particle_id'])
+    particles = particles.sort_values(['event_id', 'particle_id'])
+
+    assert np.all(primaries.particle_name.values == particles.particle_name.values)
+    assert np.allclose(primaries.x.values, particles.initial_x.values, rtol=1e-6)
+    assert np.allclose(primaries.y.values, particles.initial_y.values, rtol=1e-6)
+    assert np.allclose(primaries.z.values, particles.initial_z.values, rtol=1e-6)
+    assert np.allclose(primaries.px.values, particles.initial_momentum_x.values, rtol=1e-5)
+
+
+
+def test_pruned_trajectories_are_consistent(nexus_pruned_output_file_next100):
+    """
+    Check that, when the trajectories are pruned, the mothers of the
+    particles and the particles of the hits are stored, as well as
+    all the primary particles.
+    """
+    filename = nexus_pruned_output_file_next100
+
+    particles = pd.read_hdf(filename, 'MC/particles')
+    hits      = pd.read_hdf(filename, 'MC/hits')
+    primaries = pd.read_hdf(filename, 'MC/primaries')
+
+    stored = pd.MultiIndex.from_frame(particles[['event_id', 'particle_id']])
+
+    secondaries = particles[particles.primary == 0]
+    mothers     = pd.MultiIndex.from_frame(secondaries[['event_id', 'mother_id']])
+    assert np.all(mothers.isin(stored))
+    assert np.all(particles[particles.primary == 1].mother_id == 0)
+
+    # Every track with an energy deposit is kept
+    hit_ids = pd.MultiIndex.from_frame(hits[['event_id', 'particle_id']])
+    assert len(hits) > 0
+    assert np.all(hit_ids.isin(stored))
+
+    primary_ids = pd.MultiIndex.from_frame(primaries[['event_id', 'particle_id']])
+    assert np.all(primary_ids.isin(stored))
+    assert len(primaries) == np.count_nonzero(particles.primary == 1)
+
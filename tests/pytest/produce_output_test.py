@@ -55,6 +55,7 @@ def test_create_nexus_output_file_next100(config_tmpdir, output_tmpdir,
 /Generator/SingleParticle/region CENTER
 
 /nexus/persistency/outputFile {output_tmpdir}/{full_base_name_next100}
+/nexus/persistency/save_primaries true
 /nexus/random_seed 21051817
 """
     config_path = os.path.join(config_tmpdir, full_base_name_next100+'.config.mac')
@@ -306,3 +307,74 @@ def test_create_nexus_output_file_demopp(config_tmpdir, output_tmpdir, NEXUSDIR,
         p         = subprocess.run(command, check=True, env=my_env)
 
     return nexus_full_output_file_demopp
+
+
+
+@pytest.mark.order(5)
+def test_create_nexus_output_file_pruned_next100(config_tmpdir, output_tmpdir,
+                                                 NEXUSDIR,
+                                                 pruned_base_name_next100,
+                                                 nexus_pruned_output_file_next100):
+    # Init file
+    init_text = f"""
+/PhysicsList/RegisterPhysics G4EmStandardPhysics_option4
+/PhysicsList/RegisterPhysics G4DecayPhysics
+/PhysicsList/RegisterPhysics G4RadioactiveDecayPhysics
+/PhysicsList/RegisterPhysics NexusPhysics
+/PhysicsList/RegisterPhysics G4StepLimiterPhysics
+
+/nexus/RegisterGeometry Next100
+
+/nexus/RegisterGenerator SingleParticleGenerator
+
+/nexus/RegisterPersistencyManager PersistencyManager
+
+/nexus/RegisterTrackingAction DefaultTrackingAction
+/nexus/RegisterEventAction DefaultEventAction
+/nexus/RegisterRunAction DefaultRunAction
+
+/nexus/RegisterMacro {config_tmpdir}/{pruned_base_name_next100}.config.mac
+"""
+    init_path = os.path.join(config_tmpdir, pruned_base_name_next100+'.init.mac')
+    init_file = open(init_path,'w')
+    init_file.write(init_text)
+    init_file.close()
+
+    #Config file
+    config_text = f"""
+/run/verbose 1
+/event/verbose 0
+/tracking/verbose 0
+
+/process/em/verbose 0
+
+/Geometry/Next100/elfield false
+/Geometry/Next100/max_step_size 1. mm
+
+/Generator/SingleParticle/particle e-
+/Generator/SingleParticle/min_energy 2. MeV
+/Generator/SingleParticle/max_energy 2. MeV
+/Generator/SingleParticle/region CENTER
+
+/PhysicsList/Nexus/clustering          false
+/PhysicsList/Nexus/drift               false
+/PhysicsList/Nexus/electroluminescence false
+
+/Actions/DefaultTrackingAction/prune_trajectories true
+
+/nexus/persistency/outputFile {output_tmpdir}/{pruned_base_name_next100}
+/nexus/persistency/save_primaries true
+/nexus/random_seed 21051817
+"""
+    config_path = os.path.join(config_tmpdir, pruned_base_name_next100+'.config.mac')
+    config_file = open(config_path,'w')
+    config_file.write(config_text)
+    config_file.close()
+
+    # Running the simulation
+    my_env    = os.environ
+    nexus_exe = NEXUSDIR + '/bin/nexus'
+    command   = [nexus_exe, '-b', '-n', '2', init_path]
+    p         = subprocess.run(command, check=True, env=my_env)
+
+    return nexus_pruned_output_file_next100